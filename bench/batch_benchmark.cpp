@@ -0,0 +1,127 @@
+#include "BatchCartPendulum.h"
+#include "Cart.h"
+#include "SinglePendulum.h"
+#include "DoublePendulum.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Batch benchmark - scalar Cart/Pendulum objects vs. BatchCartPendulum
+ *
+ * Steps the same set of environments through both paths with identical
+ * inputs and reports environment-steps per second plus the largest state
+ * difference between the two (the vector lanes use polynomial sin/cos).
+ * The batched path runs once per SIMD level up to the dispatched one
+ * (SimdDispatch.h; cap it with PENDULUM_SIMD), each line naming the level
+ * and lane width it ran with.
+ */
+
+namespace
+{
+    const double DT = 1.0 / 144.0;
+
+    double inputFor(std::size_t env, int tick)
+    {
+        return 30.0 * std::sin(0.02 * tick + 0.37 * static_cast<double>(env));
+    }
+
+    double initialAngleFor(std::size_t env)
+    {
+        return 0.5 + 2.5 * static_cast<double>(env % 97) / 97.0;
+    }
+
+    void runComparison(int numLinks, std::size_t numEnvs, int ticks)
+    {
+        // Scalar path: one Cart and one Pendulum object per environment
+        std::vector<Cart> carts(numEnvs, Cart(1.0, 10.0));
+        std::vector<std::unique_ptr<Pendulum>> pendulums;
+        for (std::size_t env = 0; env < numEnvs; ++env) {
+            if (numLinks == 1) {
+                auto p = std::make_unique<SinglePendulum>(1.0, 1.0);
+                p->setAngle(initialAngleFor(env));
+                pendulums.push_back(std::move(p));
+            }
+            else {
+                auto p = std::make_unique<DoublePendulum>(1.0, 1.0, 1.0, 1.0);
+                p->setAngle(0, initialAngleFor(env));
+                p->setAngle(1, -initialAngleFor(env));
+                pendulums.push_back(std::move(p));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                double effective = carts[env].update(DT, inputFor(env, tick), 0.1, 9.81);
+                pendulums[env]->update(DT, effective);
+            }
+        }
+        double scalarSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double steps = static_cast<double>(numEnvs) * ticks;
+        std::cout << (numLinks == 1 ? "single" : "double") << " pendulum, "
+            << numEnvs << " envs x " << ticks << " ticks\n"
+            << "  " << std::left << std::setw(20) << "scalar" << std::right << ": " << std::setw(12) << std::fixed << std::setprecision(0)
+            << steps / scalarSeconds << " steps/s\n" << std::defaultfloat;
+
+        // Batched path at every level up to the dispatched one
+        const SimdLevel dispatched = getSimdLevel();
+        for (int level = 0; level <= static_cast<int>(dispatched); ++level) {
+            setSimdLevel(static_cast<SimdLevel>(level));
+
+            BatchCartPendulum batch(numEnvs, numLinks);
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                batch.setAngle(env, 0, initialAngleFor(env));
+                if (numLinks == 2) batch.setAngle(env, 1, -initialAngleFor(env));
+            }
+            std::vector<double> inputs(numEnvs);
+
+            start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; ++tick) {
+                for (std::size_t env = 0; env < numEnvs; ++env) {
+                    inputs[env] = inputFor(env, tick);
+                }
+                batch.update(DT, inputs.data());
+            }
+            double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            double maxDiff = 0.0;
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                maxDiff = std::max(maxDiff, std::abs(carts[env].getPosition() - batch.getCartPosition(env)));
+                for (int link = 0; link < numLinks; ++link) {
+                    double d = std::abs(pendulums[env]->getAngle(link) - batch.getAngle(env, link));
+                    maxDiff = std::max(maxDiff, std::min(d, 2.0 * 3.14159265358979323846 - d));
+                }
+            }
+
+            const std::string label = std::string("batched ") + getSimdLevelName(getSimdLevel())
+                + " x" + std::to_string(BatchCartPendulum::getLaneWidth());
+            std::cout << "  " << std::left << std::setw(20) << label << std::right << ": "
+                << std::setw(12) << std::fixed << std::setprecision(0) << steps / batchSeconds << " steps/s ("
+                << std::setprecision(2) << scalarSeconds / batchSeconds << "x), max |state diff| "
+                << std::scientific << maxDiff << std::defaultfloat << "\n";
+        }
+        setSimdLevel(dispatched);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t numEnvs = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 1024;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::cout << "SIMD level: " << getSimdLevelName(getSimdLevel()) << ", "
+        << BatchCartPendulum::getLaneWidth() << " double lanes (CPU supports "
+        << getSimdLevelName(getSupportedSimdLevel()) << ")\n";
+    runComparison(1, numEnvs, ticks);
+    runComparison(2, numEnvs, ticks);
+    return 0;
+}
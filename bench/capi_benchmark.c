@@ -0,0 +1,92 @@
+#include "pendulum_env.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * C API benchmark - stepping through libpendulum_env from plain C
+ *
+ * Drives the shared library the way an FFI caller does (opaque handle,
+ * caller-owned arrays) with double and float buffers, and reports
+ * environment steps per second and an observation checksum per buffer
+ * type. The float checksum tracks the double one to float precision,
+ * since the dynamics always run in double.
+ */
+
+static double now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+static void run(int num_links, size_t num_envs, int use_float, int batch_steps)
+{
+    pendulum_env_config config;
+    pendulum_env_default_config(&config);
+    config.num_links = num_links;
+    config.substeps = 1;
+
+    pendulum_env* env = pendulum_env_create(num_envs, &config, sizeof(config), 1);
+    if (!env) {
+        fprintf(stderr, "ERROR: pendulum_env_create failed\n");
+        return;
+    }
+    const size_t obs_size = (size_t)pendulum_env_observation_size(env);
+    const size_t elem = use_float ? sizeof(float) : sizeof(double);
+
+    void* observations = malloc(num_envs * obs_size * elem);
+    void* actions = malloc(num_envs * elem);
+    void* rewards = malloc(num_envs * elem);
+    uint8_t* terminated = malloc(num_envs);
+    uint8_t* truncated = malloc(num_envs);
+
+    if (use_float) pendulum_env_reset_f32(env, 7, (float*)observations);
+    else pendulum_env_reset(env, 7, (double*)observations);
+
+    double start = now();
+    for (int step = 0; step < batch_steps; ++step) {
+        for (size_t i = 0; i < num_envs; ++i) {
+            double action = sin(0.05 * step + 0.1 * (double)i);
+            if (use_float) ((float*)actions)[i] = (float)action;
+            else ((double*)actions)[i] = action;
+        }
+        if (use_float) {
+            pendulum_env_step_f32(env, (const float*)actions, (float*)observations, (float*)rewards,
+                terminated, truncated, NULL);
+        }
+        else {
+            pendulum_env_step(env, (const double*)actions, (double*)observations, (double*)rewards,
+                terminated, truncated, NULL);
+        }
+    }
+    double seconds = now() - start;
+
+    double checksum = 0.0;
+    for (size_t i = 0; i < num_envs * obs_size; ++i) {
+        checksum += use_float ? (double)((float*)observations)[i] : ((double*)observations)[i];
+    }
+    printf("%6d%8zu%8s%14.0f%22.9f\n", num_links, num_envs, use_float ? "f32" : "f64",
+        (double)num_envs * batch_steps / seconds, checksum);
+
+    free(observations);
+    free(actions);
+    free(rewards);
+    free(terminated);
+    free(truncated);
+    pendulum_env_destroy(env);
+}
+
+int main(void)
+{
+    printf("pendulum_env ABI version %d\n", pendulum_env_abi_version());
+    printf("%6s%8s%8s%14s%22s\n", "links", "envs", "buffer", "env-steps/s", "obs checksum");
+    for (int num_links = 1; num_links <= 2; ++num_links) {
+        for (int use_float = 0; use_float <= 1; ++use_float) {
+            run(num_links, 1024, use_float, 200);
+        }
+    }
+    return 0;
+}
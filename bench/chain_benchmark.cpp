@@ -0,0 +1,139 @@
+#include "ChainPendulum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * Chain benchmark - articulated-body forward dynamics vs. a dense mass matrix
+ *
+ * For chains of increasing length, times ChainPendulum::computeDerivative
+ * (O(N)) against forming the N x N mass matrix and solving it by Gaussian
+ * elimination (O(N^3)), checks that both give the same accelerations, and
+ * times a full update() with the default integrator.
+ */
+
+namespace
+{
+    // Dense reference: M(theta) * alpha = f(theta, omega) in absolute angles
+    void denseAccelerations(const ChainPendulum& chain, const std::vector<double>& state,
+        double cartAccel, std::vector<double>& alpha)
+    {
+        const int n = chain.getNumAngles();
+        const double g = chain.getGravity();
+        const double damping = chain.getDamping();
+
+        // outerMass[i]: mass at or beyond link i
+        std::vector<double> outerMass(n);
+        double outer = 0.0;
+        for (int i = n - 1; i >= 0; --i) {
+            outer += chain.getLinkMass(i);
+            outerMass[i] = outer;
+        }
+
+        std::vector<double> M(n * n);
+        std::vector<double> f(n);
+        for (int i = 0; i < n; ++i) {
+            double Li = chain.getLinkLength(i);
+            double ti = state[2 * i];
+            f[i] = -outerMass[i] * Li * (g * std::sin(ti) + cartAccel * std::cos(ti))
+                - damping * Li * state[2 * i + 1];
+            for (int j = 0; j < n; ++j) {
+                double tj = state[2 * j];
+                double wj = state[2 * j + 1];
+                double mu = outerMass[std::max(i, j)] * Li * chain.getLinkLength(j);
+                M[i * n + j] = mu * std::cos(ti - tj);
+                f[i] -= mu * std::sin(ti - tj) * wj * wj;
+            }
+        }
+
+        // Gaussian elimination (M is symmetric positive definite, no pivoting)
+        for (int k = 0; k < n; ++k) {
+            for (int i = k + 1; i < n; ++i) {
+                double factor = M[i * n + k] / M[k * n + k];
+                for (int j = k; j < n; ++j) {
+                    M[i * n + j] -= factor * M[k * n + j];
+                }
+                f[i] -= factor * f[k];
+            }
+        }
+        alpha.assign(n, 0.0);
+        for (int i = n - 1; i >= 0; --i) {
+            double sum = f[i];
+            for (int j = i + 1; j < n; ++j) {
+                sum -= M[i * n + j] * alpha[j];
+            }
+            alpha[i] = sum / M[i * n + i];
+        }
+    }
+
+    template <typename Func>
+    double nanosecondsPerCall(int calls, Func func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            func(i);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int maxLinks = argc > 1 ? std::atoi(argv[1]) : 50;
+    const double DT = 1.0 / 144.0;
+    const int linkCounts[] = { 1, 2, 3, 4, 5, 10, 20, 30, 40, 50, 100, 200 };
+
+    std::cout << std::setw(6) << "links"
+        << std::setw(14) << "ABA ns/eval" << std::setw(14) << "ns/eval/link"
+        << std::setw(16) << "dense ns/eval" << std::setw(14) << "max |diff|"
+        << std::setw(16) << "update ns" << "\n";
+
+    for (int n : linkCounts) {
+        if (n > maxLinks) break;
+
+        ChainPendulum chain(n, 1.0, 1.0 / n);
+        std::vector<double> state(2 * n);
+        std::vector<double> dstate(2 * n);
+        std::vector<double> alpha;
+        for (int i = 0; i < n; ++i) {
+            state[2 * i] = 0.3 + 2.0 * std::sin(1.7 * i);
+            state[2 * i + 1] = std::cos(0.9 * i);
+            chain.setLinkState(i, state[2 * i], state[2 * i + 1]);
+        }
+
+        // Correctness against the dense solve
+        chain.computeDerivative(state.data(), 2.0, dstate.data());
+        denseAccelerations(chain, state, 2.0, alpha);
+        double maxDiff = 0.0;
+        for (int i = 0; i < n; ++i) {
+            maxDiff = std::max(maxDiff, std::abs(dstate[2 * i + 1] - alpha[i]) / (1.0 + std::abs(alpha[i])));
+        }
+
+        // Keep the total work per row roughly constant
+        int calls = std::max(200, 400000 / (n * std::max(1, n / 4)));
+        double abaNs = nanosecondsPerCall(calls, [&](int i) {
+            chain.computeDerivative(state.data(), 0.001 * (i & 7), dstate.data());
+            });
+        int denseCalls = std::max(20, calls / std::max(1, n * n / 16));
+        double denseNs = nanosecondsPerCall(denseCalls, [&](int i) {
+            denseAccelerations(chain, state, 0.001 * (i & 7), alpha);
+            });
+        int updates = std::max(20, calls / 13);
+        double updateNs = nanosecondsPerCall(updates, [&](int i) {
+            chain.update(DT, 0.0);
+            });
+
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(1)
+            << std::setw(14) << abaNs << std::setw(14) << abaNs / n
+            << std::setw(16) << denseNs
+            << std::setw(14) << std::scientific << std::setprecision(2) << maxDiff
+            << std::setw(16) << std::fixed << std::setprecision(0) << updateNs
+            << std::defaultfloat << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "Cart.h"
+#include "ChainPendulum.h"
+#include "DoublePendulum.h"
+#include "SinglePendulum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Concurrency stress test - independent carts and pendulums stepped on
+ * many threads must end bit-identical to a serial run
+ *
+ * A mix of carts with single, double and chain pendulums, each with its own
+ * integrator (cart and pendulum chosen independently), is stepped serially
+ * and then again with the instances dealt round-robin to
+ * hardware_concurrency() threads (at least 2), all threads stepping tick by
+ * tick side by side. Any state shared between instances (e.g. an integrator
+ * workspace) shows up as a difference in the final cart and pendulum states,
+ * which are compared with memcmp. Exits 1 on any mismatch. Meant to be run
+ * under -fsanitize=thread as well.
+ */
+
+namespace
+{
+    const int NUM_INSTANCES = 64;
+    const int NUM_TICKS = 2000;
+    const double DT = 1.0 / 144.0;
+
+    struct Instance
+    {
+        Cart cart{ 1.0, 10.0 };
+        std::unique_ptr<Pendulum> pendulum;
+        double push = 0.0;
+
+        explicit Instance(int index)
+        {
+            switch (index % 4) {
+            case 0: pendulum = std::make_unique<SinglePendulum>(1.0, 1.0); break;
+            case 1: pendulum = std::make_unique<DoublePendulum>(1.0, 1.0, 1.0, 1.0); break;
+            case 2: pendulum = std::make_unique<ChainPendulum>(3, 1.0, 0.5); break;
+            default: pendulum = std::make_unique<ChainPendulum>(5, 0.5, 0.4); break;
+            }
+            cart.setIntegrator(static_cast<IntegratorType>(index % INTEGRATOR_TYPE_COUNT));
+            pendulum->setIntegrator(static_cast<IntegratorType>((index / 4) % INTEGRATOR_TYPE_COUNT));
+            for (int link = 0; link < pendulum->getNumAngles(); ++link) {
+                pendulum->setLinkState(link, 0.3 + 0.01 * index + 0.2 * link, 0.0);
+            }
+            push = 2.0 + 0.1 * index;
+        }
+
+        void tick(int tick)
+        {
+            const double applied = push * std::sin(0.02 * tick);
+            pendulum->update(DT, cart.update(DT, applied, 0.1, 9.81));
+        }
+
+        std::vector<double> getFinalState() const
+        {
+            std::vector<double> state(2 + 2 * pendulum->getNumAngles());
+            state[0] = cart.getPosition();
+            state[1] = cart.getVelocity();
+            pendulum->getState(state.data() + 2);
+            return state;
+        }
+    };
+
+    std::vector<std::unique_ptr<Instance>> makeInstances()
+    {
+        std::vector<std::unique_ptr<Instance>> instances;
+        for (int i = 0; i < NUM_INSTANCES; ++i) instances.push_back(std::make_unique<Instance>(i));
+        return instances;
+    }
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto serial = makeInstances();
+    auto start = Clock::now();
+    for (int tick = 0; tick < NUM_TICKS; ++tick) {
+        for (auto& instance : serial) instance->tick(tick);
+    }
+    const double serialSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const int numThreads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    auto parallel = makeInstances();
+    std::vector<std::thread> threads;
+    start = Clock::now();
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&parallel, t, numThreads]() {
+            for (int tick = 0; tick < NUM_TICKS; ++tick) {
+                for (int i = t; i < NUM_INSTANCES; i += numThreads) parallel[i]->tick(tick);
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    const double parallelSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    int mismatches = 0;
+    for (int i = 0; i < NUM_INSTANCES; ++i) {
+        const std::vector<double> expected = serial[i]->getFinalState();
+        const std::vector<double> actual = parallel[i]->getFinalState();
+        if (std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(double)) != 0) {
+            std::cerr << "MISMATCH: instance " << i << " (" << serial[i]->pendulum->getNumAngles() << " links, cart "
+                << getIntegratorName(serial[i]->cart.getIntegrator()) << ", pendulum "
+                << getIntegratorName(serial[i]->pendulum->getIntegrator()) << ")" << std::endl;
+            ++mismatches;
+        }
+    }
+
+    std::cout << NUM_INSTANCES << " instances x " << NUM_TICKS << " ticks on " << numThreads << " threads: "
+        << serialSeconds * 1000.0 << " ms serial, " << parallelSeconds * 1000.0 << " ms threaded, "
+        << mismatches << " mismatch(es)\n";
+    return mismatches ? 1 : 0;
+}
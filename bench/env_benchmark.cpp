@@ -0,0 +1,88 @@
+#include "PendulumEnv.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+/**
+ * Env benchmark - PendulumEnv step throughput and per-step allocations
+ *
+ * Drives environments with a fixed open-loop action sequence, resetting on
+ * termination / truncation, and counts global operator new calls made
+ * while stepping (expected: zero).
+ */
+
+namespace
+{
+    std::atomic<long long> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    void run(int numLinks, int substeps, bool coupled)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = numLinks;
+        config.substeps = substeps;
+        config.coupled = coupled;
+        PendulumEnv env(config);
+
+        // Warm-up step sizes any lazily allocated integrator workspace
+        env.reset(1);
+        env.step(0.0);
+
+        const int steps = 20000;
+        long long allocationsBefore = g_allocations.load();
+        int episodes = 1;
+        double totalReward = 0.0;
+        env.reset(1);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) {
+            double action = std::sin(0.05 * i) + 0.3 * std::sin(0.31 * i);
+            PendulumEnv::StepResult result = env.step(action);
+            totalReward += result.reward;
+            if (result.terminated || result.truncated) {
+                env.reset(static_cast<std::uint64_t>(++episodes));
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long allocations = g_allocations.load() - allocationsBefore;
+
+        std::cout << std::setw(6) << numLinks << std::setw(10) << substeps
+            << std::setw(9) << (coupled ? "yes" : "no")
+            << std::setw(14) << std::fixed << std::setprecision(0) << steps / seconds
+            << std::setw(14) << steps * substeps / seconds
+            << std::setw(10) << episodes
+            << std::setw(12) << std::setprecision(3) << totalReward / steps
+            << std::setw(10) << allocations << "\n";
+    }
+}
+
+int main()
+{
+    std::cout << std::setw(6) << "links" << std::setw(10) << "substeps" << std::setw(9) << "coupled"
+        << std::setw(14) << "steps/s" << std::setw(14) << "ticks/s"
+        << std::setw(10) << "episodes" << std::setw(12) << "reward/step"
+        << std::setw(10) << "allocs" << "\n";
+    for (int numLinks = 1; numLinks <= 3; ++numLinks) {
+        for (int substeps : { 1, 4 }) {
+            run(numLinks, substeps, false);
+        }
+        if (numLinks <= 2) run(numLinks, 4, true);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "SinglePendulum.h"
+#include "DoublePendulum.h"
+#include "Integrators.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+/**
+ * Integrator benchmark - energy drift vs. cost for every IntegratorType
+ *
+ * Releases an undamped pendulum on a stationary cart from a large angle,
+ * integrates it for a fixed simulated time at several frame rates, and
+ * reports the largest relative deviation of the total energy from its
+ * initial value next to the wall-clock cost of one update.
+ */
+
+namespace
+{
+    std::unique_ptr<Pendulum> makePendulum(int numLinks)
+    {
+        if (numLinks == 1) {
+            auto p = std::make_unique<SinglePendulum>(1.0, 1.0);
+            p->setAngle(2.5);
+            return p;
+        }
+        auto p = std::make_unique<DoublePendulum>(1.0, 1.0, 1.0, 1.0);
+        p->setAngle(0, 2.0);
+        p->setAngle(1, -1.0);
+        return p;
+    }
+
+    void runIntegrator(int numLinks, IntegratorType type, double dt, double duration)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(numLinks);
+        pendulum->setDamping(0.0);
+        pendulum->setIntegrator(type);
+
+        const double e0 = pendulum->getTotalEnergy(0.0);
+        const int steps = static_cast<int>(duration / dt);
+        double maxDrift = 0.0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) {
+            pendulum->update(dt, 0.0);
+            double drift = std::abs(pendulum->getTotalEnergy(0.0) - e0) / e0;
+            maxDrift = std::max(maxDrift, drift);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  " << std::left << std::setw(22) << getIntegratorName(type) << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1) << seconds * 1e9 / steps << " ns/step"
+            << "   max |dE/E0| " << std::scientific << std::setprecision(2) << maxDrift
+            << std::defaultfloat << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double duration = argc > 1 ? std::atof(argv[1]) : 60.0;
+    const double frameRates[] = { 144.0, 60.0, 30.0 };
+
+    for (int numLinks = 1; numLinks <= 2; ++numLinks) {
+        for (double rate : frameRates) {
+            std::cout << (numLinks == 1 ? "single" : "double") << " pendulum, dt = 1/"
+                << rate << " s, " << duration << " s simulated\n";
+            for (int i = 0; i < INTEGRATOR_TYPE_COUNT; ++i) {
+                runIntegrator(numLinks, static_cast<IntegratorType>(i), 1.0 / rate, duration);
+            }
+        }
+    }
+    return 0;
+}
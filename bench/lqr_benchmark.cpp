@@ -0,0 +1,173 @@
+#include "DoublePendulum.h"
+#include "LqrController.h"
+#include "PendulumEnv.h"
+#include "Random.h"
+#include "SinglePendulum.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * LQR benchmark - Riccati solve cost, cached control cost and catch rate
+ *
+ * Per link count: the time of one uncached gain solve per integrator, the
+ * per-tick cost of the controller as the viewer uses it (setModel with
+ * unchanged parameters plus act) against re-solving every tick, the cache
+ * traffic of a parameter slider dragged back and forth, and the fraction
+ * of random near-upright starts that are balanced after 10 s over a grid
+ * of masses, lengths and gravity (acceleration limited to 30 m/s^2).
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    const double DT = 1.0 / 144.0;
+    const double PI = 3.14159265358979323846;
+    const double FRICTION = 0.1;
+
+    double seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::unique_ptr<Pendulum> makePendulum(int links, double mass, double length)
+    {
+        if (links == 1) return std::make_unique<SinglePendulum>(mass, length);
+        return std::make_unique<DoublePendulum>(mass, length, mass, length);
+    }
+
+    void measureSolve(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links, 1.0, 1.0);
+        for (int type = 0; type < INTEGRATOR_TYPE_COUNT; ++type) {
+            pendulum->setIntegrator(static_cast<IntegratorType>(type));
+            const int solves = 2000;
+            LqrController::Gains gains;
+            auto start = Clock::now();
+            for (int i = 0; i < solves; ++i) gains = LqrController::solve(*pendulum, DT, FRICTION, LqrWeights());
+            std::cout << std::setw(6) << links << std::setw(24) << getIntegratorName(static_cast<IntegratorType>(type))
+                << std::fixed << std::setprecision(2) << std::setw(12) << seconds(start) / solves * 1e6
+                << std::setw(12) << gains.iterations << std::setw(13) << (gains.stabilizing ? "yes" : "NO") << "\n";
+        }
+    }
+
+    void measureTickCost(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links, 1.0, 1.0);
+        Cart cart(1.0, 10.0);
+        double observation[6];
+        LqrController lqr;
+        const int ticks = 1000000;
+        volatile double sink = 0.0;
+        auto start = Clock::now();
+        for (int tick = 0; tick < ticks; ++tick) {
+            cart.setPosition(1e-6 * (tick & 1023));
+            PendulumEnv::writeObservation(cart, *pendulum, observation);
+            lqr.setModel(*pendulum, DT, FRICTION);
+            sink = sink + lqr.act(observation, 2 + 2 * links);
+        }
+        const double cachedNs = seconds(start) / ticks * 1e9;
+
+        const int resolves = 2000;
+        start = Clock::now();
+        for (int tick = 0; tick < resolves; ++tick) {
+            PendulumEnv::writeObservation(cart, *pendulum, observation);
+            LqrController::Gains gains = LqrController::solve(*pendulum, DT, FRICTION, LqrWeights());
+            sink = sink + gains.k[0] * observation[0];
+        }
+        const double resolveNs = seconds(start) / resolves * 1e9;
+
+        std::cout << std::setw(6) << links << std::setw(14) << std::setprecision(1) << cachedNs
+            << std::setw(16) << std::setprecision(0) << resolveNs << std::setw(12) << lqr.getSolveCount() << "\n";
+    }
+
+    void measureSliderDrag(int links)
+    {
+        // 100 distinct lengths, dragged back and forth 10 times, 5 ticks per value
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links, 1.0, 1.0);
+        LqrController lqr;
+        long long ticks = 0;
+        auto start = Clock::now();
+        for (int pass = 0; pass < 10; ++pass) {
+            for (int i = 0; i < 100; ++i) {
+                const int value = pass % 2 == 0 ? i : 99 - i;
+                const double length = 0.5 + 0.01 * value;
+                if (links == 1) static_cast<SinglePendulum&>(*pendulum).setLength(length);
+                else static_cast<DoublePendulum&>(*pendulum).setLength(0, length);
+                for (int tick = 0; tick < 5; ++tick, ++ticks) lqr.setModel(*pendulum, DT, FRICTION);
+            }
+        }
+        std::cout << "  " << links << " link(s): " << ticks << " ticks, " << lqr.getSolveCount() << " solves, "
+            << lqr.getCacheSize() << " cached, " << std::setprecision(2) << seconds(start) * 1e3 << " ms\n";
+    }
+
+    bool balances(int links, double mass, double length, double gravity, std::uint64_t& rng)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links, mass, length);
+        pendulum->setGravity(gravity);
+        pendulum->setDamping(FRICTION);
+        Cart cart(1.0, 10.0);
+        LqrController lqr;
+        if (!lqr.setModel(*pendulum, DT, FRICTION)) return false;
+
+        const double spread = links == 1 ? 0.3 : 0.08;
+        double state[4];
+        for (int link = 0; link < links; ++link) {
+            state[2 * link] = PI + spread * (2.0 * uniformUnit(splitMix64(rng)) - 1.0);
+            state[2 * link + 1] = 0.0;
+        }
+        pendulum->setState(state);
+
+        double observation[6];
+        for (int tick = 0; tick < 1440; ++tick) {
+            PendulumEnv::writeObservation(cart, *pendulum, observation);
+            double a = std::clamp(lqr.act(observation, 2 + 2 * links), -30.0, 30.0);
+            pendulum->update(DT, cart.update(DT, a, FRICTION, gravity));
+        }
+        PendulumEnv::writeObservation(cart, *pendulum, observation);
+        return LqrController::uprightError(observation, 2 + 2 * links) < 1e-3 && std::abs(cart.getPosition()) < 0.05;
+    }
+
+    void measureCatchRate(int links)
+    {
+        std::uint64_t rng = 9;
+        int caught = 0;
+        int total = 0;
+        for (double mass : { 0.5, 1.0, 2.0 }) {
+            for (double length : { 0.5, 1.0, 1.5 }) {
+                for (double gravity : { 3.7, 9.81, 15.0 }) {
+                    for (int start = 0; start < 10; ++start, ++total) caught += balances(links, mass, length, gravity, rng);
+                }
+            }
+        }
+        std::cout << "  " << links << " link(s), starts within " << (links == 1 ? 0.3 : 0.08)
+            << " rad of upright: " << caught << " / " << total << " balanced\n";
+    }
+}
+
+int main()
+{
+    std::cout << "gain solve (uncached)\n" << std::setw(6) << "links" << std::setw(24) << "integrator"
+        << std::setw(12) << "us/solve" << std::setw(12) << "iterations" << std::setw(13) << "stabilizing" << "\n";
+    measureSolve(1);
+    measureSolve(2);
+
+    std::cout << "\ncontroller cost per tick (ns)\n" << std::setw(6) << "links" << std::setw(14) << "cached"
+        << std::setw(16) << "re-solve/tick" << std::setw(12) << "solves" << "\n";
+    measureTickCost(1);
+    measureTickCost(2);
+
+    std::cout << "\nslider drag (cache)\n";
+    measureSliderDrag(1);
+    measureSliderDrag(2);
+
+    std::cout << "\ncatch rate over mass x length x gravity grid\n";
+    measureCatchRate(1);
+    measureCatchRate(2);
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "DoublePendulum.h"
+#include "IlqrSolver.h"
+#include "LqrController.h"
+#include "MpcController.h"
+#include "PendulumEnv.h"
+#include "SinglePendulum.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <thread>
+
+/**
+ * MPC benchmark - iLQR solve cost, budget adherence and real-time swing-up
+ *
+ * Per link count, from the hanging rest position (rail 10 m, friction 0.1):
+ *   - heap allocations made by setModel / shift / solve after setup;
+ *   - a synchronous loop that re-solves every control step with the
+ *     solution shifted by one step: solve time (mean / max against the
+ *     budget), iterations, time until the pendulum stays upright;
+ *   - the interactive arrangement: a 144 Hz loop paced in wall-clock time
+ *     posting states to MpcController and applying its plan, reporting
+ *     solves per second, plan age in ticks and the swing-up time.
+ */
+
+namespace
+{
+    std::atomic<long long> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    const double DT = 1.0 / 144.0;
+    const double FRICTION = 0.1;
+    const double GRAVITY = 9.81;
+    const double RAIL_LENGTH = 10.0;
+    const int SECONDS = 15;
+    const double UPRIGHT = 0.05;        // rad, every link
+
+    std::unique_ptr<Pendulum> makePendulum(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum;
+        if (links == 1) pendulum = std::make_unique<SinglePendulum>(1.0, 1.0);
+        else pendulum = std::make_unique<DoublePendulum>(1.0, 1.0, 1.0, 1.0);
+        pendulum->setGravity(GRAVITY);
+        pendulum->setDamping(FRICTION);
+        return pendulum;
+    }
+
+    // Seconds from which the pendulum stayed upright until the end, or -1
+    struct UprightTracker
+    {
+        int since = -1;
+
+        void update(int tick, const double* observation, int size)
+        {
+            if (LqrController::uprightError(observation, size) > UPRIGHT) since = -1;
+            else if (since < 0) since = tick;
+        }
+        double seconds() const { return since < 0 ? -1.0 : since * DT; }
+    };
+
+    void printResult(const UprightTracker& upright)
+    {
+        if (upright.since < 0) std::cout << std::setw(14) << "not upright";
+        else std::cout << std::setw(14) << std::setprecision(2) << upright.seconds();
+    }
+
+    void measureAllocations(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links);
+        Cart cart(1.0, RAIL_LENGTH);
+        IlqrSolver solver;
+        double observation[6];
+        PendulumEnv::writeObservation(cart, *pendulum, observation);
+
+        const long long before = g_allocations.load();
+        solver.setModel(*pendulum, DT, FRICTION, RAIL_LENGTH);
+        for (int i = 0; i < 20; ++i) {
+            solver.solve(observation);
+            solver.shift(1);
+        }
+        std::cout << "  " << links << " link(s): " << g_allocations.load() - before
+            << " heap allocations in 20 solves\n";
+    }
+
+    void measureSynchronous(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links);
+        Cart cart(1.0, RAIL_LENGTH);
+        IlqrSolver solver;
+        solver.setModel(*pendulum, DT, FRICTION, RAIL_LENGTH);
+        const int ticksPerStep = solver.getConfig().ticksPerStep;
+        const int size = 2 + 2 * links;
+
+        double observation[6];
+        double acceleration = 0.0;
+        double totalSeconds = 0.0;
+        double maxSeconds = 0.0;
+        long long iterations = 0;
+        int solves = 0;
+        int budgetHits = 0;
+        UprightTracker upright;
+        for (int tick = 0; tick < SECONDS * 144; ++tick) {
+            PendulumEnv::writeObservation(cart, *pendulum, observation);
+            upright.update(tick, observation, size);
+            if (tick % ticksPerStep == 0) {
+                if (tick > 0) solver.shift(1);
+                const IlqrSolver::SolveStats& stats = solver.solve(observation);
+                acceleration = solver.getAction(0);
+                totalSeconds += stats.seconds;
+                maxSeconds = std::max(maxSeconds, stats.seconds);
+                iterations += stats.iterations;
+                budgetHits += stats.budgetHit;
+                ++solves;
+            }
+            pendulum->update(DT, cart.update(DT, acceleration, FRICTION, GRAVITY));
+        }
+
+        std::cout << std::setw(6) << links << std::fixed << std::setprecision(3)
+            << std::setw(12) << totalSeconds / solves * 1e3 << std::setw(12) << maxSeconds * 1e3
+            << std::setw(12) << solver.getConfig().budgetSeconds * 1e3 << std::setprecision(1)
+            << std::setw(12) << double(iterations) / solves << std::setw(10) << budgetHits;
+        printResult(upright);
+        std::cout << "\n";
+    }
+
+    void measureRealTime(int links)
+    {
+        std::unique_ptr<Pendulum> pendulum = makePendulum(links);
+        Cart cart(1.0, RAIL_LENGTH);
+        MpcController mpc;
+        mpc.setModel(*pendulum, DT, FRICTION, RAIL_LENGTH);
+        mpc.start();
+        const int size = 2 + 2 * links;
+
+        double observation[6];
+        long long planAge = 0;
+        int planned = 0;
+        UprightTracker upright;
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(DT));
+        auto next = Clock::now();
+        for (int tick = 0; tick < SECONDS * 144; ++tick) {
+            PendulumEnv::writeObservation(cart, *pendulum, observation);
+            upright.update(tick, observation, size);
+            mpc.setState(tick, observation, size);
+            double acceleration = 0.0;
+            if (mpc.getAcceleration(tick, observation, size, acceleration)) {
+                planAge += tick - static_cast<long long>(mpc.getPlan().tick);
+                ++planned;
+            }
+            pendulum->update(DT, cart.update(DT, acceleration, FRICTION, GRAVITY));
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        mpc.stop();
+
+        const MpcPlan& plan = mpc.getPlan();
+        std::cout << std::setw(6) << links << std::fixed << std::setprecision(1)
+            << std::setw(12) << double(plan.solveCount) / SECONDS << std::setw(14) << plan.maxSolveSeconds * 1e3
+            << std::setw(12) << (planned ? double(planAge) / planned : 0.0) << std::setw(12) << SECONDS * 144 - planned;
+        printResult(upright);
+        std::cout << "\n";
+    }
+}
+
+int main()
+{
+    std::cout << "allocations after setup\n";
+    measureAllocations(1);
+    measureAllocations(2);
+
+    std::cout << "\nsynchronous swing-up, solve every control step (" << SECONDS << " s simulated)\n"
+        << std::setw(6) << "links" << std::setw(12) << "mean ms" << std::setw(12) << "max ms"
+        << std::setw(12) << "budget ms" << std::setw(12) << "iterations" << std::setw(10) << "budget"
+        << std::setw(14) << "upright at s" << "\n";
+    measureSynchronous(1);
+    measureSynchronous(2);
+
+    std::cout << "\nreal-time 144 Hz loop, MPC thread (" << SECONDS << " s wall clock, "
+        << std::thread::hardware_concurrency() << " hardware threads)\n"
+        << std::setw(6) << "links" << std::setw(12) << "solves/s" << std::setw(14) << "max solve ms"
+        << std::setw(12) << "plan age" << std::setw(12) << "no plan" << std::setw(14) << "upright at s" << "\n";
+    measureRealTime(1);
+    measureRealTime(2);
+    return 0;
+}
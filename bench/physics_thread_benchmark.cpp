@@ -0,0 +1,203 @@
+#include "Cart.h"
+#include "DoublePendulum.h"
+#include "FixedStepThread.h"
+#include "Mailbox.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+/**
+ * Physics thread benchmark - simulated vs. real time under a render loop
+ *
+ * A cart + double pendulum at dt = 1/144 s, driven by a loop that stands in
+ * for the viewer: frames at a given refresh rate (sleep_until), every
+ * 30th frame a slow one, and a lock held for a while each frame as the UI
+ * does. Compared:
+ *   - lockstep: one physics tick per frame, as the viewer used to run;
+ *   - thread: FixedStepThread ticking on its own, publishing a snapshot
+ *     pair per tick through a Mailbox that the frames read.
+ * Reports the real-time factor (simulated / wall-clock seconds), dropped
+ * ticks, the share of frames that saw a new snapshot and how old the
+ * newest snapshot was when a frame read it. Also the raw Mailbox
+ * write + read cost.
+ */
+
+namespace
+{
+    using Clock = FixedStepThread::Clock;
+    const double DT = 1.0 / 144.0;
+    const double RUN_SECONDS = 4.0;
+
+    struct Snapshot
+    {
+        double time = 0.0;
+        double cartPosition = 0.0;
+        double angle[2] = {};
+    };
+
+    struct SnapshotPair
+    {
+        Snapshot previous;
+        Snapshot current;
+    };
+
+    struct Frames
+    {
+        double refreshHz;
+        double uiSeconds;           // lock held per frame
+        double slowFrameSeconds;    // every 30th frame
+    };
+
+    double seconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // Simulation state touched by the tick
+    struct World
+    {
+        Cart cart{ 1.0, 10.0 };
+        DoublePendulum pendulum{ 1.0, 1.0, 1.0, 1.0 };
+        double time = 0.0;
+
+        World()
+        {
+            pendulum.setAngle(0, 2.0);
+            pendulum.setAngle(1, 2.5);
+        }
+
+        void tick()
+        {
+            const double push = std::sin(3.0 * time) * 5.0;
+            pendulum.update(DT, cart.update(DT, push, 0.1, 9.81));
+            time += DT;
+        }
+    };
+
+    void busyWait(double duration)
+    {
+        const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(duration));
+        while (Clock::now() < end) {}
+    }
+
+    template <typename Frame>
+    int runFrames(const Frames& frames, Frame frame)
+    {
+        const Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / frames.refreshHz));
+        const Clock::time_point start = Clock::now();
+        Clock::time_point next = start;
+        int count = 0;
+        while (seconds(Clock::now() - start) < RUN_SECONDS) {
+            frame();
+            if (++count % 30 == 0) busyWait(frames.slowFrameSeconds);
+            next += period;
+            if (next < Clock::now()) next = Clock::now();
+            std::this_thread::sleep_until(next);
+        }
+        return count;
+    }
+
+    void measureLockstep(const Frames& frames)
+    {
+        World world;
+        const Clock::time_point start = Clock::now();
+        runFrames(frames, [&]() {
+            busyWait(frames.uiSeconds);
+            world.tick();
+        });
+        const double wall = seconds(Clock::now() - start);
+        std::cout << std::setw(10) << "lockstep" << std::setw(8) << std::setprecision(0) << frames.refreshHz
+            << std::setw(10) << std::setprecision(3) << world.time / wall
+            << std::setw(10) << "-" << std::setw(12) << "-" << std::setw(14) << "-" << "\n";
+    }
+
+    void measureThread(const Frames& frames)
+    {
+        World world;
+        Mailbox<SnapshotPair> snapshots;
+        Snapshot last;
+        const Clock::time_point epoch = Clock::now();
+        FixedStepThread physics(DT);
+        physics.start([&](Clock::time_point time) {
+            world.tick();
+            Snapshot snapshot;
+            snapshot.time = seconds(time - epoch);
+            snapshot.cartPosition = world.cart.getPosition();
+            snapshot.angle[0] = world.pendulum.getAngle(0);
+            snapshot.angle[1] = world.pendulum.getAngle(1);
+            snapshots.write({ last, snapshot });
+            last = snapshot;
+        });
+
+        int fresh = 0;
+        double ageSum = 0.0;
+        double maxAge = 0.0;
+        int read = 0;
+        const Clock::time_point start = Clock::now();
+        const int count = runFrames(frames, [&]() {
+            {
+                std::lock_guard<std::mutex> lock(physics.getMutex());
+                busyWait(frames.uiSeconds);
+            }
+            fresh += snapshots.read();
+            const Snapshot& current = snapshots.getFront().current;
+            if (current.time > 0.0) {
+                const double age = seconds(Clock::now() - epoch) - current.time;
+                ageSum += age;
+                maxAge = std::max(maxAge, age);
+                ++read;
+            }
+        });
+        physics.stop();
+        const double wall = seconds(Clock::now() - start);
+
+        std::cout << std::setw(10) << "thread" << std::setw(8) << std::setprecision(0) << frames.refreshHz
+            << std::setw(10) << std::setprecision(3) << world.time / wall
+            << std::setw(10) << physics.getDroppedTicks()
+            << std::setw(12) << std::setprecision(2) << 100.0 * fresh / count
+            << std::setw(14) << (read ? ageSum / read * 1e3 : 0.0) << " / " << maxAge * 1e3 << "\n";
+    }
+
+    void measureMailbox()
+    {
+        Mailbox<SnapshotPair> mailbox;
+        SnapshotPair pair;
+        const int iterations = 10000000;
+        volatile double sink = 0.0;
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            pair.current.time = i;
+            mailbox.write(pair);
+            mailbox.read();
+            sink = sink + mailbox.getFront().current.time;
+        }
+        std::cout << "mailbox write + read (" << sizeof(SnapshotPair) << " bytes): " << std::setprecision(1)
+            << seconds(Clock::now() - start) / iterations * 1e9 << " ns\n";
+    }
+}
+
+int main()
+{
+    std::cout << std::fixed << std::setprecision(1) << RUN_SECONDS << " s per row, physics at "
+        << std::setprecision(0) << 1.0 / DT
+        << " Hz, UI lock 1 ms per frame, every 30th frame 100 ms slow\n"
+        << std::setw(10) << "mode" << std::setw(8) << "Hz" << std::setw(10) << "sim/real"
+        << std::setw(10) << "dropped" << std::setw(12) << "fresh %" << std::setw(14) << "age ms"
+        << " (mean / max)\n";
+    for (double refreshHz : { 60.0, 144.0, 240.0 }) {
+        const Frames frames{ refreshHz, 0.001, 0.1 };
+        measureLockstep(frames);
+        measureThread(frames);
+    }
+    std::cout << "\n";
+    measureMailbox();
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "MlpPolicy.h"
+#include "Random.h"
+#include "SimdDispatch.h"
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Policy benchmark - MLP inference accuracy and throughput
+ *
+ * For randomly initialized single- and double-pendulum policies (64 x 64
+ * hidden): the largest deviation of the SIMD float forward pass from a
+ * double-precision std::tanh reference, whether evaluate() and
+ * evaluateBatch() agree bit for bit, a save / load round trip, inference
+ * throughput (single calls and batches, at every SIMD level up to the
+ * dispatched one; see SimdDispatch.h), and closed-loop VecEnv rollouts
+ * where every env step includes a batched policy evaluation on the
+ * stepping threads.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Uniform(-1, 1) / sqrt(fan-in) weights, small biases
+    MlpPolicy makeRandomPolicy(int inputSize, std::uint64_t seed)
+    {
+        MlpPolicy policy({ inputSize, 64, 64, 1 });
+        std::uint64_t state = seed;
+        float* parameters = policy.getParameters();
+        const std::vector<int>& sizes = policy.getLayerSizes();
+        std::size_t offset = 0;
+        for (std::size_t layer = 0; layer + 1 < sizes.size(); ++layer) {
+            const int n = sizes[layer];
+            const int m = sizes[layer + 1];
+            double scale = 1.5 / std::sqrt(static_cast<double>(n));
+            for (int i = 0; i < m * n; ++i) {
+                parameters[offset++] = static_cast<float>(scale * (2.0 * uniformUnit(splitMix64(state)) - 1.0));
+            }
+            for (int i = 0; i < m; ++i) {
+                parameters[offset++] = static_cast<float>(0.1 * (2.0 * uniformUnit(splitMix64(state)) - 1.0));
+            }
+        }
+        return policy;
+    }
+
+    double referenceAction(const MlpPolicy& policy, const double* observation)
+    {
+        const std::vector<int>& sizes = policy.getLayerSizes();
+        std::vector<double> in(observation, observation + sizes.front());
+        const float* parameters = policy.getParameters();
+        for (std::size_t layer = 0; layer + 1 < sizes.size(); ++layer) {
+            const int n = sizes[layer];
+            const int m = sizes[layer + 1];
+            const float* bias = parameters + static_cast<std::size_t>(m) * n;
+            std::vector<double> out(m);
+            for (int j = 0; j < m; ++j) {
+                double sum = bias[j];
+                for (int k = 0; k < n; ++k) sum += static_cast<double>(parameters[j * n + k]) * in[k];
+                out[j] = std::tanh(sum);
+            }
+            parameters = bias + m;
+            in.swap(out);
+        }
+        return in[0];
+    }
+
+    void checkAccuracy(const MlpPolicy& policy, int links)
+    {
+        const int inputSize = policy.getInputSize();
+        const std::size_t count = 10000;
+        std::vector<double> observations(count * inputSize);
+        std::uint64_t state = 99;
+        for (double& value : observations) value = 6.0 * (uniformUnit(splitMix64(state)) - 0.5);
+
+        std::vector<double> actions(count);
+        policy.evaluateBatch(observations.data(), count, actions.data());
+        double maxError = 0.0;
+        long long mismatches = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            maxError = std::max(maxError, std::abs(actions[i] - referenceAction(policy, &observations[i * inputSize])));
+            mismatches += policy.act(&observations[i * inputSize]) != actions[i];
+        }
+        std::cout << std::setw(6) << links << std::setw(18) << std::scientific << std::setprecision(2) << maxError
+            << std::setw(22) << mismatches << "\n";
+    }
+
+    void checkSaveLoad(const MlpPolicy& policy)
+    {
+        const char* path = "policy_benchmark_roundtrip.bin";
+        MlpPolicy loaded;
+        bool ok = policy.save(path) && loaded.load(path)
+            && loaded.getLayerSizes() == policy.getLayerSizes()
+            && std::equal(policy.getParameters(), policy.getParameters() + policy.getParameterCount(),
+                loaded.getParameters());
+        std::remove(path);
+        std::cout << "save / load round trip: " << (ok ? "identical" : "MISMATCH") << "\n";
+    }
+
+    void measureInference(const MlpPolicy& policy, int links)
+    {
+        const int inputSize = policy.getInputSize();
+        const std::size_t count = 4096;
+        std::vector<double> observations(count * inputSize, 0.1), actions(count);
+
+        const SimdLevel dispatched = getSimdLevel();
+        for (int level = 0; level <= static_cast<int>(dispatched); ++level) {
+            setSimdLevel(static_cast<SimdLevel>(level));
+
+            double best = 1e30;
+            for (int repetition = 0; repetition < 5; ++repetition) {
+                auto start = Clock::now();
+                policy.evaluateBatch(observations.data(), count, actions.data());
+                best = std::min(best, seconds(start));
+            }
+            double batchRate = count / best;
+
+            best = 1e30;
+            for (int repetition = 0; repetition < 5; ++repetition) {
+                auto start = Clock::now();
+                for (std::size_t i = 0; i < count; ++i) actions[i] = policy.act(&observations[i * inputSize]);
+                best = std::min(best, seconds(start));
+            }
+            double singleRate = count / best;
+
+            const std::string simd = std::string(getSimdLevelName(getSimdLevel())) + " x"
+                + std::to_string(MlpPolicy::getBlockWidth());
+            std::cout << std::setw(6) << links << std::setw(14) << simd
+                << std::setw(16) << std::fixed << std::setprecision(0) << batchRate
+                << std::setw(16) << singleRate << std::setw(14) << std::setprecision(1) << 1e6 / singleRate << "\n";
+        }
+        setSimdLevel(dispatched);
+    }
+
+    void closedLoop(const MlpPolicy& policy, int links, std::size_t numEnvs, int numThreads, int batchSteps)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = links;
+        config.substeps = 1;
+        VecEnv vec(numEnvs, config, numThreads);
+        ThreadPool& pool = vec.getThreadPool();
+
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(numEnvs * obsSize), actions(numEnvs), rewards(numEnvs);
+        std::vector<std::uint8_t> terminated(numEnvs), truncated(numEnvs);
+        vec.reset(5, observations.data());
+
+        double inferenceSeconds = 0.0;
+        double totalReward = 0.0;
+        auto start = Clock::now();
+        for (int step = 0; step < batchSteps; ++step) {
+            auto inferenceStart = Clock::now();
+            pool.parallelFor(numEnvs, [&](std::size_t begin, std::size_t end) {
+                policy.evaluateBatch(&observations[begin * obsSize], end - begin, &actions[begin]);
+                });
+            inferenceSeconds += seconds(inferenceStart);
+            vec.step(actions.data(), observations.data(), rewards.data(), terminated.data(), truncated.data());
+            for (double reward : rewards) totalReward += reward;
+        }
+        double total = seconds(start);
+
+        std::cout << std::setw(6) << links << std::setw(8) << numEnvs << std::setw(9) << vec.getNumThreads()
+            << std::setw(14) << std::fixed << std::setprecision(0) << numEnvs * static_cast<double>(batchSteps) / total
+            << std::setw(14) << std::setprecision(2) << inferenceSeconds / total
+            << std::setw(14) << std::setprecision(4) << totalReward / (numEnvs * static_cast<double>(batchSteps)) << "\n";
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "SIMD level: " << getSimdLevelName(getSimdLevel()) << ", " << MlpPolicy::getBlockWidth()
+        << " float lanes (CPU supports " << getSimdLevelName(getSupportedSimdLevel()) << "), hardware threads: "
+        << hardwareThreads << "\n";
+
+    MlpPolicy single = makeRandomPolicy(4, 1);
+    MlpPolicy doubleLink = makeRandomPolicy(6, 2);
+
+    std::cout << "\naccuracy vs. double reference (10000 observations)\n"
+        << std::setw(6) << "links" << std::setw(18) << "max |error|" << std::setw(22) << "act() != batch" << "\n";
+    checkAccuracy(single, 1);
+    checkAccuracy(doubleLink, 2);
+    checkSaveLoad(doubleLink);
+
+    std::cout << "\ninference throughput (" << single.getParameterCount() << " / "
+        << doubleLink.getParameterCount() << " parameters)\n"
+        << std::setw(6) << "links" << std::setw(14) << "simd" << std::setw(16) << "batch obs/s" << std::setw(16) << "single obs/s"
+        << std::setw(14) << "single us" << "\n";
+    measureInference(single, 1);
+    measureInference(doubleLink, 2);
+
+    std::cout << "\nclosed-loop rollouts (policy + physics per env step)\n"
+        << std::setw(6) << "links" << std::setw(8) << "envs" << std::setw(9) << "threads"
+        << std::setw(14) << "env-steps/s" << std::setw(14) << "policy share" << std::setw(14) << "mean reward" << "\n";
+    closedLoop(single, 1, 4096, hardwareThreads, 200);
+    closedLoop(doubleLink, 2, 4096, hardwareThreads, 200);
+    return 0;
+}
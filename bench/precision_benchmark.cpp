@@ -0,0 +1,259 @@
+#include "BatchCartPendulum.h"
+#include "SinglePendulum.h"
+#include "DoublePendulum.h"
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * Precision benchmark - float vs. double dynamics, and dual-number Jacobians
+ *
+ * 1. Accuracy: BatchCartPendulumFloat and BatchCartPendulum run the same
+ *    environments with the same inputs. The largest angle deviation from the
+ *    double run is reported at typical episode lengths, next to the deviation
+ *    a double run shows when its initial angles are perturbed by one float
+ *    ulp (the sensitivity floor of the dynamics themselves).
+ * 2. Throughput: environment-steps per second for both precisions.
+ * 3. Derivatives: computeStepJacobian (forward mode) against central finite
+ *    differences, for every integrator.
+ */
+
+namespace
+{
+    const double DT = 1.0 / 144.0;
+    const double PI = 3.14159265358979323846;
+
+    double inputFor(std::size_t env, int tick)
+    {
+        return 20.0 * std::sin(0.02 * tick + 0.37 * static_cast<double>(env));
+    }
+
+    double initialAngleFor(std::size_t env, int link)
+    {
+        double base = 0.2 + 2.8 * static_cast<double>(env % 61) / 61.0;
+        return link == 0 ? base : -0.5 * base;
+    }
+
+    double angleError(double a, double b)
+    {
+        return std::abs(std::remainder(a - b, 2.0 * PI));
+    }
+
+    template <typename Batch>
+    void initialize(Batch& batch, int numLinks, double perturbation)
+    {
+        using Scalar = decltype(batch.getAngle(0, 0));
+        for (std::size_t env = 0; env < batch.getNumEnvs(); ++env) {
+            for (int link = 0; link < numLinks; ++link) {
+                double angle = initialAngleFor(env, link);
+                batch.setAngle(env, link, static_cast<Scalar>(angle + perturbation * std::abs(angle)));
+            }
+        }
+    }
+
+    void runAccuracy(int numLinks)
+    {
+        const std::size_t numEnvs = 256;
+        const int checkpoints[] = { 144, 500, 1000, 2000, 5000 };
+        const int maxTicks = 5000;
+
+        BatchCartPendulum reference(numEnvs, numLinks);
+        BatchCartPendulum perturbed(numEnvs, numLinks);
+        BatchCartPendulumFloat single(numEnvs, numLinks);
+        initialize(reference, numLinks, 0.0);
+        initialize(perturbed, numLinks, 0.5 * std::numeric_limits<float>::epsilon());
+        initialize(single, numLinks, 0.0);
+
+        std::vector<double> inputs(numEnvs);
+        std::vector<float> inputsFloat(numEnvs);
+
+        std::cout << (numLinks == 1 ? "Single" : "Double") << " pendulum, " << numEnvs
+            << " environments, dt = 1/144 s\n";
+        std::cout << std::setw(8) << "ticks" << std::setw(10) << "seconds"
+            << std::setw(16) << "float median" << std::setw(14) << "float max"
+            << std::setw(18) << "1-ulp dbl median" << std::setw(14) << "cart max" << "\n";
+
+        int next = 0;
+        for (int tick = 1; tick <= maxTicks; ++tick) {
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                inputs[env] = inputFor(env, tick);
+                inputsFloat[env] = static_cast<float>(inputs[env]);
+            }
+            reference.update(DT, inputs.data());
+            perturbed.update(DT, inputs.data());
+            single.update(DT, inputsFloat.data());
+
+            if (tick != checkpoints[next]) continue;
+            ++next;
+
+            std::vector<double> floatErrors(numEnvs);
+            std::vector<double> perturbedErrors(numEnvs);
+            double cartError = 0.0;
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                double floatError = 0.0;
+                double perturbedError = 0.0;
+                for (int link = 0; link < numLinks; ++link) {
+                    double angle = reference.getAngle(env, link);
+                    floatError = std::max(floatError, angleError(single.getAngle(env, link), angle));
+                    perturbedError = std::max(perturbedError, angleError(perturbed.getAngle(env, link), angle));
+                }
+                floatErrors[env] = floatError;
+                perturbedErrors[env] = perturbedError;
+                cartError = std::max(cartError, std::abs(single.getCartPosition(env) - reference.getCartPosition(env)));
+            }
+            std::sort(floatErrors.begin(), floatErrors.end());
+            std::sort(perturbedErrors.begin(), perturbedErrors.end());
+
+            std::cout << std::setw(8) << tick << std::setw(10) << std::fixed << std::setprecision(1) << tick * DT
+                << std::scientific << std::setprecision(2)
+                << std::setw(16) << floatErrors[numEnvs / 2] << std::setw(14) << floatErrors.back()
+                << std::setw(18) << perturbedErrors[numEnvs / 2] << std::setw(14) << cartError
+                << std::defaultfloat << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    template <typename Batch, typename Scalar>
+    double stepsPerSecond(int numLinks, std::size_t numEnvs, int ticks)
+    {
+        Batch batch(numEnvs, numLinks);
+        initialize(batch, numLinks, 0.0);
+        std::vector<Scalar> inputs(numEnvs);
+
+        double best = 0.0;
+        for (int repetition = 0; repetition < 3; ++repetition) {
+            batch.reset();
+            initialize(batch, numLinks, 0.0);
+            auto start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; ++tick) {
+                for (std::size_t env = 0; env < numEnvs; ++env) {
+                    inputs[env] = static_cast<Scalar>(inputFor(env, tick));
+                }
+                batch.update(DT, inputs.data());
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = std::max(best, numEnvs * static_cast<double>(ticks) / seconds);
+        }
+        return best;
+    }
+
+    void runThroughput()
+    {
+        const std::size_t numEnvs = 4096;
+        const int ticks = 200;
+        std::cout << "Batched throughput, " << numEnvs << " environments (SIMD lanes: double "
+            << BatchCartPendulum::getLaneWidth() << ", float " << BatchCartPendulumFloat::getLaneWidth()
+            << ", " << getSimdLevelName(getSimdLevel()) << ")\n";
+        std::cout << std::setw(8) << "links" << std::setw(18) << "double steps/s"
+            << std::setw(18) << "float steps/s" << std::setw(10) << "speedup" << "\n";
+        for (int numLinks = 1; numLinks <= 2; ++numLinks) {
+            double d = stepsPerSecond<BatchCartPendulum, double>(numLinks, numEnvs, ticks);
+            double f = stepsPerSecond<BatchCartPendulumFloat, float>(numLinks, numEnvs, ticks);
+            std::cout << std::setw(8) << numLinks << std::scientific << std::setprecision(3)
+                << std::setw(18) << d << std::setw(18) << f
+                << std::fixed << std::setprecision(2) << std::setw(10) << f / d
+                << std::defaultfloat << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // Central differences of one step, one input at a time
+    template <typename PendulumType, int N, typename SetInputs>
+    double finiteDifferenceError(PendulumType& pendulum, const std::array<double, N + 1>& x,
+        const std::array<std::array<double, N + 1>, N>& jacobian, const SetInputs& setInputs)
+    {
+        double maxError = 0.0;
+        for (int col = 0; col <= N; ++col) {
+            double h = 1e-6 * std::max(1.0, std::abs(x[col]));
+            std::array<double, N> plus, minus;
+            std::array<std::array<double, N + 1>, N> unused;
+            auto xp = x;
+            auto xm = x;
+            xp[col] += h;
+            xm[col] -= h;
+            setInputs(xp);
+            pendulum.computeStepJacobian(DT, xp[N], plus, unused);
+            setInputs(xm);
+            pendulum.computeStepJacobian(DT, xm[N], minus, unused);
+            for (int row = 0; row < N; ++row) {
+                double fd = (plus[row] - minus[row]) / (2.0 * h);
+                maxError = std::max(maxError, std::abs(fd - jacobian[row][col]) / (1.0 + std::abs(fd)));
+            }
+        }
+        setInputs(x);
+        return maxError;
+    }
+
+    void runJacobians()
+    {
+        std::cout << "Step Jacobians (dual numbers) vs. central finite differences\n";
+        std::cout << std::setw(22) << "integrator" << std::setw(16) << "single |diff|"
+            << std::setw(12) << "ns/jac" << std::setw(16) << "double |diff|" << std::setw(12) << "ns/jac" << "\n";
+
+        for (int type = 0; type < INTEGRATOR_TYPE_COUNT; ++type) {
+            IntegratorType integrator = static_cast<IntegratorType>(type);
+
+            SinglePendulum single(1.0, 1.0);
+            single.setIntegrator(integrator);
+            std::array<double, 3> xs = { 2.3, -1.1, 4.0 };
+            auto setSingle = [&](const std::array<double, 3>& x) {
+                single.setAngle(x[0]);
+                single.setAngularVelocity(x[1]);
+                };
+            setSingle(xs);
+            std::array<double, 2> nextSingle;
+            SinglePendulum::StepJacobian jacobianSingle;
+            single.computeStepJacobian(DT, xs[2], nextSingle, jacobianSingle);
+            double errorSingle = finiteDifferenceError<SinglePendulum, 2>(single, xs, jacobianSingle, setSingle);
+
+            DoublePendulum pendulum(1.0, 1.0, 1.0, 1.0);
+            pendulum.setIntegrator(integrator);
+            std::array<double, 5> xd = { 2.0, 0.7, -1.0, -1.5, 4.0 };
+            auto setDouble = [&](const std::array<double, 5>& x) {
+                pendulum.setAngle(0, x[0]);
+                pendulum.setAngularVelocity(0, x[1]);
+                pendulum.setAngle(1, x[2]);
+                pendulum.setAngularVelocity(1, x[3]);
+                };
+            setDouble(xd);
+            std::array<double, 4> nextDouble;
+            DoublePendulum::StepJacobian jacobianDouble;
+            pendulum.computeStepJacobian(DT, xd[4], nextDouble, jacobianDouble);
+            double errorDouble = finiteDifferenceError<DoublePendulum, 4>(pendulum, xd, jacobianDouble, setDouble);
+
+            const int calls = 20000;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i) {
+                single.computeStepJacobian(DT, xs[2] + 1e-9 * (i & 7), nextSingle, jacobianSingle);
+            }
+            double singleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i) {
+                pendulum.computeStepJacobian(DT, xd[4] + 1e-9 * (i & 7), nextDouble, jacobianDouble);
+            }
+            double doubleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+
+            std::cout << std::setw(22) << getIntegratorName(integrator)
+                << std::scientific << std::setprecision(2)
+                << std::setw(16) << errorSingle << std::setw(12) << std::fixed << std::setprecision(0) << singleNs
+                << std::scientific << std::setprecision(2)
+                << std::setw(16) << errorDouble << std::setw(12) << std::fixed << std::setprecision(0) << doubleNs
+                << std::defaultfloat << "\n";
+        }
+    }
+}
+
+int main()
+{
+    runAccuracy(1);
+    runAccuracy(2);
+    runThroughput();
+    runJacobians();
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Rollout benchmark - static vs. work-stealing scheduling on uneven episodes
+ *
+ * Collects exactly one episode per double-pendulum environment (auto-reset
+ * off): environment i pushes the cart with a constant action that grows
+ * with i, so high-index environments hit the rail end within ~100 ticks
+ * while low-index ones run to truncation. With a static partition the
+ * threads holding the high indices go idle early; work stealing hands
+ * their time to the rest. Reports wall time, environment steps per second,
+ * and per-thread utilization (busy / parallel time), chunks and steals.
+ *
+ * Utilization and speedup are only meaningful with as many hardware
+ * threads as pool threads; on fewer cores the OS time-slices the pool.
+ */
+
+namespace
+{
+    void run(std::size_t numEnvs, int numThreads, bool workStealing, int repetitions)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = 2;
+        config.substeps = 1;
+        VecEnv vec(numEnvs, config, numThreads);
+        vec.setAutoReset(false);
+        vec.setWorkStealing(workStealing);
+
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(numEnvs * obsSize);
+        std::vector<double> actions(numEnvs);
+        std::vector<double> rewards(numEnvs);
+        std::vector<std::uint8_t> terminated(numEnvs);
+        std::vector<std::uint8_t> truncated(numEnvs);
+        for (std::size_t env = 0; env < numEnvs; ++env) {
+            actions[env] = 0.02 + 0.5 * static_cast<double>(env) / static_cast<double>(numEnvs);
+        }
+
+        // Best of several rollouts; the counters belong to the best one
+        double bestSeconds = 1e30;
+        long long envSteps = 0;
+        std::vector<ThreadPool::WorkerStats> stats(vec.getNumThreads());
+        double parallelSeconds = 0.0;
+        for (int repetition = 0; repetition < repetitions; ++repetition) {
+            vec.reset(11, observations.data());
+            vec.resetWorkerStats();
+            long long steps = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (std::size_t active = numEnvs; active > 0; active = vec.getNumActive()) {
+                steps += static_cast<long long>(active);
+                vec.step(actions.data(), observations.data(), rewards.data(),
+                    terminated.data(), truncated.data());
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (seconds < bestSeconds) {
+                bestSeconds = seconds;
+                envSteps = steps;
+                for (int thread = 0; thread < vec.getNumThreads(); ++thread) {
+                    stats[thread] = vec.getWorkerStats(thread);
+                }
+                parallelSeconds = vec.getParallelSeconds();
+            }
+        }
+
+        double minUtilization = 1.0, meanUtilization = 0.0;
+        unsigned long long steals = 0;
+        for (const ThreadPool::WorkerStats& worker : stats) {
+            double utilization = worker.busySeconds / parallelSeconds;
+            minUtilization = std::min(minUtilization, utilization);
+            meanUtilization += utilization / static_cast<double>(stats.size());
+            steals += worker.steals;
+        }
+
+        std::cout << std::setw(8) << numEnvs << std::setw(9) << vec.getNumThreads()
+            << std::setw(10) << (workStealing ? "stealing" : "static")
+            << std::setw(8) << vec.getChunkSize()
+            << std::setw(11) << std::fixed << std::setprecision(2) << bestSeconds * 1e3
+            << std::setw(14) << std::setprecision(0) << static_cast<double>(envSteps) / bestSeconds
+            << std::setw(10) << std::setprecision(2) << meanUtilization
+            << std::setw(10) << minUtilization
+            << std::setw(9) << steals << "\n";
+
+        for (int thread = 0; thread < static_cast<int>(stats.size()); ++thread) {
+            std::cout << "          thread " << std::setw(3) << thread
+                << "  util " << std::setprecision(2) << stats[thread].busySeconds / parallelSeconds
+                << "  chunks " << stats[thread].chunks
+                << "  steals " << stats[thread].steals << "\n";
+        }
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "hardware threads: " << hardwareThreads << "\n";
+    std::cout << std::setw(8) << "envs" << std::setw(9) << "threads" << std::setw(10) << "schedule"
+        << std::setw(8) << "chunk" << std::setw(11) << "wall ms" << std::setw(14) << "env-steps/s"
+        << std::setw(10) << "util avg" << std::setw(10) << "util min" << std::setw(9) << "steals" << "\n";
+
+    std::vector<int> threadCounts = { 1, 2, 4 };
+    if (hardwareThreads > 4) threadCounts.push_back(hardwareThreads);
+    for (int numThreads : threadCounts) {
+        for (bool workStealing : { false, true }) {
+            run(2048, numThreads, workStealing, 3);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+#include "ChainPendulum.h"
+#include "DoublePendulum.h"
+#include "Random.h"
+#include "SinglePendulum.h"
+#include "SnapshotArena.h"
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Snapshot benchmark - save / restore / fork cost for branching rollouts
+ *
+ * Per link count: the cost of saving and restoring a PendulumEnv snapshot
+ * into a SnapshotArena slot, against cloning the old way (constructing a
+ * cart and pendulum and copying the state through the per-link setters), and
+ * whether a restored environment replays the original trajectory bit for
+ * bit. A VecEnv saved to an arena, stepped on and restored must retrace
+ * the same steps. Then an MPPI-style control loop on a VecEnv: every control step
+ * forks all branches from the root state, rolls them out over the horizon
+ * with sampled actions and applies the best first action to the root.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    PendulumEnvConfig makeConfig(int links)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = links;
+        config.initialAngle = 0.3;
+        return config;
+    }
+
+    // Same env after restore must retrace the saved trajectory exactly
+    bool checkReplay(int links)
+    {
+        PendulumEnv original(makeConfig(links));
+        PendulumEnv copy(makeConfig(links));
+        original.reset(11);
+        std::vector<unsigned char> snapshot(original.getSnapshotBytes());
+        std::vector<double> expected;
+        for (int step = 0; step < 200; ++step) {
+            if (step == 100) original.saveSnapshot(snapshot.data());
+            original.step(std::sin(0.1 * step));
+            if (step >= 100) {
+                expected.insert(expected.end(), original.getObservation(),
+                    original.getObservation() + original.getObservationSize());
+            }
+        }
+
+        copy.reset(99);
+        if (!copy.restoreSnapshot(snapshot.data())) return false;
+        for (int step = 100; step < 200; ++step) {
+            copy.step(std::sin(0.1 * step));
+            const double* row = &expected[(step - 100) * copy.getObservationSize()];
+            if (std::memcmp(row, copy.getObservation(), copy.getObservationSize() * sizeof(double)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // VecEnv rewound with save / restoreSnapshots must retrace its steps exactly
+    bool checkVecEnvRewind(int links, int numThreads)
+    {
+        const std::size_t numEnvs = 64;
+        const int steps = 50;
+        VecEnv vec(numEnvs, makeConfig(links), numThreads);
+        vec.setAutoReset(false);
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(numEnvs * obsSize), rewards(numEnvs), actions(numEnvs);
+        std::vector<std::uint8_t> terminated(numEnvs), truncated(numEnvs);
+        vec.reset(7, observations.data());
+
+        SnapshotArena arena(numEnvs, vec.getSnapshotBytes());
+        if (!vec.saveSnapshots(arena)) return false;
+
+        std::vector<double> expected;
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 1 && !vec.restoreSnapshots(arena, observations.data())) return false;
+            for (int step = 0; step < steps; ++step) {
+                for (std::size_t env = 0; env < numEnvs; ++env) actions[env] = std::sin(0.1 * step + 0.01 * env);
+                vec.step(actions.data(), observations.data(), rewards.data(), terminated.data(), truncated.data());
+                if (pass == 0) {
+                    expected.insert(expected.end(), observations.begin(), observations.end());
+                }
+                else if (std::memcmp(&expected[step * observations.size()], observations.data(),
+                    observations.size() * sizeof(double)) != 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void measureSingle(int links)
+    {
+        const PendulumEnvConfig config = makeConfig(links);
+        PendulumEnv env(config);
+        env.reset(1);
+        const int slots = 1024;
+        SnapshotArena arena(slots, env.getSnapshotBytes());
+
+        const int rounds = 1000;
+        auto start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (int slot = 0; slot < slots; ++slot) env.saveSnapshot(arena.getSlot(slot));
+        }
+        double saveNs = seconds(start) / (static_cast<double>(rounds) * slots) * 1e9;
+
+        start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (int slot = 0; slot < slots; ++slot) env.restoreSnapshot(arena.getSlot(slot));
+        }
+        double restoreNs = seconds(start) / (static_cast<double>(rounds) * slots) * 1e9;
+
+        // Old way: new cart and pendulum objects, state copied through the setters
+        const int clones = 20000;
+        volatile double sink = 0.0;     // keeps the clones alive
+        start = Clock::now();
+        for (int clone = 0; clone < clones; ++clone) {
+            Cart cart(config.cartMass, config.railLength);
+            cart.setPosition(env.getCart().getPosition());
+            cart.setVelocity(env.getCart().getVelocity());
+            std::unique_ptr<Pendulum> pendulum;
+            if (links == 1) pendulum = std::make_unique<SinglePendulum>(config.linkMass, config.linkLength);
+            else if (links == 2) pendulum = std::make_unique<DoublePendulum>(config.linkMass, config.linkLength,
+                config.linkMass, config.linkLength);
+            else pendulum = std::make_unique<ChainPendulum>(links, config.linkMass, config.linkLength);
+            for (int link = 0; link < links; ++link) {
+                pendulum->setLinkState(link, env.getPendulum().getAngle(link), env.getPendulum().getAngularVelocity(link));
+            }
+            sink = sink + pendulum->getAngle(0) + cart.getPosition();
+        }
+        double cloneNs = seconds(start) / clones * 1e9;
+
+        std::cout << std::setw(6) << links << std::setw(8) << env.getSnapshotBytes() << std::fixed
+            << std::setprecision(1) << std::setw(12) << saveNs << std::setw(12) << restoreNs
+            << std::setw(14) << cloneNs << std::setw(10) << (checkReplay(links) ? "exact" : "DIFFERS") << "\n";
+    }
+
+    void measureMppi(int links, std::size_t branches, int horizon, int controlSteps, int numThreads)
+    {
+        PendulumEnvConfig config = makeConfig(links);
+        config.terminateAtRailEnd = false;
+        PendulumEnv root(config);
+        root.reset(5);
+        VecEnv vec(branches, config, numThreads);
+        vec.setAutoReset(false);
+
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(branches * obsSize), rewards(branches), returns(branches);
+        std::vector<double> actions(branches * horizon), stepActions(branches);
+        std::vector<std::uint8_t> terminated(branches), truncated(branches);
+        std::uint64_t rng = 3;
+
+        double forkSeconds = 0.0;
+        double rolloutSeconds = 0.0;
+        double rootReturn = 0.0;
+        for (int control = 0; control < controlSteps; ++control) {
+            auto start = Clock::now();
+            vec.fork(root, observations.data());
+            forkSeconds += seconds(start);
+
+            start = Clock::now();
+            for (double& action : actions) action = 2.0 * uniformUnit(splitMix64(rng)) - 1.0;
+            std::fill(returns.begin(), returns.end(), 0.0);
+            for (int t = 0; t < horizon; ++t) {
+                for (std::size_t b = 0; b < branches; ++b) stepActions[b] = actions[b * horizon + t];
+                vec.step(stepActions.data(), observations.data(), rewards.data(), terminated.data(), truncated.data());
+                for (std::size_t b = 0; b < branches; ++b) returns[b] += rewards[b];
+            }
+            rolloutSeconds += seconds(start);
+
+            std::size_t best = static_cast<std::size_t>(std::max_element(returns.begin(), returns.end()) - returns.begin());
+            rootReturn += root.step(actions[best * horizon]).reward;
+        }
+
+        const double branchSteps = static_cast<double>(branches) * horizon * controlSteps;
+        std::cout << std::setw(6) << links << std::setw(10) << branches << std::setw(9) << horizon
+            << std::fixed << std::setprecision(1) << std::setw(12) << forkSeconds / controlSteps * 1e6
+            << std::setw(14) << rolloutSeconds / controlSteps * 1e3
+            << std::setw(14) << std::setprecision(0) << branchSteps / (forkSeconds + rolloutSeconds)
+            << std::setw(14) << std::setprecision(3) << rootReturn / controlSteps << "\n";
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::cout << "single environment (ns per operation)\n"
+        << std::setw(6) << "links" << std::setw(8) << "bytes" << std::setw(12) << "save" << std::setw(12) << "restore"
+        << std::setw(14) << "setter clone" << std::setw(10) << "replay" << "\n";
+    for (int links : { 1, 2, 8 }) measureSingle(links);
+
+    std::cout << "\nVecEnv save / restore rewind: " << (checkVecEnvRewind(2, hardwareThreads) ? "exact" : "DIFFERS") << "\n";
+
+    std::cout << "\nMPPI-style branching on VecEnv (" << hardwareThreads << " threads)\n"
+        << std::setw(6) << "links" << std::setw(10) << "branches" << std::setw(9) << "horizon"
+        << std::setw(12) << "fork us" << std::setw(14) << "rollout ms" << std::setw(14) << "branch-step/s"
+        << std::setw(14) << "root reward" << "\n";
+    measureMppi(1, 1024, 30, 50, hardwareThreads);
+    measureMppi(1, 4096, 30, 20, hardwareThreads);
+    measureMppi(2, 1024, 30, 50, hardwareThreads);
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include "TrajectoryReader.h"
+#include "TrajectoryRecorder.h"
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Trajectory benchmark - cost of recording batched rollouts
+ *
+ * Steps a VecEnv and appends one TrajectoryRecorder record per environment
+ * and step, filled in parallel on the stepping threads, and compares:
+ * stepping alone, stepping plus recording, the recorder alone (records of
+ * a frozen batch), and formatted CSV through std::ofstream as the
+ * baseline. The file is read back to check the header and the last batch,
+ * then opened with TrajectoryReader to time the index build and random
+ * seeks by sample and by playback time across all interleaved streams.
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double seconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    struct Batch
+    {
+        explicit Batch(std::size_t numEnvs, int links, int numThreads)
+            : vec(numEnvs, config(links), numThreads)
+            , observations(numEnvs * vec.getObservationSize())
+            , actions(numEnvs)
+            , rewards(numEnvs)
+            , terminated(numEnvs)
+            , truncated(numEnvs)
+        {
+            vec.reset(3, observations.data());
+        }
+
+        static PendulumEnvConfig config(int links)
+        {
+            PendulumEnvConfig result;
+            result.numLinks = links;
+            result.substeps = 1;
+            return result;
+        }
+
+        void step(int index)
+        {
+            for (std::size_t i = 0; i < actions.size(); ++i) {
+                actions[i] = ((index / 20 + i) % 3) - 1.0;
+            }
+            vec.step(actions.data(), observations.data(), rewards.data(), terminated.data(), truncated.data());
+        }
+
+        // One record per environment, filled by the stepping threads
+        bool record(TrajectoryRecorder& recorder)
+        {
+            const std::size_t count = vec.getNumEnvs();
+            double* records = recorder.beginRecords(count);
+            if (!records) return false;
+            const int recordDoubles = recorder.getRecordDoubles();
+            vec.getThreadPool().parallelFor(count, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    TrajectoryRecorder::writeRecord(records + i * recordDoubles,
+                        static_cast<std::uint32_t>(i), vec.getEnv(i));
+                }
+                });
+            recorder.commitRecords(count);
+            return true;
+        }
+
+        VecEnv vec;
+        std::vector<double> observations, actions, rewards;
+        std::vector<std::uint8_t> terminated, truncated;
+    };
+
+    void measureReplay(const char* path, std::size_t numEnvs, double dt)
+    {
+        auto start = Clock::now();
+        TrajectoryReader reader;
+        if (!reader.open(path)) return;
+        double openSeconds = seconds(start);
+
+        // Every step recorded all environments: sample n of source s is record n * numEnvs + s
+        const int seeks = 100000;
+        std::uint64_t state = 17;
+        long long wrongSamples = 0;
+        long long wrongTimes = 0;
+        start = Clock::now();
+        for (int i = 0; i < seeks; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const int source = static_cast<int>((state >> 33) % numEnvs);
+            const std::uint64_t sample = (state >> 13) % reader.getSampleCount(source);
+            wrongSamples += reader.getSample(source, sample) != reader.getRecord(sample * numEnvs + source);
+            wrongTimes += reader.findSample(source, (sample + 0.5) * dt) != sample;
+        }
+        double seekSeconds = seconds(start);
+
+        std::cout << "\nreplay index: " << reader.getRecordCount() << " records, " << reader.getSourceCount()
+            << " streams, built in " << std::setprecision(1) << openSeconds * 1e3 << " ms\n"
+            << "random seeks: " << std::setprecision(2) << seekSeconds / seeks * 1e6
+            << " us per sample + time lookup, " << wrongSamples << " wrong samples, "
+            << wrongTimes << " wrong time lookups\n";
+    }
+
+    void printRow(const char* label, double records, double elapsed, double bytesPerRecord)
+    {
+        std::cout << std::left << std::setw(24) << label << std::right << std::fixed
+            << std::setw(16) << std::setprecision(0) << records / elapsed
+            << std::setw(12) << std::setprecision(0) << records * bytesPerRecord / elapsed / (1 << 20) << "\n";
+    }
+
+    bool verify(const char* path, const Batch& batch, std::uint64_t expectedRecords)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        const std::streamoff fileBytes = file.tellg();
+        file.seekg(0);
+        TrajectoryFileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        const std::size_t numEnvs = batch.vec.getNumEnvs();
+        const int recordDoubles = TrajectoryRecorder::getRecordDoubles(1);
+        std::vector<double> last(numEnvs * recordDoubles);
+        file.seekg(fileBytes - static_cast<std::streamoff>(last.size() * sizeof(double)));
+        file.read(reinterpret_cast<char*>(last.data()), last.size() * sizeof(double));
+
+        std::vector<double> expected(recordDoubles);
+        bool ok = file && std::memcmp(header.magic, "PTRJ", 4) == 0
+            && header.recordCount == expectedRecords
+            && fileBytes == static_cast<std::streamoff>(sizeof(header) + expectedRecords * recordDoubles * sizeof(double));
+        for (std::size_t i = 0; ok && i < numEnvs; ++i) {
+            TrajectoryRecorder::writeRecord(expected.data(), static_cast<std::uint32_t>(i), batch.vec.getEnv(i));
+            ok = std::memcmp(expected.data(), &last[i * recordDoubles], recordDoubles * sizeof(double)) == 0;
+        }
+        return ok;
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t numEnvs = 4096;
+    const int steps = 500;
+    const char* path = "trajectory_benchmark.ptrj";
+    const char* csvPath = "trajectory_benchmark.csv";
+    const double recordBytes = TrajectoryRecorder::getRecordDoubles(1) * sizeof(double);
+    const double totalRecords = static_cast<double>(numEnvs) * steps;
+
+    Batch batch(numEnvs, 1, hardwareThreads);
+    std::cout << "single pendulum, " << numEnvs << " envs x " << steps << " steps, "
+        << batch.vec.getNumThreads() << " threads, " << recordBytes << " bytes / record\n\n"
+        << std::left << std::setw(24) << "mode" << std::right << std::setw(16) << "records/s"
+        << std::setw(12) << "MiB/s" << "\n";
+
+    auto start = Clock::now();
+    for (int step = 0; step < steps; ++step) batch.step(step);
+    printRow("step only", totalRecords, seconds(start), recordBytes);
+
+    TrajectoryRecorder recorder;
+    if (!recorder.open(path, 1, 1.0 / 144.0)) return 1;
+    start = Clock::now();
+    for (int step = 0; step < steps; ++step) {
+        batch.step(step);
+        if (!batch.record(recorder)) return 1;
+    }
+    printRow("step + record", totalRecords, seconds(start), recordBytes);
+
+    start = Clock::now();
+    for (int step = 0; step < steps; ++step) {
+        if (!batch.record(recorder)) return 1;
+    }
+    printRow("record only", totalRecords, seconds(start), recordBytes);
+    recorder.close();
+    bool ok = verify(path, batch, static_cast<std::uint64_t>(2 * totalRecords));
+
+    // Baseline: the same records as formatted CSV (a tenth of the steps)
+    const int csvSteps = steps / 10;
+    std::ofstream csv(csvPath);
+    start = Clock::now();
+    std::vector<double> record(TrajectoryRecorder::getRecordDoubles(1));
+    for (int step = 0; step < csvSteps; ++step) {
+        for (std::size_t i = 0; i < numEnvs; ++i) {
+            TrajectoryRecorder::writeRecord(record.data(), static_cast<std::uint32_t>(i), batch.vec.getEnv(i));
+            for (std::size_t column = 0; column < record.size(); ++column) {
+                csv << record[column] << (column + 1 < record.size() ? ',' : '\n');
+            }
+        }
+    }
+    csv.flush();
+    printRow("ofstream CSV", static_cast<double>(numEnvs) * csvSteps, seconds(start), recordBytes);
+    csv.close();
+
+    measureReplay(path, numEnvs, 1.0 / 144.0);
+    std::cout << "\nread back: " << (ok ? "header and last batch match" : "MISMATCH") << "\n";
+    std::remove(path);
+    std::remove(csvPath);
+    return ok ? 0 : 1;
+}
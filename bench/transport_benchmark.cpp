@@ -0,0 +1,176 @@
+#include "EnvTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * Transport benchmark - shared-memory round-trip latency between processes
+ *
+ * 1. Ring ping-pong: a forked child echoes 64-byte messages over two
+ *    SharedRings; reports round-trip latency with futex-only waits and
+ *    with spinning first.
+ * 2. Environment round trip: the parent serves a VecEnv (single-threaded,
+ *    so fork() copies no worker threads) with EnvServer and a forked
+ *    EnvClient steps it; reports the per-step round trip next to the cost
+ *    of calling VecEnv::step() in-process, and the difference (the IPC
+ *    overhead per batch).
+ */
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Latency
+    {
+        double mean, p50, p99;
+    };
+
+    Latency summarize(std::vector<double>& samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double sample : samples) sum += sample;
+        return { sum / samples.size(), samples[samples.size() / 2], samples[samples.size() * 99 / 100] };
+    }
+
+    std::string segmentName(const char* tag)
+    {
+        return std::string("/pendulum_bench_") + tag + "_" + std::to_string(getpid());
+    }
+
+    void ringPingPong(int spins, int roundTrips)
+    {
+        constexpr std::size_t MESSAGE_BYTES = 64;
+        const std::size_t ringBytes = SharedRing::getRequiredBytes(2, MESSAGE_BYTES);
+        SharedMemorySegment segment;
+        if (!segment.create(segmentName("ring"), 2 * ringBytes)) return;
+
+        auto* base = static_cast<unsigned char*>(segment.getData());
+        SharedRing ping(base, 2, MESSAGE_BYTES);
+        SharedRing pong(base + ringBytes, 2, MESSAGE_BYTES);
+        ping.initialize();
+        pong.initialize();
+        ping.setSpinCount(spins);
+        pong.setSpinCount(spins);
+        ping.attachWriter();
+        pong.attachReader();
+
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            ping.attachReader();
+            pong.attachWriter();
+            for (int i = 0; i < roundTrips; ++i) {
+                const void* in = ping.beginRead();
+                std::copy_n(static_cast<const unsigned char*>(in), MESSAGE_BYTES, static_cast<unsigned char*>(pong.beginWrite()));
+                ping.endRead();
+                pong.endWrite();
+            }
+            _exit(0);
+        }
+
+        std::vector<double> samples(roundTrips);
+        for (int i = 0; i < roundTrips; ++i) {
+            auto start = Clock::now();
+            *static_cast<int*>(ping.beginWrite()) = i;
+            ping.endWrite();
+            pong.beginRead();
+            pong.endRead();
+            samples[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        }
+        waitpid(child, nullptr, 0);
+
+        Latency latency = summarize(samples);
+        std::cout << std::setw(10) << spins << std::fixed << std::setprecision(2)
+            << std::setw(12) << latency.mean << std::setw(12) << latency.p50 << std::setw(12) << latency.p99 << "\n";
+    }
+
+    void envRoundTrip(int numLinks, std::size_t numEnvs, int spins, int steps)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = numLinks;
+        config.substeps = 1;
+        VecEnv vec(numEnvs, config, 1);
+
+        // In-process baseline
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(numEnvs * obsSize), finalObservations(numEnvs * obsSize);
+        std::vector<double> actions(numEnvs), rewards(numEnvs);
+        std::vector<std::uint8_t> terminated(numEnvs), truncated(numEnvs);
+        vec.reset(3, observations.data());
+        auto start = Clock::now();
+        for (int step = 0; step < steps; ++step) {
+            std::fill(actions.begin(), actions.end(), std::sin(0.05 * step));
+            vec.step(actions.data(), observations.data(), rewards.data(), terminated.data(), truncated.data(),
+                finalObservations.data());
+        }
+        double inProcess = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / steps;
+
+        std::string name = segmentName("env");
+        EnvServer server(vec);
+        if (!server.create(name)) return;
+        server.setSpinCount(spins);
+
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            EnvClient client;
+            if (!client.open(name)) _exit(1);
+            client.setSpinCount(spins);
+
+            client.reset(3);
+            std::vector<double> samples(steps);
+            for (int step = 0; step < steps; ++step) {
+                auto begin = Clock::now();
+                double* buffer = client.getActionBuffer();
+                std::fill(buffer, buffer + numEnvs, std::sin(0.05 * step));
+                client.step();
+                samples[step] = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+            }
+            client.close();
+
+            Latency latency = summarize(samples);
+            std::cout << std::setw(6) << numLinks << std::setw(8) << numEnvs << std::setw(8) << spins
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << inProcess << std::setw(12) << latency.mean << std::setw(12) << latency.p50
+                << std::setw(12) << latency.p99 << std::setw(12) << latency.mean - inProcess << std::endl;
+            _exit(0);
+        }
+
+        server.serve();
+        waitpid(child, nullptr, 0);
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "hardware threads: " << hardwareThreads << "\n\nring ping-pong, 64-byte messages (us)\n";
+    std::cout << std::setw(10) << "spins" << std::setw(12) << "mean" << std::setw(12) << "p50"
+        << std::setw(12) << "p99" << std::endl;
+    for (int spins : { 0, 20000 }) {
+        ringPingPong(spins, 20000);
+    }
+
+    std::cout << "\nenvironment round trip per batch step (us)\n";
+    std::cout << std::setw(6) << "links" << std::setw(8) << "envs" << std::setw(8) << "spins"
+        << std::setw(12) << "in-process" << std::setw(12) << "rt mean" << std::setw(12) << "rt p50"
+        << std::setw(12) << "rt p99" << std::setw(12) << "overhead" << std::endl;
+    for (int numLinks = 1; numLinks <= 2; ++numLinks) {
+        for (std::size_t numEnvs : { 1, 64, 1024 }) {
+            for (int spins : { 0, 20000 }) {
+                envRoundTrip(numLinks, numEnvs, spins, 5000);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "VecEnv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <vector>
+
+/**
+ * VecEnv benchmark - batched stepping throughput vs. thread count
+ *
+ * Steps numEnvs environments with an open-loop action pattern for a fixed
+ * number of batch steps, for several thread counts. Reports environment
+ * steps per second, heap allocations made while stepping, and a checksum
+ * of the final observations (identical for every thread count).
+ */
+
+namespace
+{
+    std::atomic<long long> g_allocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    void run(int numLinks, std::size_t numEnvs, int numThreads, int batchSteps)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = numLinks;
+        config.substeps = 1;
+        VecEnv vec(numEnvs, config, numThreads);
+
+        const int obsSize = vec.getObservationSize();
+        std::vector<double> observations(numEnvs * obsSize);
+        std::vector<double> finalObservations(numEnvs * obsSize);
+        std::vector<double> actions(numEnvs);
+        std::vector<double> rewards(numEnvs);
+        std::vector<std::uint8_t> terminated(numEnvs);
+        std::vector<std::uint8_t> truncated(numEnvs);
+
+        vec.reset(7, observations.data());
+        long long allocationsBefore = g_allocations.load();
+        long long episodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < batchSteps; ++step) {
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                actions[env] = std::sin(0.05 * step + 0.1 * static_cast<double>(env));
+            }
+            vec.step(actions.data(), observations.data(), rewards.data(),
+                terminated.data(), truncated.data(), finalObservations.data());
+            for (std::size_t env = 0; env < numEnvs; ++env) {
+                episodes += terminated[env] | truncated[env];
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long allocations = g_allocations.load() - allocationsBefore;
+
+        double checksum = 0.0;
+        for (double value : observations) checksum += value;
+
+        std::cout << std::setw(6) << numLinks << std::setw(8) << numEnvs << std::setw(9) << vec.getNumThreads()
+            << std::setw(14) << std::fixed << std::setprecision(0) << numEnvs * static_cast<double>(batchSteps) / seconds
+            << std::setw(10) << episodes << std::setw(10) << allocations
+            << std::setw(22) << std::setprecision(12) << checksum << "\n";
+    }
+}
+
+int main()
+{
+    const int hardwareThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "hardware threads: " << hardwareThreads << "\n";
+    std::cout << std::setw(6) << "links" << std::setw(8) << "envs" << std::setw(9) << "threads"
+        << std::setw(14) << "env-steps/s" << std::setw(10) << "episodes" << std::setw(10) << "allocs"
+        << std::setw(22) << "obs checksum" << "\n";
+
+    for (int numLinks = 1; numLinks <= 2; ++numLinks) {
+        for (std::size_t numEnvs : { 1024, 4096 }) {
+            std::vector<int> threadCounts = { 1, 2, 4 };
+            if (hardwareThreads > 4) threadCounts.push_back(hardwareThreads);
+            for (int numThreads : threadCounts) {
+                run(numLinks, numEnvs, numThreads, 200);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "BatchCartPendulum.h"
+#include "SimdDispatch.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Rows are padded for the widest kernel copy, whichever one runs
+    template <typename Scalar>
+    constexpr std::size_t BLOCK_LANES = SIMD_MAX_BYTES / sizeof(Scalar);
+
+    template <typename Scalar>
+    const BatchKernels<Scalar>& getBatchKernels();
+
+    template <>
+    const BatchKernels<double>& getBatchKernels<double>() { return getSimdKernels().batchDouble; }
+
+    template <>
+    const BatchKernels<float>& getBatchKernels<float>() { return getSimdKernels().batchFloat; }
+}
+
+template <typename Scalar>
+BasicBatchCartPendulum<Scalar>::BasicBatchCartPendulum(std::size_t numEnvs, int numLinks)
+    : m_numEnvs(numEnvs)
+    , m_stride((numEnvs + BLOCK_LANES<Scalar> - 1) / BLOCK_LANES<Scalar> * BLOCK_LANES<Scalar>)
+    , m_numLinks(numLinks == 2 ? 2 : 1)
+    , m_cartState(2 * m_stride, Scalar(0))
+    , m_pendulumState(4 * m_stride, Scalar(0))
+    , m_appliedAcceleration(m_stride, Scalar(0))
+    , m_effectiveAcceleration(m_stride, Scalar(0))
+    , m_parameters(static_cast<std::size_t>(BatchParameter::COUNT) * m_stride, Scalar(0))
+{
+    setGravity(9.81);
+    setDamping(0.1);
+    setRailLength(10.0);
+    setCartMass(1.0);
+    for (int link = 0; link < 2; ++link) {
+        setMass(link, 1.0);
+        setLength(link, 1.0);
+        setInitialAngle(link, 0.0);
+    }
+}
+
+template <typename Scalar>
+int BasicBatchCartPendulum<Scalar>::getLaneWidth()
+{
+    return getBatchKernels<Scalar>().width;
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::fillParameter(BatchParameter parameter, double value)
+{
+    Scalar* row = getParameterRow(parameter);
+    std::fill(row, row + m_stride, static_cast<Scalar>(value));
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::update(double dt, const Scalar* appliedAcceleration)
+{
+    std::copy(appliedAcceleration, appliedAcceleration + m_numEnvs, m_appliedAcceleration.begin());
+
+    updateCarts(dt);
+    updatePendulums(dt);
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::updateCarts(double dt)
+{
+    const Scalar* railLength = getParameterRow(BatchParameter::RAIL_LENGTH);
+
+    getBatchKernels<Scalar>().stepCarts(dt, m_cartState.data(), m_stride,
+        m_appliedAcceleration.data(), static_cast<Scalar>(m_friction));
+
+    // Rail bounds, mirroring Cart::update for every environment
+    Scalar* position = m_cartState.data();
+    Scalar* velocity = m_cartState.data() + m_stride;
+    for (std::size_t env = 0; env < m_numEnvs; ++env) {
+        Scalar accel = m_appliedAcceleration[env];
+        const Scalar halfRail = railLength[env] / Scalar(2);
+        bool blocked = false;
+        if (m_wrapEnabled) {
+            while (position[env] < -halfRail) position[env] += railLength[env];
+            while (position[env] > halfRail) position[env] -= railLength[env];
+        }
+        else {
+            if (position[env] < -halfRail) {
+                position[env] = -halfRail;
+                velocity[env] = 0.0;
+                blocked = true;
+            }
+            if (position[env] > halfRail) {
+                position[env] = halfRail;
+                velocity[env] = 0.0;
+                blocked = true;
+            }
+        }
+
+        // Pushing into a rail end: the reaction force cancels the acceleration
+        if (blocked && ((position[env] <= -halfRail && accel < 0.0) ||
+            (position[env] >= halfRail && accel > 0.0))) {
+            accel = 0.0;
+        }
+        m_effectiveAcceleration[env] = accel;
+    }
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::updatePendulums(double dt)
+{
+    BatchPendulumRows<Scalar> rows;
+    rows.cartAcceleration = m_effectiveAcceleration.data();
+    rows.gravity = getParameterRow(BatchParameter::GRAVITY);
+    rows.damping = getParameterRow(BatchParameter::DAMPING);
+    rows.mass1 = getParameterRow(BatchParameter::MASS1);
+    rows.mass2 = getParameterRow(BatchParameter::MASS2);
+    rows.length1 = getParameterRow(BatchParameter::LENGTH1);
+    rows.length2 = getParameterRow(BatchParameter::LENGTH2);
+
+    getBatchKernels<Scalar>().stepPendulums(dt, m_pendulumState.data(), m_stride, m_numLinks, rows);
+
+    // Normalize angles and snap settled pendulums to rest, as the scalar
+    // pendulum classes do after every step
+    const Scalar ANGLE_EPS = static_cast<Scalar>(1e-6);
+    const Scalar VEL_EPS = static_cast<Scalar>(1e-6);
+    for (std::size_t env = 0; env < m_numEnvs; ++env) {
+        bool settled = true;
+        for (int link = 0; link < m_numLinks; ++link) {
+            Scalar& angle = m_pendulumState[(2 * link) * m_stride + env];
+            Scalar angVel = m_pendulumState[(2 * link + 1) * m_stride + env];
+            angle = normalizeAngle(angle);
+            settled = settled && std::abs(angVel) < VEL_EPS && std::abs(angle) < ANGLE_EPS;
+        }
+        if (settled) {
+            for (int link = 0; link < m_numLinks; ++link) {
+                m_pendulumState[(2 * link) * m_stride + env] = Scalar(0);
+                m_pendulumState[(2 * link + 1) * m_stride + env] = Scalar(0);
+            }
+        }
+    }
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::reset()
+{
+    for (std::size_t env = 0; env < m_numEnvs; ++env) {
+        reset(env);
+    }
+}
+
+template <typename Scalar>
+void BasicBatchCartPendulum<Scalar>::reset(std::size_t env)
+{
+    setCartPosition(env, Scalar(0));
+    setCartVelocity(env, Scalar(0));
+    for (int link = 0; link < m_numLinks; ++link) {
+        setAngle(env, link, getParameter(env, linkParameter(BatchParameter::INITIAL_ANGLE1, link)));
+        setAngularVelocity(env, link, Scalar(0));
+    }
+}
+
+template <typename Scalar>
+Scalar BasicBatchCartPendulum<Scalar>::normalizeAngle(Scalar angle)
+{
+    const Scalar PI = static_cast<Scalar>(3.14159265358979323846);
+    const Scalar TWO_PI = static_cast<Scalar>(2.0 * 3.14159265358979323846);
+    // A diverged state (e.g. a too-coarse integrator) must not spin the loops below
+    if (!std::isfinite(angle)) return angle;
+    if (std::abs(angle) > 32 * TWO_PI) angle = std::remainder(angle, TWO_PI);
+    while (angle > PI) angle -= TWO_PI;
+    while (angle < -PI) angle += TWO_PI;
+    return angle;
+}
+
+template class BasicBatchCartPendulum<double>;
+template class BasicBatchCartPendulum<float>;
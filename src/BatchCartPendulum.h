@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Rows of the per-environment parameter table
+enum class BatchParameter
+{
+    GRAVITY,
+    DAMPING,
+    RAIL_LENGTH,
+    CART_MASS,          // carried for logging: the cart is acceleration-driven
+    MASS1,
+    MASS2,
+    LENGTH1,
+    LENGTH2,
+    INITIAL_ANGLE1,
+    INITIAL_ANGLE2,
+    COUNT
+};
+
+/**
+ * BatchCartPendulum - many independent cart + pendulum systems stepped in lockstep
+ *
+ * Each environment is a Cart with a SinglePendulum (numLinks = 1) or a
+ * DoublePendulum (numLinks = 2) and follows exactly the per-tick sequence of
+ * the interactive loop: the cart is integrated first, clamped to the rail, and
+ * the resulting effective acceleration drives the pendulum. State is kept
+ * structure-of-arrays and integrated with BatchODESolver, one environment per
+ * SIMD lane. The integration kernels are picked at runtime for the CPU
+ * (SimdDispatch.h); rows are padded for the widest of them, so the level can
+ * change between updates.
+ *
+ * Physical parameters are structure-of-arrays too: one row of m_stride
+ * values per BatchParameter, loaded lane-wise by the derivative functions,
+ * so every environment can carry its own masses, lengths, gravity, damping
+ * and rail (see DomainRandomizer). The shared setters broadcast one value
+ * to every lane.
+ *
+ * Scalar is the state precision: BatchCartPendulum (double) matches the
+ * scalar classes; BatchCartPendulumFloat fits twice as many environments
+ * per SIMD register, at float accuracy (see bench/precision_benchmark.cpp).
+ */
+template <typename Scalar>
+class BasicBatchCartPendulum
+{
+public:
+    BasicBatchCartPendulum(std::size_t numEnvs, int numLinks);
+
+    // Physics update for every environment. appliedAcceleration holds one
+    // value per environment (numEnvs entries).
+    void update(double dt, const Scalar* appliedAcceleration);
+
+    // Reset to the centre of the rail at each environment's initial angles
+    void reset();
+    void reset(std::size_t env);
+
+    std::size_t getNumEnvs() const { return m_numEnvs; }
+    int getNumLinks() const { return m_numLinks; }
+    // Environments per SIMD register in the kernels update() runs now
+    static int getLaneWidth();
+
+    // Per-environment state
+    Scalar getCartPosition(std::size_t env) const { return m_cartState[env]; }
+    Scalar getCartVelocity(std::size_t env) const { return m_cartState[m_stride + env]; }
+    Scalar getAngle(std::size_t env, int link) const { return m_pendulumState[(2 * link) * m_stride + env]; }
+    Scalar getAngularVelocity(std::size_t env, int link) const { return m_pendulumState[(2 * link + 1) * m_stride + env]; }
+    // Acceleration that actually reached the pendulum in the last update
+    // (zero where the cart was blocked at a rail end)
+    Scalar getEffectiveAcceleration(std::size_t env) const { return m_effectiveAcceleration[env]; }
+
+    void setCartPosition(std::size_t env, Scalar pos) { m_cartState[env] = pos; }
+    void setCartVelocity(std::size_t env, Scalar vel) { m_cartState[m_stride + env] = vel; }
+    void setAngle(std::size_t env, int link, Scalar angle) { m_pendulumState[(2 * link) * m_stride + env] = angle; }
+    void setAngularVelocity(std::size_t env, int link, Scalar vel) { m_pendulumState[(2 * link + 1) * m_stride + env] = vel; }
+
+    // Physical parameters for every environment (same meaning as the Cart /
+    // Pendulum setters)
+    void setFriction(double f) { m_friction = f; }
+    void setGravity(double g) { fillParameter(BatchParameter::GRAVITY, g); }
+    void setDamping(double d) { fillParameter(BatchParameter::DAMPING, d); }
+    void setRailLength(double len) { fillParameter(BatchParameter::RAIL_LENGTH, len); }
+    void setCartMass(double m) { fillParameter(BatchParameter::CART_MASS, m); }
+    void setWrapEnabled(bool enabled) { m_wrapEnabled = enabled; }
+    void setMass(int link, double m) { fillParameter(linkParameter(BatchParameter::MASS1, link), m); }
+    void setLength(int link, double l) { fillParameter(linkParameter(BatchParameter::LENGTH1, link), l); }
+    void setInitialAngle(int link, double angle) { fillParameter(linkParameter(BatchParameter::INITIAL_ANGLE1, link), angle); }
+
+    // Per-environment parameters. A row holds getStride() values; entries
+    // past getNumEnvs() are padding lanes and should keep sane values.
+    std::size_t getStride() const { return m_stride; }
+    Scalar* getParameterRow(BatchParameter parameter) { return &m_parameters[static_cast<std::size_t>(parameter) * m_stride]; }
+    const Scalar* getParameterRow(BatchParameter parameter) const { return &m_parameters[static_cast<std::size_t>(parameter) * m_stride]; }
+    Scalar getParameter(std::size_t env, BatchParameter parameter) const { return getParameterRow(parameter)[env]; }
+    void setParameter(std::size_t env, BatchParameter parameter, Scalar value) { getParameterRow(parameter)[env] = value; }
+
+    static BatchParameter linkParameter(BatchParameter first, int link)
+    {
+        return static_cast<BatchParameter>(static_cast<int>(first) + link);
+    }
+
+private:
+    std::size_t m_numEnvs;
+    std::size_t m_stride;   // numEnvs rounded up to a whole number of SIMD_MAX_BYTES blocks
+    int m_numLinks;
+
+    // SoA state, m_stride doubles per row. Padding lanes are integrated
+    // along with the rest but never exposed.
+    std::vector<Scalar> m_cartState;              // [position | velocity]
+    std::vector<Scalar> m_pendulumState;          // [angle1 | angVel1 | angle2 | angVel2]
+    std::vector<Scalar> m_appliedAcceleration;
+    std::vector<Scalar> m_effectiveAcceleration;
+    std::vector<Scalar> m_parameters;             // BatchParameter rows
+
+    double m_friction = 0.1;
+    bool m_wrapEnabled = false;
+
+    void fillParameter(BatchParameter parameter, double value);
+    void updateCarts(double dt);
+    void updatePendulums(double dt);
+    static Scalar normalizeAngle(Scalar angle);
+};
+
+using BatchCartPendulum = BasicBatchCartPendulum<double>;
+using BatchCartPendulumFloat = BasicBatchCartPendulum<float>;
+
+// Instantiated in BatchCartPendulum.cpp
+extern template class BasicBatchCartPendulum<double>;
+extern template class BasicBatchCartPendulum<float>;
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "DormandPrince87.h"
+#include "SimdFloat.h"
+#include <cstddef>
+
+/**
+ * BatchODESolver - Dormand-Prince 8(7) over many independent systems at once
+ *
+ * The state is stored structure-of-arrays: component i of environment e lives
+ * at state[i * stride + e], with stride a multiple of Pack::WIDTH. Each
+ * block of WIDTH environments is loaded into SIMD registers and carried
+ * through all 13 stages before being written back, one environment per lane.
+ *
+ * The derivative functor sees one block at a time:
+ *
+ *     void deriv(double t, const Pack (&state)[N], Pack (&dstate)[N],
+ *                std::size_t lane);
+ *
+ * where lane is the index of the block's first environment, so per-env
+ * inputs can be loaded with Pack::load(input + lane). Pack is SimdDouble or
+ * SimdFloat; the state array holds Pack::Scalar.
+ */
+template <int N, typename Pack = SimdDouble>
+class BatchODESolver
+{
+public:
+    using Scalar = typename Pack::Scalar;
+
+    /**
+     * Fixed step (no adaptation) for every environment
+     *
+     * @param t Current time
+     * @param state SoA state, N rows of stride doubles, advanced in place
+     * @param stride Row length; must be a multiple of Pack::WIDTH
+     * @param deriv Functor computing one block's derivative
+     * @param dt Time step
+     */
+    template <typename Derivative>
+    void stepFixed(double t, Scalar* state, std::size_t stride,
+        const Derivative& deriv, double dt);
+
+private:
+    static constexpr int STAGES = DormandPrince87::STAGES;
+};
+
+template <int N, typename Pack>
+template <typename Derivative>
+void BatchODESolver<N, Pack>::stepFixed(double t, Scalar* state, std::size_t stride,
+    const Derivative& deriv, double dt)
+{
+    // Scale the tableau once per step; broadcasts then come straight from here
+    Scalar dtA[STAGES][STAGES];
+    Scalar dtB[STAGES];
+    for (int stage = 0; stage < STAGES; ++stage) {
+        for (int j = 0; j < STAGES; ++j) {
+            dtA[stage][j] = static_cast<Scalar>(dt * DormandPrince87::a[stage][j]);
+        }
+        dtB[stage] = static_cast<Scalar>(dt * DormandPrince87::b8[stage]);
+    }
+
+    for (std::size_t lane = 0; lane < stride; lane += Pack::WIDTH) {
+        Pack y[N];
+        for (int i = 0; i < N; ++i) {
+            y[i] = Pack::load(state + i * stride + lane);
+        }
+
+        Pack k[STAGES][N];
+        Pack tempState[N];
+
+        for (int stage = 0; stage < STAGES; ++stage) {
+            for (int i = 0; i < N; ++i) {
+                tempState[i] = y[i];
+                for (int j = 0; j < stage; ++j) {
+                    // Zero entries are compile-time constants once unrolled
+                    if (DormandPrince87::a[stage][j] != 0.0) {
+                        tempState[i] = tempState[i] + Pack(dtA[stage][j]) * k[j][i];
+                    }
+                }
+            }
+
+            double t_stage = t + DormandPrince87::c[stage] * dt;
+            deriv(t_stage, tempState, k[stage], lane);
+        }
+
+        // Apply 8th order solution
+        for (int i = 0; i < N; ++i) {
+            for (int stage = 0; stage < STAGES; ++stage) {
+                if (DormandPrince87::b8[stage] != 0.0) {
+                    y[i] = y[i] + Pack(dtB[stage]) * k[stage][i];
+                }
+            }
+            y[i].store(state + i * stride + lane);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "Cart.h"
-#include "ODESolver.h"
+#include "Integrators.h"
+#include "PendulumDynamics.h"
 #include <algorithm>
 #include <cmath>
 
@@ -16,26 +17,21 @@ Cart::Cart(double mass, double railLength)
 double Cart::update(double dt, double appliedAcceleration, double friction, double gravity)
 {
     // Note: gravity parameter is here for consistency but doesn't affect horizontal cart motion
-    // Use Dormand-Prince RK8 solver for smooth cart motion
-    static ODESolver solver;
+    // Integrate with the selected integrator (Dormand-Prince RK8 by default)
+    using Solver = IntegratorSet<2>;
 
     // State vector: [position, velocity]
-    std::vector<double> state = { m_position, m_velocity };
+    Solver::State state = { m_position, m_velocity };
 
     // Derivative function
-    auto derivFunc = [appliedAcceleration, friction](double t, const std::vector<double>& s) -> std::vector<double> {
-        double pos = s[0];
-        double vel = s[1];
-
-        // Acceleration = applied - friction
-        double frictionAccel = -friction * vel;
-        double totalAccel = appliedAcceleration + frictionAccel;
-
-        return { vel, totalAccel };
+    auto derivFunc = [appliedAcceleration, friction](double t, const Solver::State& s, Solver::State& ds) {
+        // Acceleration = applied - friction (see PendulumDynamics.h)
+        ds[0] = s[1];
+        ds[1] = PendulumDynamics::cartAcceleration(s[1], appliedAcceleration, friction);
         };
 
     // Take one step
-    solver.stepFixed(0.0, state, derivFunc, dt);
+    m_solver.stepFixed(m_integrator, 0.0, state, derivFunc, dt);
 
     // Update state
     m_position = state[0];
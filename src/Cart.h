@@ -1,10 +1,14 @@
 #pragma once
 
+#include "Integrators.h"
+
 /**
  * Cart class - represents the movable cart on a rail
  *
  * The cart slides left/right along a fixed-length rail.
  * It has mass, position, velocity, and can have forces applied to it.
+ * Each cart owns its integrator workspace, so different carts can be
+ * updated concurrently from different threads.
  */
 class Cart
 {
@@ -42,6 +46,10 @@ public:
     void setWrapEnabled(bool enabled) { m_wrapEnabled = enabled; }
     bool isWrapEnabled() const { return m_wrapEnabled; }
 
+    // Integrator used by update() (default: Dormand-Prince 8(7))
+    void setIntegrator(IntegratorType type) { m_integrator = type; }
+    IntegratorType getIntegrator() const { return m_integrator; }
+
 private:
     double m_mass;        // Cart mass (kg)
     double m_position;    // Position along rail (m)
@@ -50,6 +58,10 @@ private:
     double m_width = WIDTH;   // visual width (m)
     double m_height = HEIGHT; // visual height (m)
     bool m_wrapEnabled = false;
+    IntegratorType m_integrator = IntegratorType::DormandPrince87;
+
+    // Integrator workspace (per instance)
+    IntegratorSet<2> m_solver;
 
     // Constants (defaults)
     static constexpr double WIDTH = 0.4;   // Default cart width (m) for rendering
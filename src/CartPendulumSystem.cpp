@@ -0,0 +1,226 @@
+#include "CartPendulumSystem.h"
+#include <algorithm>
+#include <cmath>
+
+CartPendulumSystem::CartPendulumSystem(Cart& cart, Pendulum& pendulum)
+    : m_cart(cart)
+    , m_pendulum(pendulum)
+{
+}
+
+double CartPendulumSystem::update(double dt, double appliedAcceleration, double friction)
+{
+    m_appliedAcceleration = appliedAcceleration;
+    m_friction = friction;
+
+    // Only one- and two-link pendulums have a coupled model; longer chains
+    // keep the prescribed-acceleration path
+    const int links = m_pendulum.getNumAngles();
+    if (links > 2) {
+        double effectiveAcceleration = m_cart.update(dt, appliedAcceleration, friction, m_pendulum.getGravity());
+        m_pendulum.update(dt, effectiveAcceleration);
+        return effectiveAcceleration;
+    }
+
+    // Link j carries all mass at or beyond it
+    const double damping = m_pendulum.getDamping();
+    m_cartMass = m_cart.getMass();
+    m_gravity = m_pendulum.getGravity();
+    double totalMass = m_cartMass;
+    double outer = 0.0;
+    for (int link = links - 1; link >= 0; --link) {
+        double mass = m_pendulum.getLinkMass(link);
+        outer += mass;
+        totalMass += mass;
+        m_outerMass[link] = outer;
+        m_length[link] = m_pendulum.getLinkLength(link);
+        // SinglePendulum's damping term is per unit bob mass, DoublePendulum's is not
+        m_dampingScale[link] = damping * ((links == 1) ? mass * m_length[link] : m_length[link]);
+    }
+
+    m_inverseTotalMass = 1.0 / totalMass;
+
+    if (links == 1) {
+        return step<1>(dt, m_singleSolver);
+    }
+    return step<2>(dt, m_doubleSolver);
+}
+
+template <int LINKS>
+double CartPendulumSystem::step(double dt, IntegratorSet<2 * (LINKS + 1)>& solver)
+{
+    using State = std::array<double, 2 * (LINKS + 1)>;
+
+    // State vector: [x, v, theta1, omega1, (theta2, omega2)]
+    State state;
+    state[0] = m_cart.getPosition();
+    state[1] = m_cart.getVelocity();
+    for (int link = 0; link < LINKS; ++link) {
+        state[2 + 2 * link] = m_pendulum.getAngle(link);
+        state[3 + 2 * link] = m_pendulum.getAngularVelocity(link);
+    }
+
+    // A cart resting against a rail end stays there for the whole step while
+    // the coupled dynamics push it further out
+    double halfRail = m_cart.getRailLength() / 2.0;
+    m_cartHeld = false;
+    if (!m_cart.isWrapEnabled() && std::abs(state[0]) >= halfRail) {
+        State ds;
+        computeDerivative<LINKS>(state, ds, false);
+        double outward = (state[0] > 0.0) ? 1.0 : -1.0;
+        if (outward * state[1] >= 0.0 && outward * ds[1] > 0.0) {
+            m_cartHeld = true;
+            state[0] = outward * halfRail;
+            state[1] = 0.0;
+        }
+    }
+
+    auto derivFunc = [this](double t, const State& s, State& ds) {
+        computeDerivative<LINKS>(s, ds, m_cartHeld);
+        };
+
+    // One integrator call for cart and pendulum together
+    solver.stepFixed(m_pendulum.getIntegrator(), 0.0, state, derivFunc, dt);
+
+    // Clamp position to rail bounds, as Cart::update does
+    double position = state[0];
+    double velocity = state[1];
+    bool blocked = m_cartHeld;
+    if (m_cart.isWrapEnabled()) {
+        while (position < -halfRail) position += m_cart.getRailLength();
+        while (position > halfRail) position -= m_cart.getRailLength();
+    }
+    else {
+        if (position < -halfRail) {
+            position = -halfRail;
+            velocity = 0.0;
+            blocked = true;
+        }
+        if (position > halfRail) {
+            position = halfRail;
+            velocity = 0.0;
+            blocked = true;
+        }
+    }
+    m_cart.setPosition(position);
+    m_cart.setVelocity(velocity);
+
+    // Keep angles in [-pi, pi] and snap a settled pendulum to rest, as the
+    // pendulum classes do after every step
+    const double ANGLE_EPS = 1e-6;
+    const double VEL_EPS = 1e-6;
+    bool settled = true;
+    for (int link = 0; link < LINKS; ++link) {
+        state[2 + 2 * link] = normalizeAngle(state[2 + 2 * link]);
+        settled = settled && std::abs(state[3 + 2 * link]) < VEL_EPS &&
+            std::abs(state[2 + 2 * link]) < ANGLE_EPS;
+    }
+    for (int link = 0; link < LINKS; ++link) {
+        if (settled) {
+            m_pendulum.setLinkState(link, 0.0, 0.0);
+        }
+        else {
+            m_pendulum.setLinkState(link, state[2 + 2 * link], state[3 + 2 * link]);
+        }
+    }
+
+    // Pushing into a rail end: the reaction force cancels the acceleration
+    if (blocked) {
+        if ((position <= -halfRail && m_appliedAcceleration < 0.0) ||
+            (position >= halfRail && m_appliedAcceleration > 0.0)) {
+            return 0.0;
+        }
+    }
+    return m_appliedAcceleration;
+}
+
+template <int LINKS>
+void CartPendulumSystem::computeDerivative(const std::array<double, 2 * (LINKS + 1)>& s,
+    std::array<double, 2 * (LINKS + 1)>& ds, bool cartHeld) const
+{
+    // Point masses at the link ends, as in SinglePendulum / DoublePendulum:
+    //  x_k = x + sum_{j<=k} L_j*sin(theta_j), y_k = -sum_{j<=k} L_j*cos(theta_j)
+    // which gives the mass matrix (symmetric)
+    //  M_xx = m_cart + sum m_k
+    //  M_xj = outerMass[j] * L_j * cos(theta_j)
+    //  M_ij = outerMass[max(i,j)] * L_i * L_j * cos(theta_i - theta_j)
+    const double* length = m_length;
+    const double* outerMass = m_outerMass;
+
+    double sinTheta[LINKS], cosTheta[LINKS], omega[LINKS];
+    for (int link = 0; link < LINKS; ++link) {
+        sinTheta[link] = std::sin(s[2 + 2 * link]);
+        cosTheta[link] = std::cos(s[2 + 2 * link]);
+        omega[link] = s[3 + 2 * link];
+    }
+
+    // Cart row: applied force and friction act on the cart body only
+    double cartCoupling[LINKS];     // M_xj
+    double cartForce = m_cartMass * (m_appliedAcceleration - m_friction * s[1]);
+    for (int j = 0; j < LINKS; ++j) {
+        cartCoupling[j] = outerMass[j] * length[j] * cosTheta[j];
+        cartForce += outerMass[j] * length[j] * sinTheta[j] * omega[j] * omega[j];
+    }
+
+    // Link rows: gravity, centripetal coupling and damping
+    double linkMatrix[LINKS][LINKS];    // M_ij
+    double linkForce[LINKS];
+    for (int i = 0; i < LINKS; ++i) {
+        linkForce[i] = -outerMass[i] * m_gravity * length[i] * sinTheta[i] - m_dampingScale[i] * omega[i];
+        for (int j = 0; j < LINKS; ++j) {
+            double mu = outerMass[std::max(i, j)] * length[i] * length[j];
+            double cosDiff = cosTheta[i] * cosTheta[j] + sinTheta[i] * sinTheta[j];
+            double sinDiff = sinTheta[i] * cosTheta[j] - cosTheta[i] * sinTheta[j];
+            linkMatrix[i][j] = mu * cosDiff;
+            linkForce[i] -= mu * sinDiff * omega[j] * omega[j];
+        }
+    }
+
+    // Eliminate the cart row (Schur complement), leaving a 1x1 / 2x2
+    // symmetric positive definite system in the link accelerations. A cart
+    // pinned at the rail end has x_dd = 0 and only the link equations remain.
+    if (!cartHeld) {
+        for (int i = 0; i < LINKS; ++i) {
+            for (int j = 0; j < LINKS; ++j) {
+                linkMatrix[i][j] -= cartCoupling[i] * cartCoupling[j] * m_inverseTotalMass;
+            }
+            linkForce[i] -= cartCoupling[i] * cartForce * m_inverseTotalMass;
+        }
+    }
+
+    double linkAccel[LINKS];
+    if constexpr (LINKS == 1) {
+        linkAccel[0] = linkForce[0] / linkMatrix[0][0];
+    }
+    else {
+        double det = linkMatrix[0][0] * linkMatrix[1][1] - linkMatrix[0][1] * linkMatrix[1][0];
+        linkAccel[0] = (linkForce[0] * linkMatrix[1][1] - linkMatrix[0][1] * linkForce[1]) / det;
+        linkAccel[1] = (linkMatrix[0][0] * linkForce[1] - linkForce[0] * linkMatrix[1][0]) / det;
+    }
+
+    double cartAccel = 0.0;
+    if (!cartHeld) {
+        cartAccel = cartForce;
+        for (int j = 0; j < LINKS; ++j) {
+            cartAccel -= cartCoupling[j] * linkAccel[j];
+        }
+        cartAccel *= m_inverseTotalMass;
+    }
+
+    ds[0] = cartHeld ? 0.0 : s[1];
+    ds[1] = cartAccel;
+    for (int link = 0; link < LINKS; ++link) {
+        ds[2 + 2 * link] = omega[link];
+        ds[3 + 2 * link] = linkAccel[link];
+    }
+}
+
+double CartPendulumSystem::normalizeAngle(double angle)
+{
+    const double PI = 3.14159265358979323846;
+    if (!std::isfinite(angle)) return angle;
+    if (std::abs(angle) > 64.0 * PI) angle = std::remainder(angle, 2.0 * PI);
+    while (angle > PI) angle -= 2.0 * PI;
+    while (angle < -PI) angle += 2.0 * PI;
+    return angle;
+}
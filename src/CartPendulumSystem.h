@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Cart.h"
+#include "Integrators.h"
+#include "Pendulum.h"
+#include <array>
+
+/**
+ * CartPendulumSystem - cart and pendulum integrated as one coupled system
+ *
+ * Cart::update followed by Pendulum::update treats the cart acceleration as
+ * prescribed: the pendulum never pushes back on the cart, and every tick
+ * costs two integrator calls. This class integrates the generalized
+ * coordinates q = [x, theta1, (theta2)] with velocities in a single state
+ * vector [x, v, theta1, omega1, (theta2, omega2)] and solves the full
+ * Lagrangian mass matrix M(q) * q_dd = f(q, q_d) every evaluation.
+ *
+ * The applied acceleration is turned into a force on the cart body
+ * (cart mass * acceleration), and so is the friction coefficient, so a
+ * cart without pendulum moves exactly as in Cart::update. Per-link damping
+ * matches SinglePendulum / DoublePendulum, so with a very heavy cart the
+ * pendulum reproduces its prescribed-acceleration motion.
+ *
+ * The Cart and Pendulum objects stay the owners of state and parameters
+ * (rendering and tuning keep working on them); update() reads them, takes
+ * one step with the pendulum's integrator and writes the result back.
+ * Rail ends behave as in Cart::update: the cart is clamped and stopped at
+ * the end, and while it rests there and the dynamics push it outward it is
+ * held fixed and the pendulum swings about a stationary pivot.
+ *
+ * Pendulums with more than two links (ChainPendulum) are not coupled:
+ * update() falls back to Cart::update followed by Pendulum::update.
+ */
+class CartPendulumSystem
+{
+public:
+    CartPendulumSystem(Cart& cart, Pendulum& pendulum);
+
+    // Physics update. Returns the applied acceleration that reached the
+    // cart (zero when it is blocked at a rail end), like Cart::update.
+    double update(double dt, double appliedAcceleration, double friction);
+
+    Cart& getCart() { return m_cart; }
+    Pendulum& getPendulum() { return m_pendulum; }
+
+private:
+    Cart& m_cart;
+    Pendulum& m_pendulum;
+
+    IntegratorSet<4> m_singleSolver;
+    IntegratorSet<6> m_doubleSolver;
+
+    // Inputs of the current update, read by the derivative. Parameters are
+    // gathered once per update instead of through virtual calls per stage.
+    double m_appliedAcceleration = 0.0;
+    double m_friction = 0.0;
+    bool m_cartHeld = false;
+    double m_cartMass = 1.0;
+    double m_gravity = 9.81;
+    double m_inverseTotalMass = 1.0;    // 1 / (cart + link masses)
+    double m_length[2] = { 1.0, 1.0 };
+    double m_outerMass[2] = { 1.0, 1.0 };   // mass at or beyond each link
+    double m_dampingScale[2] = { 0.0, 0.0 };
+
+    template <int LINKS>
+    double step(double dt, IntegratorSet<2 * (LINKS + 1)>& solver);
+
+    template <int LINKS>
+    void computeDerivative(const std::array<double, 2 * (LINKS + 1)>& s,
+        std::array<double, 2 * (LINKS + 1)>& ds, bool cartHeld) const;
+
+    static double normalizeAngle(double angle);
+};
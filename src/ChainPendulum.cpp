@@ -0,0 +1,181 @@
+#include "ChainPendulum.h"
+#include <cmath>
+
+ChainPendulum::ChainPendulum(int numLinks, double mass, double length)
+    : m_numLinks(numLinks > 0 ? numLinks : 1)
+    , m_mass(m_numLinks, mass)
+    , m_length(m_numLinks, length)
+    , m_initialAngle(m_numLinks, 0.0)
+    , m_state(2 * m_numLinks, 0.0)
+    , m_links(m_numLinks)
+{
+}
+
+void ChainPendulum::update(double dt, double cartAcceleration)
+{
+    using Solver = IntegratorSet<DYNAMIC_STATE_SIZE>;
+
+    // Derivative function
+    auto derivFunc = [this, cartAcceleration](double t, const Solver::State& s, Solver::State& ds) {
+        this->computeDerivative(s.data(), cartAcceleration, ds.data());
+        };
+
+    // Integrate the interleaved state in place
+    m_solver.stepFixed(m_integrator, 0.0, m_state, derivFunc, dt);
+
+    // Keep angles in [-pi, pi] range
+    bool settled = true;
+    const double ANGLE_EPS = 1e-6;
+    const double VEL_EPS = 1e-6;
+    for (int i = 0; i < m_numLinks; ++i) {
+        m_state[2 * i] = normalizeAngle(m_state[2 * i]);
+        settled = settled && std::abs(m_state[2 * i + 1]) < VEL_EPS && std::abs(m_state[2 * i]) < ANGLE_EPS;
+    }
+
+    // Snap to rest once every link has settled, as the other pendulums do
+    if (settled) {
+        for (double& value : m_state) value = 0.0;
+    }
+}
+
+void ChainPendulum::reset()
+{
+    for (int i = 0; i < m_numLinks; ++i) {
+        m_state[2 * i] = m_initialAngle[i];
+        m_state[2 * i + 1] = 0.0;
+    }
+}
+
+void ChainPendulum::computeDerivative(const double* state, double cartAccel, double* dstate)
+{
+    // Spatial vectors are expressed about the world origin, which is the
+    // pivot on the cart. The base translates with the cart; gravity enters as
+    // an upward base acceleration g. Joint i is the relative angle
+    // theta_i - theta_(i-1) at the end of link i-1.
+
+    // Pass 1 (outward): joint axes, velocities, rigid-body inertias and bias forces
+    SpatialVector v = { 0.0, 0.0, 0.0 };
+    double px = 0.0;
+    double py = 0.0;
+    for (int i = 0; i < m_numLinks; ++i) {
+        LinkWorkspace& link = m_links[i];
+        double omega = state[2 * i + 1];
+        double qd = omega - (i > 0 ? state[2 * i - 1] : 0.0);
+
+        // Revolute joint at (px, py): unit rotation moves the origin point by z x (0 - p)
+        link.S = { 1.0, py, -px };
+        SpatialVector vJ = { qd, py * qd, -px * qd };
+        v = { v.w + vJ.w, v.x + vJ.x, v.y + vJ.y };
+
+        // c = v x vJ (motion cross product)
+        link.c = { 0.0, -v.w * vJ.y + v.y * vJ.w, v.w * vJ.x - v.x * vJ.w };
+
+        // Point mass at the end of the link
+        double rx = px + m_length[i] * std::sin(state[2 * i]);
+        double ry = py - m_length[i] * std::cos(state[2 * i]);
+        double m = m_mass[i];
+        double (&I)[3][3] = link.IA;
+        I[0][0] = m * (rx * rx + ry * ry); I[0][1] = -m * ry; I[0][2] = m * rx;
+        I[1][0] = -m * ry;                 I[1][1] = m;       I[1][2] = 0.0;
+        I[2][0] = m * rx;                  I[2][1] = 0.0;     I[2][2] = m;
+
+        // pA = v x* (I v) (force cross product); in the plane only the
+        // linear momentum (hx, hy) contributes
+        double hx = I[1][0] * v.w + I[1][1] * v.x;
+        double hy = I[2][0] * v.w + I[2][2] * v.y;
+        link.pA = { v.x * hy - v.y * hx, -v.w * hy, v.w * hx };
+
+        px = rx;
+        py = ry;
+    }
+
+    // Pass 2 (inward): articulated inertias. Damping acts on absolute angular
+    // velocities, so joint i sees the sum of the damping torques outboard of it.
+    double torque = 0.0;
+    for (int i = m_numLinks - 1; i >= 0; --i) {
+        LinkWorkspace& link = m_links[i];
+        const double (&IA)[3][3] = link.IA;
+        const SpatialVector& S = link.S;
+
+        torque -= m_damping * m_length[i] * state[2 * i + 1];
+
+        link.U = {
+            IA[0][0] * S.w + IA[0][1] * S.x + IA[0][2] * S.y,
+            IA[1][0] * S.w + IA[1][1] * S.x + IA[1][2] * S.y,
+            IA[2][0] * S.w + IA[2][1] * S.x + IA[2][2] * S.y };
+        link.D = S.w * link.U.w + S.x * link.U.x + S.y * link.U.y;
+        link.u = torque - (S.w * link.pA.w + S.x * link.pA.x + S.y * link.pA.y);
+
+        if (i == 0) break;
+
+        // Ia = IA - U U^T / D, pa = pA + Ia c + U u / D, accumulated into the parent
+        LinkWorkspace& parent = m_links[i - 1];
+        const double U[3] = { link.U.w, link.U.x, link.U.y };
+        const double c[3] = { link.c.w, link.c.x, link.c.y };
+        const double invD = 1.0 / link.D;
+        double Iac[3] = { 0.0, 0.0, 0.0 };
+        for (int r = 0; r < 3; ++r) {
+            for (int col = 0; col < 3; ++col) {
+                double Ia = IA[r][col] - U[r] * U[col] * invD;
+                parent.IA[r][col] += Ia;
+                Iac[r] += Ia * c[col];
+            }
+        }
+        double uOverD = link.u * invD;
+        parent.pA.w += link.pA.w + Iac[0] + U[0] * uOverD;
+        parent.pA.x += link.pA.x + Iac[1] + U[1] * uOverD;
+        parent.pA.y += link.pA.y + Iac[2] + U[2] * uOverD;
+    }
+
+    // Pass 3 (outward): joint and absolute angular accelerations
+    SpatialVector a = { 0.0, cartAccel, m_gravity };
+    double alpha = 0.0;
+    for (int i = 0; i < m_numLinks; ++i) {
+        const LinkWorkspace& link = m_links[i];
+        a = { a.w + link.c.w, a.x + link.c.x, a.y + link.c.y };
+        double qdd = (link.u - (link.U.w * a.w + link.U.x * a.x + link.U.y * a.y)) / link.D;
+        a = { a.w + link.S.w * qdd, a.x + link.S.x * qdd, a.y + link.S.y * qdd };
+        alpha += qdd;
+
+        dstate[2 * i] = state[2 * i + 1];
+        dstate[2 * i + 1] = alpha;
+    }
+}
+
+double ChainPendulum::getKineticEnergy(double cartVelocity) const
+{
+    // Mass k moves with the cart plus every link up to and including k:
+    // x_k_dot = v_cart + sum L_j*cos(theta_j)*omega_j, y_k_dot = sum L_j*sin(theta_j)*omega_j
+    double xdot = cartVelocity;
+    double ydot = 0.0;
+    double ke = 0.0;
+    for (int i = 0; i < m_numLinks; ++i) {
+        xdot += m_length[i] * std::cos(m_state[2 * i]) * m_state[2 * i + 1];
+        ydot += m_length[i] * std::sin(m_state[2 * i]) * m_state[2 * i + 1];
+        ke += 0.5 * m_mass[i] * (xdot * xdot + ydot * ydot);
+    }
+    return ke;
+}
+
+double ChainPendulum::getPotentialEnergy() const
+{
+    // PE relative to every link hanging down (theta = 0)
+    double height = 0.0;
+    double pe = 0.0;
+    for (int i = 0; i < m_numLinks; ++i) {
+        height += m_length[i] * (1.0 - std::cos(m_state[2 * i]));
+        pe += m_mass[i] * m_gravity * height;
+    }
+    return pe;
+}
+
+double ChainPendulum::normalizeAngle(double angle)
+{
+    // Wrap angle to [-pi, pi]
+    const double PI = 3.14159265358979323846;
+    if (!std::isfinite(angle)) return angle;
+    if (std::abs(angle) > 64.0 * PI) angle = std::remainder(angle, 2.0 * PI);
+    while (angle > PI) angle -= 2.0 * PI;
+    while (angle < -PI) angle += 2.0 * PI;
+    return angle;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Pendulum.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * ChainPendulum - N pendulums connected in series
+ *
+ * Same model as DoublePendulum generalized to any number of links: point
+ * masses at the link ends on massless rods, absolute angles measured from
+ * hanging down, and a damping torque -damping * L_i * omega_i on each link
+ * (with two links both classes integrate the same equations).
+ *
+ * Forward dynamics use the articulated-body algorithm in planar spatial
+ * vector form (Featherstone): one outward pass for velocities, one inward
+ * pass accumulating articulated inertias and one outward pass for the
+ * accelerations. Cost is O(N) per evaluation, with no N x N mass matrix.
+ */
+class ChainPendulum : public Pendulum
+{
+public:
+    // All links start with the same mass and length
+    ChainPendulum(int numLinks, double mass, double length);
+
+    void update(double dt, double cartAcceleration) override;
+    void reset() override;
+    int getNumAngles() const override { return m_numLinks; }
+
+    double getAngle(int index) const override { return m_state[2 * index]; }
+    double getAngularVelocity(int index) const override { return m_state[2 * index + 1]; }
+    double getLinkMass(int index) const override { return m_mass[index]; }
+    double getLinkLength(int index) const override { return m_length[index]; }
+    void setLinkState(int index, double angle, double angularVelocity) override {
+        m_state[2 * index] = angle;
+        m_state[2 * index + 1] = angularVelocity;
+    }
+    void getState(double* state) const override { std::copy(m_state.begin(), m_state.end(), state); }
+    void setState(const double* state) override { std::copy(state, state + m_state.size(), m_state.begin()); }
+
+    void setAngle(int index, double angle) { m_state[2 * index] = angle; }
+    void setAngularVelocity(int index, double vel) { m_state[2 * index + 1] = vel; }
+    void setMass(int index, double m) { m_mass[index] = m; }
+    void setLength(int index, double l) { m_length[index] = l; }
+    void setInitialAngle(int index, double angle) { m_initialAngle[index] = angle; }
+    double getInitialAngle(int index) const { return m_initialAngle[index]; }
+
+    double getKineticEnergy(double cartVelocity) const override;
+    double getPotentialEnergy() const override;
+
+    /**
+     * Forward dynamics for an interleaved state [angle1, angVel1, angle2, ...]
+     *
+     * Writes [angVel1, angAccel1, angVel2, angAccel2, ...] into dstate.
+     */
+    void computeDerivative(const double* state, double cartAccel, double* dstate);
+
+private:
+    // Planar spatial vectors [angular, linear x, linear y] about the world
+    // origin, and one link's articulated-body quantities
+    struct SpatialVector
+    {
+        double w, x, y;
+    };
+    struct LinkWorkspace
+    {
+        SpatialVector S;        // joint motion subspace
+        SpatialVector c;        // velocity-product acceleration
+        SpatialVector pA;       // articulated bias force
+        SpatialVector U;        // IA * S
+        double IA[3][3];        // articulated inertia
+        double D;               // S^T * U
+        double u;               // joint torque minus bias
+    };
+
+    int m_numLinks;
+    std::vector<double> m_mass;
+    std::vector<double> m_length;
+    std::vector<double> m_initialAngle;
+    std::vector<double> m_state;        // [angle1, angVel1, angle2, angVel2, ...]
+
+    // Integrator and dynamics workspaces (per instance)
+    IntegratorSet<DYNAMIC_STATE_SIZE> m_solver;
+    std::vector<LinkWorkspace> m_links;
+
+    double normalizeAngle(double angle);
+};
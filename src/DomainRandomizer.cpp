@@ -0,0 +1,78 @@
+#include "DomainRandomizer.h"
+#include "Random.h"
+#include <iostream>
+
+DomainRandomizer::DomainRandomizer(const DomainRandomizationConfig& config)
+    : m_config(config)
+{
+    m_ranges[static_cast<int>(BatchParameter::GRAVITY)] = config.gravity;
+    m_ranges[static_cast<int>(BatchParameter::DAMPING)] = config.damping;
+    m_ranges[static_cast<int>(BatchParameter::RAIL_LENGTH)] = config.railLength;
+    m_ranges[static_cast<int>(BatchParameter::CART_MASS)] = config.cartMass;
+    for (int link = 0; link < 2; ++link) {
+        m_ranges[static_cast<int>(BatchParameter::MASS1) + link] = config.linkMass[link];
+        m_ranges[static_cast<int>(BatchParameter::LENGTH1) + link] = config.linkLength[link];
+        m_ranges[static_cast<int>(BatchParameter::INITIAL_ANGLE1) + link] = config.initialAngle[link];
+    }
+}
+
+bool DomainRandomizer::validate(const DomainRandomizationConfig& config)
+{
+    DomainRandomizer randomizer(config);
+    for (int parameter = 0; parameter < PARAMETER_COUNT; ++parameter) {
+        const ParameterRange& range = randomizer.m_ranges[parameter];
+        if (!(range.low <= range.high)) {
+            std::cerr << "ERROR: Randomization range " << parameter << " has low > high" << std::endl;
+            return false;
+        }
+    }
+    const ParameterRange positive[] = { config.railLength, config.cartMass, config.linkMass[0],
+        config.linkMass[1], config.linkLength[0], config.linkLength[1] };
+    for (const ParameterRange& range : positive) {
+        if (!(range.low > 0.0)) {
+            std::cerr << "ERROR: Randomized masses, lengths and rail length must be positive" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void DomainRandomizer::sample(std::uint64_t env, std::uint64_t episode, double* values) const
+{
+    for (int block = 0; 2 * block < PARAMETER_COUNT; ++block) {
+        const Philox4x32 counter = { { static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(env),
+            static_cast<std::uint32_t>(episode), static_cast<std::uint32_t>(episode >> 32) } };
+        const Philox4x32 bits = philox4x32(counter, m_config.seed);
+        for (int word = 0; word < 2 && 2 * block + word < PARAMETER_COUNT; ++word) {
+            const ParameterRange& range = m_ranges[2 * block + word];
+            values[2 * block + word] = range.low + (range.high - range.low) * uniformUnit(philoxWord(bits, word));
+        }
+    }
+}
+
+template <typename Scalar>
+void DomainRandomizer::reset(BasicBatchCartPendulum<Scalar>& batch, std::size_t env, std::uint64_t episode) const
+{
+    double values[PARAMETER_COUNT];
+    sample(env, episode, values);
+    for (int parameter = 0; parameter < PARAMETER_COUNT; ++parameter) {
+        batch.setParameter(env, static_cast<BatchParameter>(parameter), static_cast<Scalar>(values[parameter]));
+    }
+    batch.reset(env);
+}
+
+template <typename Scalar>
+void DomainRandomizer::reset(BasicBatchCartPendulum<Scalar>& batch, std::size_t begin, std::size_t end,
+    std::uint64_t episode) const
+{
+    for (std::size_t env = begin; env < end; ++env) {
+        reset(batch, env, episode);
+    }
+}
+
+template void DomainRandomizer::reset<double>(BatchCartPendulum&, std::size_t, std::uint64_t) const;
+template void DomainRandomizer::reset<float>(BatchCartPendulumFloat&, std::size_t, std::uint64_t) const;
+template void DomainRandomizer::reset<double>(BatchCartPendulum&, std::size_t, std::size_t,
+    std::uint64_t) const;
+template void DomainRandomizer::reset<float>(BatchCartPendulumFloat&, std::size_t, std::size_t,
+    std::uint64_t) const;
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "BatchCartPendulum.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * ParameterRange - uniform distribution [low, high) of one physical parameter
+ *
+ * low == high fixes the parameter (the defaults fix everything at the
+ * viewer's values).
+ */
+struct ParameterRange
+{
+    double low;
+    double high;
+};
+
+/**
+ * DomainRandomizationConfig - per-environment parameter distributions
+ */
+struct DomainRandomizationConfig
+{
+    std::uint64_t seed = 1;
+    ParameterRange gravity = { 9.81, 9.81 };
+    ParameterRange damping = { 0.1, 0.1 };
+    ParameterRange railLength = { 10.0, 10.0 };
+    ParameterRange cartMass = { 1.0, 1.0 };
+    ParameterRange linkMass[2] = { { 1.0, 1.0 }, { 1.0, 1.0 } };
+    ParameterRange linkLength[2] = { { 1.0, 1.0 }, { 1.0, 1.0 } };
+    ParameterRange initialAngle[2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+};
+
+/**
+ * DomainRandomizer - draws the physical parameters of each batched
+ * environment at reset
+ *
+ * The parameters of environment `env` (modulo 2^32) in episode `episode`
+ * are a pure function of (seed, env, episode): draw k is word k % 2 of the
+ * Philox4x32 block at counter [k / 2, env, episode low, episode high]
+ * under the seed.
+ * No generator state is carried between resets, so the values do not
+ * depend on the order in which environments are reset, on how a batch is
+ * split across threads, or on how many resets happened before.
+ *
+ * Draws are written straight into the BatchParameter rows of a
+ * BasicBatchCartPendulum, which its derivative functions load lane-wise;
+ * reset() then places the environment at its sampled initial angles.
+ */
+class DomainRandomizer
+{
+public:
+    static constexpr int PARAMETER_COUNT = static_cast<int>(BatchParameter::COUNT);
+
+    explicit DomainRandomizer(const DomainRandomizationConfig& config);
+
+    // Positive masses, lengths and rail; low <= high everywhere
+    static bool validate(const DomainRandomizationConfig& config);
+
+    const DomainRandomizationConfig& getConfig() const { return m_config; }
+
+    // PARAMETER_COUNT values in BatchParameter order
+    void sample(std::uint64_t env, std::uint64_t episode, double* values) const;
+
+    // Draw environment env's parameters for `episode` and reset it
+    template <typename Scalar>
+    void reset(BasicBatchCartPendulum<Scalar>& batch, std::size_t env, std::uint64_t episode) const;
+
+    // Same for environments [begin, end), e.g. one ThreadPool::parallelFor chunk
+    template <typename Scalar>
+    void reset(BasicBatchCartPendulum<Scalar>& batch, std::size_t begin, std::size_t end,
+        std::uint64_t episode) const;
+
+private:
+    DomainRandomizationConfig m_config;
+    ParameterRange m_ranges[PARAMETER_COUNT];
+};
+
+extern template void DomainRandomizer::reset<double>(BatchCartPendulum&, std::size_t, std::uint64_t) const;
+extern template void DomainRandomizer::reset<float>(BatchCartPendulumFloat&, std::size_t, std::uint64_t) const;
+extern template void DomainRandomizer::reset<double>(BatchCartPendulum&, std::size_t, std::size_t,
+    std::uint64_t) const;
+extern template void DomainRandomizer::reset<float>(BatchCartPendulumFloat&, std::size_t, std::size_t,
+    std::uint64_t) const;
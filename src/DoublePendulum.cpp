@@ -1,5 +1,7 @@
 #include "DoublePendulum.h"
-#include "ODESolver.h"
+#include "Dual.h"
+#include "Integrators.h"
+#include "PendulumDynamics.h"
 #include <cmath>
 
 DoublePendulum::DoublePendulum(double mass1, double length1, double mass2, double length2)
@@ -18,28 +20,19 @@ DoublePendulum::DoublePendulum(double mass1, double length1, double mass2, doubl
 
 void DoublePendulum::update(double dt, double cartAcceleration)
 {
-    // Use Dormand-Prince RK8 solver
-    static ODESolver solver;
+    // Integrate with the selected integrator (Dormand-Prince RK8 by default)
+    using Solver = IntegratorSet<4>;
 
     // State vector: [angle1, angVel1, angle2, angVel2]
-    std::vector<double> state = { m_angle1, m_angularVelocity1, m_angle2, m_angularVelocity2 };
+    Solver::State state = { m_angle1, m_angularVelocity1, m_angle2, m_angularVelocity2 };
 
     // Derivative function
-    auto derivFunc = [this, cartAcceleration](double t, const std::vector<double>& s) -> std::vector<double> {
-        double theta1 = s[0];
-        double omega1 = s[1];
-        double theta2 = s[2];
-        double omega2 = s[3];
-
-        double alpha1, alpha2;
-        this->computeAngularAccelerations(theta1, theta2, omega1, omega2,
-            cartAcceleration, alpha1, alpha2);
-
-        return { omega1, alpha1, omega2, alpha2 };
+    auto derivFunc = [this, cartAcceleration](double t, const Solver::State& s, Solver::State& ds) {
+        this->computeDerivative(s, cartAcceleration, ds);
         };
 
     // Take one step with fixed dt
-    solver.stepFixed(0.0, state, derivFunc, dt);
+    m_solver.stepFixed(m_integrator, 0.0, state, derivFunc, dt);
 
     // Update state
     m_angle1 = state[0];
@@ -110,62 +103,51 @@ void DoublePendulum::setAngularVelocity(int index, double vel)
     else if (index == 1) m_angularVelocity2 = vel;
 }
 
-void DoublePendulum::computeAngularAccelerations(double theta1, double theta2,
-    double omega1, double omega2,
-    double cartAccel,
-    double& alpha1, double& alpha2)
+template <typename Scalar>
+void DoublePendulum::computeDerivative(const std::array<Scalar, 4>& s, Scalar cartAccel, std::array<Scalar, 4>& ds) const
 {
-    // Lagrangian-derived equations for a double pendulum with a moving support (cart)
-    // Coordinates: theta1, theta2 measured from downward vertical (theta=0 is hanging down)
-    // Using positions:
-    //  x1 = x_cart + L1*sin(theta1), y1 = -L1*cos(theta1)
-    //  x2 = x1 + L2*sin(theta2), y2 = y1 - L2*cos(theta2)
-    // After deriving Euler-Lagrange equations and isolating theta'' terms we obtain
-    // a 2x2 linear system: A * [theta1_dd; theta2_dd] = RHS
-
-    const double g = m_gravity;
-    const double L1 = m_length1;
-    const double L2 = m_length2;
-    const double m1 = m_mass1;
-    const double m2 = m_mass2;
-
-    double dtheta = theta1 - theta2; // note sign used in cos/sin below
-    double c = std::cos(dtheta);
-    double s = std::sin(dtheta);
-
-    // Mass-inertia matrix coefficients
-    double A11 = (m1 + m2) * L1;
-    double A12 = m2 * L2 * c;
-    double A21 = m2 * L1 * c;
-    double A22 = m2 * L2;
-
-    // Right-hand side (move all non-acceleration terms to RHS)
-    double RHS1 = - (m1 + m2) * g * std::sin(theta1)
-                  - m2 * L2 * omega2 * omega2 * s
-                  - (m1 + m2) * cartAccel * std::cos(theta1)
-                  - m_damping * omega1;
-
-    double RHS2 = m2 * L1 * omega1 * omega1 * s
-                  - m2 * g * std::sin(theta2)
-                  - m2 * cartAccel * std::cos(theta2)
-                  - m_damping * omega2;
-
-    // Solve 2x2 linear system
-    double det = A11 * A22 - A12 * A21;
-    if (std::abs(det) < 1e-12) {
-        // Ill-conditioned; fall back to simple decoupled estimates
-        alpha1 = RHS1 / (A11 > 1e-12 ? A11 : 1.0);
-        alpha2 = RHS2 / (A22 > 1e-12 ? A22 : 1.0);
-        return;
-    }
+    // Lagrangian-derived equations for a double pendulum with a moving support
+    // (see PendulumDynamics.h; shared with the batched integrator).
+    Scalar alpha1, alpha2;
+    PendulumDynamics::doubleAngularAccelerations<Scalar>(s[0], s[2], s[1], s[3], cartAccel,
+        m_gravity, m_damping, m_mass1, m_mass2, m_length1, m_length2,
+        alpha1, alpha2);
+
+    ds[0] = s[1];
+    ds[1] = alpha1;
+    ds[2] = s[3];
+    ds[3] = alpha2;
+}
+
+void DoublePendulum::computeStepJacobian(double dt, double cartAcceleration,
+    std::array<double, 4>& next, StepJacobian& jacobian) const
+{
+    // Inputs [angle1, angVel1, angle2, angVel2, cartAccel], each carrying its own tangent
+    using Scalar = Dual<5>;
+    using Solver = IntegratorSet<4, Scalar>;
+    Solver solver;
+
+    auto step = [&](const std::array<Scalar, 5>& in, std::array<Scalar, 4>& out) {
+        Solver::State state = { in[0], in[1], in[2], in[3] };
+        Scalar cartAccel = in[4];
+        auto derivFunc = [this, &cartAccel](double t, const Solver::State& s, Solver::State& ds) {
+            this->computeDerivative(s, cartAccel, ds);
+            };
+        solver.stepFixed(m_integrator, 0.0, state, derivFunc, dt);
+        out = state;
+        };
 
-    alpha1 = (RHS1 * A22 - A12 * RHS2) / det;
-    alpha2 = (A11 * RHS2 - RHS1 * A21) / det;
+    computeJacobian<5, 4>(step,
+        { m_angle1, m_angularVelocity1, m_angle2, m_angularVelocity2, cartAcceleration },
+        next, jacobian);
 }
 
 double DoublePendulum::normalizeAngle(double angle)
 {
     const double PI = 3.14159265358979323846;
+    // A diverged state (e.g. a too-coarse integrator) must not spin the loops below
+    if (!std::isfinite(angle)) return angle;
+    if (std::abs(angle) > 64.0 * PI) angle = std::remainder(angle, 2.0 * PI);
     while (angle > PI) angle -= 2.0 * PI;
     while (angle < -PI) angle += 2.0 * PI;
     return angle;
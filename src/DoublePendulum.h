@@ -18,6 +18,24 @@ public:
     double getAngularVelocity(int index) const override;
     double getMass(int index) const;
     double getLength(int index) const;
+    double getLinkMass(int index) const override { return getMass(index); }
+    double getLinkLength(int index) const override { return getLength(index); }
+    void setLinkState(int index, double angle, double angularVelocity) override {
+        setAngle(index, angle);
+        setAngularVelocity(index, angularVelocity);
+    }
+    void getState(double* state) const override {
+        state[0] = m_angle1;
+        state[1] = m_angularVelocity1;
+        state[2] = m_angle2;
+        state[3] = m_angularVelocity2;
+    }
+    void setState(const double* state) override {
+        m_angle1 = state[0];
+        m_angularVelocity1 = state[1];
+        m_angle2 = state[2];
+        m_angularVelocity2 = state[3];
+    }
     
     void setAngle(int index, double angle);
     void setAngularVelocity(int index, double vel);
@@ -33,6 +51,17 @@ public:
     }
     double getKineticEnergy(double cartVelocity) const;
     double getPotentialEnergy() const;
+
+    /**
+     * Linearization of one update() step around the current state
+     *
+     * next = f(state, cartAcceleration) for state [angle1, angVel1, angle2,
+     * angVel2], before angle wrapping and rest snapping; jacobian is the
+     * exact 4 x 5 matrix d next / d (state, cartAcceleration).
+     */
+    using StepJacobian = std::array<std::array<double, 5>, 4>;
+    void computeStepJacobian(double dt, double cartAcceleration,
+        std::array<double, 4>& next, StepJacobian& jacobian) const;
     
 private:
     double m_mass1, m_mass2;
@@ -40,11 +69,13 @@ private:
     double m_angle1, m_angle2;
     double m_angularVelocity1, m_angularVelocity2;
     double m_initialAngle1, m_initialAngle2;
+
+    // Integrator workspace (per instance)
+    IntegratorSet<4> m_solver;
     
-    void computeAngularAccelerations(double angle1, double angle2, 
-                                    double angVel1, double angVel2,
-                                    double cartAccel,
-                                    double& angAccel1, double& angAccel2);
+    // [angle1, angVel1, angle2, angVel2] -> derivative; Scalar = double or Dual<M>
+    template <typename Scalar>
+    void computeDerivative(const std::array<Scalar, 4>& s, Scalar cartAccel, std::array<Scalar, 4>& ds) const;
     
     double normalizeAngle(double angle);
 };
\ No newline at end of file
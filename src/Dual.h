@@ -0,0 +1,171 @@
+#pragma once
+
+#include "ScalarTraits.h"
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+/**
+ * Dual - forward-mode automatic differentiation with M tangent directions
+ *
+ * A value together with its partial derivatives with respect to M seeded
+ * inputs. Arithmetic and sin/cos/sqrt/abs propagate the derivatives exactly
+ * (chain rule, no truncation error), so the templated equations of motion
+ * and integrators evaluated on Dual<M> state return the value and its
+ * Jacobian in one pass. Comparisons and select() act on the value only,
+ * which is what branchy physics code needs.
+ */
+template <int M>
+struct Dual
+{
+    double value;
+    double grad[M];
+
+    Dual() = default;
+    Dual(double x) : value(x)
+    {
+        for (int i = 0; i < M; ++i) grad[i] = 0.0;
+    }
+
+    // Independent variable number index (seeded with d/dx_index = 1)
+    static Dual variable(double x, int index)
+    {
+        Dual d(x);
+        d.grad[index] = 1.0;
+        return d;
+    }
+
+    Dual& operator+=(const Dual& b)
+    {
+        value += b.value;
+        for (int i = 0; i < M; ++i) grad[i] += b.grad[i];
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& b)
+    {
+        value -= b.value;
+        for (int i = 0; i < M; ++i) grad[i] -= b.grad[i];
+        return *this;
+    }
+};
+
+template <int M>
+inline Dual<M> operator+(Dual<M> a, const Dual<M>& b) { return a += b; }
+
+template <int M>
+inline Dual<M> operator-(Dual<M> a, const Dual<M>& b) { return a -= b; }
+
+template <int M>
+inline Dual<M> operator-(const Dual<M>& a)
+{
+    Dual<M> r;
+    r.value = -a.value;
+    for (int i = 0; i < M; ++i) r.grad[i] = -a.grad[i];
+    return r;
+}
+
+template <int M>
+inline Dual<M> operator*(const Dual<M>& a, const Dual<M>& b)
+{
+    Dual<M> r;
+    r.value = a.value * b.value;
+    for (int i = 0; i < M; ++i) r.grad[i] = a.grad[i] * b.value + a.value * b.grad[i];
+    return r;
+}
+
+template <int M>
+inline Dual<M> operator/(const Dual<M>& a, const Dual<M>& b)
+{
+    Dual<M> r;
+    double inv = 1.0 / b.value;
+    r.value = a.value * inv;
+    for (int i = 0; i < M; ++i) r.grad[i] = (a.grad[i] - r.value * b.grad[i]) * inv;
+    return r;
+}
+
+// Mixed operations with plain constants (a double promotes to a constant Dual)
+template <int M> inline Dual<M> operator+(const Dual<M>& a, double b) { return a + Dual<M>(b); }
+template <int M> inline Dual<M> operator+(double a, const Dual<M>& b) { return Dual<M>(a) + b; }
+template <int M> inline Dual<M> operator-(const Dual<M>& a, double b) { return a - Dual<M>(b); }
+template <int M> inline Dual<M> operator-(double a, const Dual<M>& b) { return Dual<M>(a) - b; }
+template <int M> inline Dual<M> operator*(const Dual<M>& a, double b) { return a * Dual<M>(b); }
+template <int M> inline Dual<M> operator*(double a, const Dual<M>& b) { return Dual<M>(a) * b; }
+template <int M> inline Dual<M> operator/(const Dual<M>& a, double b) { return a / Dual<M>(b); }
+template <int M> inline Dual<M> operator/(double a, const Dual<M>& b) { return Dual<M>(a) / b; }
+
+template <int M> inline bool operator<(const Dual<M>& a, const Dual<M>& b) { return a.value < b.value; }
+template <int M> inline bool operator>(const Dual<M>& a, const Dual<M>& b) { return a.value > b.value; }
+template <int M> inline bool operator<=(const Dual<M>& a, const Dual<M>& b) { return a.value <= b.value; }
+template <int M> inline bool operator>=(const Dual<M>& a, const Dual<M>& b) { return a.value >= b.value; }
+
+template <int M>
+inline Dual<M> sin(const Dual<M>& a)
+{
+    Dual<M> r;
+    r.value = std::sin(a.value);
+    double slope = std::cos(a.value);
+    for (int i = 0; i < M; ++i) r.grad[i] = slope * a.grad[i];
+    return r;
+}
+
+template <int M>
+inline Dual<M> cos(const Dual<M>& a)
+{
+    Dual<M> r;
+    r.value = std::cos(a.value);
+    double slope = -std::sin(a.value);
+    for (int i = 0; i < M; ++i) r.grad[i] = slope * a.grad[i];
+    return r;
+}
+
+template <int M>
+inline Dual<M> sqrt(const Dual<M>& a)
+{
+    Dual<M> r;
+    r.value = std::sqrt(a.value);
+    double slope = 0.5 / r.value;
+    for (int i = 0; i < M; ++i) r.grad[i] = slope * a.grad[i];
+    return r;
+}
+
+template <int M>
+inline Dual<M> abs(const Dual<M>& a) { return a.value < 0.0 ? -a : a; }
+
+// Value-wise mask ? a : b (see select() in SimdDouble.h)
+template <int M>
+inline Dual<M> select(bool mask, const Dual<M>& a, const Dual<M>& b) { return mask ? a : b; }
+
+template <int M>
+struct ScalarTraits<Dual<M>>
+{
+    static double value(const Dual<M>& x) { return x.value; }
+    static constexpr double EPSILON = DBL_EPSILON;
+};
+
+/**
+ * Jacobian of f: R^N -> R^K at x, by one forward-mode evaluation
+ *
+ * f is called as f(const std::array<Dual<N>, N>& x, std::array<Dual<N>, K>& y)
+ * - typically a generic lambda around templated physics code. Writes f(x)
+ * into fx and the row-major K x N Jacobian dy/dx into jacobian.
+ */
+template <int N, int K, typename Function>
+void computeJacobian(const Function& f, const std::array<double, N>& x,
+    std::array<double, K>& fx, std::array<std::array<double, N>, K>& jacobian)
+{
+    std::array<Dual<N>, N> xd;
+    for (int i = 0; i < N; ++i) {
+        xd[i] = Dual<N>::variable(x[i], i);
+    }
+
+    std::array<Dual<N>, K> yd;
+    f(xd, yd);
+
+    for (int row = 0; row < K; ++row) {
+        fx[row] = yd[row].value;
+        for (int col = 0; col < N; ++col) {
+            jacobian[row][col] = yd[row].grad[col];
+        }
+    }
+}
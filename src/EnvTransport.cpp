@@ -0,0 +1,259 @@
+#include "EnvTransport.h"
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+namespace
+{
+    constexpr std::uint32_t TRANSPORT_MAGIC = 0x50454e56;   // "PENV"
+    constexpr std::uint32_t TRANSPORT_VERSION = 1;
+
+    enum : std::uint32_t { COMMAND_RESET = 1, COMMAND_STEP = 2, COMMAND_CLOSE = 3 };
+
+    // Written once by the server; magic is stored last, with release
+    struct TransportHeader
+    {
+        std::atomic<std::uint32_t> magic;
+        std::uint32_t version;
+        std::uint64_t numEnvs;
+        std::uint32_t observationSize;
+        std::uint32_t slots;
+    };
+
+    // Command slot: this header, then numEnvs actions at ACTIONS_OFFSET
+    struct CommandHeader
+    {
+        std::uint32_t type;
+        std::uint32_t reserved;
+        std::uint64_t seed;
+    };
+
+    constexpr std::size_t ALIGNMENT = 64;
+    constexpr std::size_t ACTIONS_OFFSET = ALIGNMENT;
+
+    std::size_t alignUp(std::size_t bytes)
+    {
+        return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Byte offsets of the arrays inside a batch slot
+    struct BatchLayout
+    {
+        std::size_t observations, finalObservations, rewards, terminated, truncated, bytes;
+
+        BatchLayout(std::size_t numEnvs, int observationSize)
+        {
+            std::size_t rowBytes = numEnvs * observationSize * sizeof(double);
+            observations = 0;
+            finalObservations = alignUp(observations + rowBytes);
+            rewards = alignUp(finalObservations + rowBytes);
+            terminated = alignUp(rewards + numEnvs * sizeof(double));
+            truncated = alignUp(terminated + numEnvs);
+            bytes = alignUp(truncated + numEnvs);
+        }
+    };
+
+    std::size_t commandBytes(std::size_t numEnvs)
+    {
+        return ACTIONS_OFFSET + numEnvs * sizeof(double);
+    }
+
+    // Segment: header, command ring, batch ring
+    std::size_t batchRingOffset(std::size_t numEnvs, std::uint32_t slots)
+    {
+        return alignUp(sizeof(TransportHeader)) + alignUp(SharedRing::getRequiredBytes(slots, commandBytes(numEnvs)));
+    }
+}
+
+EnvServer::EnvServer(VecEnv& env)
+    : m_env(env)
+{
+}
+
+bool EnvServer::create(const std::string& name, std::uint32_t slots)
+{
+    const std::size_t numEnvs = m_env.getNumEnvs();
+    const int observationSize = m_env.getObservationSize();
+    slots = SharedRing::roundSlotCount(slots);
+    BatchLayout layout(numEnvs, observationSize);
+
+    std::size_t batchOffset = batchRingOffset(numEnvs, slots);
+    if (!m_segment.create(name, batchOffset + SharedRing::getRequiredBytes(slots, layout.bytes))) {
+        return false;
+    }
+
+    auto* base = static_cast<unsigned char*>(m_segment.getData());
+    m_commands = SharedRing(base + alignUp(sizeof(TransportHeader)), slots, commandBytes(numEnvs));
+    m_batches = SharedRing(base + batchOffset, slots, layout.bytes);
+    m_commands.initialize();
+    m_batches.initialize();
+    m_commands.attachReader();
+    m_batches.attachWriter();
+
+    auto* header = new (base) TransportHeader();
+    header->version = TRANSPORT_VERSION;
+    header->numEnvs = numEnvs;
+    header->observationSize = static_cast<std::uint32_t>(observationSize);
+    header->slots = slots;
+    header->magic.store(TRANSPORT_MAGIC, std::memory_order_release);
+    return true;
+}
+
+long long EnvServer::serve()
+{
+    BatchLayout layout(m_env.getNumEnvs(), m_env.getObservationSize());
+    long long batches = 0;
+    for (;;) {
+        auto* command = static_cast<const unsigned char*>(m_commands.beginRead());
+        if (!command) {
+            std::cerr << "ERROR: environment client exited without closing" << std::endl;
+            return -1;
+        }
+        const auto& header = *reinterpret_cast<const CommandHeader*>(command);
+        if (header.type == COMMAND_CLOSE) {
+            m_commands.endRead();
+            return batches;
+        }
+
+        auto* batch = static_cast<unsigned char*>(m_batches.beginWrite());
+        if (!batch) {
+            std::cerr << "ERROR: environment client exited without closing" << std::endl;
+            return -1;
+        }
+        auto* observations = reinterpret_cast<double*>(batch + layout.observations);
+        auto* rewards = reinterpret_cast<double*>(batch + layout.rewards);
+        auto* terminated = batch + layout.terminated;
+        auto* truncated = batch + layout.truncated;
+
+        if (header.type == COMMAND_RESET) {
+            m_env.reset(header.seed, observations);
+            std::fill(rewards, rewards + m_env.getNumEnvs(), 0.0);
+            std::fill(terminated, terminated + m_env.getNumEnvs(), 0);
+            std::fill(truncated, truncated + m_env.getNumEnvs(), 0);
+        }
+        else {
+            m_env.step(reinterpret_cast<const double*>(command + ACTIONS_OFFSET), observations, rewards,
+                terminated, truncated, reinterpret_cast<double*>(batch + layout.finalObservations));
+        }
+
+        m_commands.endRead();
+        m_batches.endWrite();
+        ++batches;
+    }
+}
+
+void EnvServer::setSpinCount(int spins)
+{
+    m_commands.setSpinCount(spins);
+    m_batches.setSpinCount(spins);
+}
+
+EnvClient::~EnvClient()
+{
+    close();
+}
+
+bool EnvClient::open(const std::string& name)
+{
+    close();
+    if (!m_segment.open(name)) return false;
+
+    auto* base = static_cast<unsigned char*>(m_segment.getData());
+    const auto* header = reinterpret_cast<const TransportHeader*>(base);
+    if (m_segment.getSize() < sizeof(TransportHeader)
+        || header->magic.load(std::memory_order_acquire) != TRANSPORT_MAGIC
+        || header->version != TRANSPORT_VERSION) {
+        std::cerr << "ERROR: " << name << " is not an initialized environment transport" << std::endl;
+        m_segment.close();
+        return false;
+    }
+
+    m_numEnvs = static_cast<std::size_t>(header->numEnvs);
+    m_observationSize = static_cast<int>(header->observationSize);
+    BatchLayout layout(m_numEnvs, m_observationSize);
+    m_commands = SharedRing(base + alignUp(sizeof(TransportHeader)), header->slots, commandBytes(m_numEnvs));
+    m_batches = SharedRing(base + batchRingOffset(m_numEnvs, header->slots), header->slots, layout.bytes);
+    m_commands.attachWriter();
+    m_batches.attachReader();
+    return true;
+}
+
+void EnvClient::close()
+{
+    if (!m_segment.getData()) return;
+    if (m_holdingBatch) m_batches.endRead();
+    if (!m_command) m_command = static_cast<unsigned char*>(m_commands.beginWrite());
+    if (m_command) {
+        reinterpret_cast<CommandHeader*>(m_command)->type = COMMAND_CLOSE;
+        m_commands.endWrite();
+    }
+    m_command = nullptr;
+    m_holdingBatch = false;
+    m_segment.close();
+}
+
+EnvBatch EnvClient::reset(std::uint64_t seed)
+{
+    return submit(COMMAND_RESET, seed);
+}
+
+double* EnvClient::getActionBuffer()
+{
+    if (!m_command) m_command = static_cast<unsigned char*>(m_commands.beginWrite());
+    if (!m_command) {
+        std::cerr << "ERROR: environment server exited" << std::endl;
+        return nullptr;
+    }
+    return reinterpret_cast<double*>(m_command + ACTIONS_OFFSET);
+}
+
+EnvBatch EnvClient::step()
+{
+    return submit(COMMAND_STEP, 0);
+}
+
+EnvBatch EnvClient::step(const double* actions)
+{
+    double* buffer = getActionBuffer();
+    if (!buffer) return EnvBatch();
+    std::copy(actions, actions + m_numEnvs, buffer);
+    return submit(COMMAND_STEP, 0);
+}
+
+void EnvClient::setSpinCount(int spins)
+{
+    m_commands.setSpinCount(spins);
+    m_batches.setSpinCount(spins);
+}
+
+EnvBatch EnvClient::submit(std::uint32_t type, std::uint64_t seed)
+{
+    if (!m_command) m_command = static_cast<unsigned char*>(m_commands.beginWrite());
+    if (!m_command) {
+        std::cerr << "ERROR: environment server exited" << std::endl;
+        return EnvBatch();
+    }
+    auto* header = reinterpret_cast<CommandHeader*>(m_command);
+    header->type = type;
+    header->seed = seed;
+    m_commands.endWrite();
+    m_command = nullptr;
+
+    // The previous batch is no longer needed once the next command is out
+    if (m_holdingBatch) m_batches.endRead();
+    auto* batch = static_cast<const unsigned char*>(m_batches.beginRead());
+    m_holdingBatch = batch != nullptr;
+    if (!batch) {
+        std::cerr << "ERROR: environment server exited" << std::endl;
+        return EnvBatch();
+    }
+
+    BatchLayout layout(m_numEnvs, m_observationSize);
+    EnvBatch result;
+    result.observations = reinterpret_cast<const double*>(batch + layout.observations);
+    result.finalObservations = reinterpret_cast<const double*>(batch + layout.finalObservations);
+    result.rewards = reinterpret_cast<const double*>(batch + layout.rewards);
+    result.terminated = batch + layout.terminated;
+    result.truncated = batch + layout.truncated;
+    return result;
+}
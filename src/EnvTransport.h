@@ -0,0 +1,100 @@
+#pragma once
+
+#include "SharedRing.h"
+#include "VecEnv.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * EnvBatch - one step's results, read in place from the shared ring
+ *
+ * Same layout as VecEnv::step(): observations and finalObservations are
+ * numEnvs x observationSize doubles (finalObservations rows are only
+ * meaningful where terminated or truncated is set), rewards numEnvs
+ * doubles, done flags numEnvs bytes.
+ */
+struct EnvBatch
+{
+    const double* observations = nullptr;
+    const double* finalObservations = nullptr;
+    const double* rewards = nullptr;
+    const std::uint8_t* terminated = nullptr;
+    const std::uint8_t* truncated = nullptr;
+};
+
+/**
+ * EnvServer - serves a VecEnv to a learner in another process over
+ * POSIX shared memory
+ *
+ * The segment holds two SharedRings: commands (reset with a seed, step
+ * with numEnvs actions, close) from the learner, and result batches back.
+ * serve() steps the VecEnv straight from the command slot into the batch
+ * slot, so a round trip costs two ring hand-offs and no copies.
+ */
+class EnvServer
+{
+public:
+    explicit EnvServer(VecEnv& env);
+
+    // Create the named segment (e.g. "/pendulum_env"); slots per ring are
+    // rounded up to a power of two (SharedRing::roundSlotCount)
+    bool create(const std::string& name, std::uint32_t slots = 2);
+
+    // Handle commands until the client closes (blocks while it is idle);
+    // returns the batches served, or -1 if the client exited without closing
+    long long serve();
+
+    void setSpinCount(int spins);
+
+private:
+    VecEnv& m_env;
+    SharedMemorySegment m_segment;
+    SharedRing m_commands;
+    SharedRing m_batches;
+};
+
+/**
+ * EnvClient - learner side of EnvServer
+ *
+ * Fill getActionBuffer() (numEnvs doubles, in shared memory) and call
+ * step(), or pass an action array to step(actions). The returned EnvBatch
+ * points into the ring and stays valid until the next reset() / step().
+ * If the server process exits, reset() / step() return an EnvBatch of
+ * null pointers and getActionBuffer() returns nullptr.
+ */
+class EnvClient
+{
+public:
+    EnvClient() = default;
+    ~EnvClient();
+
+    EnvClient(const EnvClient&) = delete;
+    EnvClient& operator=(const EnvClient&) = delete;
+
+    // Attach to a segment created by EnvServer::create()
+    bool open(const std::string& name);
+    // Tell the server to stop and detach
+    void close();
+
+    std::size_t getNumEnvs() const { return m_numEnvs; }
+    int getObservationSize() const { return m_observationSize; }
+
+    EnvBatch reset(std::uint64_t seed);
+    double* getActionBuffer();
+    EnvBatch step();
+    EnvBatch step(const double* actions);
+
+    void setSpinCount(int spins);
+
+private:
+    SharedMemorySegment m_segment;
+    SharedRing m_commands;
+    SharedRing m_batches;
+    std::size_t m_numEnvs = 0;
+    int m_observationSize = 0;
+    unsigned char* m_command = nullptr;     // command slot being written, if any
+    bool m_holdingBatch = false;
+
+    EnvBatch submit(std::uint32_t type, std::uint64_t seed);
+};
@@ -0,0 +1,200 @@
+#include "EsTrainer.h"
+#include "Random.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    // Independent streams derived from the one user seed
+    constexpr std::uint64_t NOISE_SALT = 0x6E6F697365000001ULL;
+    constexpr std::uint64_t EPISODE_SALT = 0x6570697300000002ULL;
+    constexpr std::uint64_t EVALUATION_SALT = 0x6576616C00000003ULL;
+    constexpr std::uint64_t INIT_SALT = 0x696E697400000004ULL;
+
+    // Standard normal from one 64-bit draw (Box-Muller, cosine branch)
+    double gaussian(std::uint64_t bits)
+    {
+        const double TWO_PI = 6.28318530717958647692;
+        double u1 = (static_cast<double>(bits >> 32) + 0.5) * (1.0 / 4294967296.0);
+        double u2 = static_cast<double>(bits & 0xFFFFFFFFULL) * (1.0 / 4294967296.0);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(TWO_PI * u2);
+    }
+}
+
+// Lockstep episodes of one policy, evaluated as a single batch per step
+struct EsTrainer::Rollout
+{
+    MlpPolicy policy;       // this member's perturbed parameters
+    std::vector<std::unique_ptr<PendulumEnv>> envs;
+    std::vector<double> observations;
+    std::vector<double> actions;
+    std::vector<double> returns;
+    std::vector<std::uint8_t> done;
+    long long steps = 0;
+
+    Rollout(const EsConfig& config, const MlpPolicy& shape, int episodes)
+        : policy(shape)
+    {
+        for (int episode = 0; episode < episodes; ++episode) {
+            envs.push_back(std::make_unique<PendulumEnv>(config.env));
+        }
+        observations.resize(envs.size() * envs.front()->getObservationSize());
+        actions.resize(envs.size());
+        returns.resize(envs.size());
+        done.resize(envs.size());
+    }
+
+    // Mean return over one episode per env, env e seeded from (episodeSeed, e)
+    double run(const MlpPolicy& actor, std::uint64_t episodeSeed)
+    {
+        const std::size_t count = envs.size();
+        const std::size_t obsSize = static_cast<std::size_t>(envs.front()->getObservationSize());
+        for (std::size_t e = 0; e < count; ++e) {
+            envs[e]->setSeed(splitMix64At(episodeSeed, e));
+            envs[e]->resetInto(&observations[e * obsSize]);
+            returns[e] = 0.0;
+            done[e] = 0;
+        }
+
+        steps = 0;
+        std::size_t active = count;
+        while (active > 0) {
+            // Finished episodes ride along in the batch; their lanes are free
+            actor.evaluateBatch(observations.data(), count, actions.data());
+            for (std::size_t e = 0; e < count; ++e) {
+                if (done[e]) continue;
+                PendulumEnv::StepResult result = envs[e]->stepInto(actions[e], &observations[e * obsSize]);
+                returns[e] += result.reward;
+                ++steps;
+                if (result.terminated || result.truncated) {
+                    done[e] = 1;
+                    --active;
+                }
+            }
+        }
+        return std::accumulate(returns.begin(), returns.end(), 0.0) / static_cast<double>(count);
+    }
+};
+
+EsTrainer::EsTrainer(const EsConfig& config)
+    : m_config(config)
+    , m_pool(config.numThreads)
+{
+    std::vector<int> sizes;
+    sizes.push_back(2 + 2 * std::max(1, m_config.env.numLinks));
+    sizes.insert(sizes.end(), m_config.hiddenSizes.begin(), m_config.hiddenSizes.end());
+    sizes.push_back(1);
+    m_policy = MlpPolicy(sizes);
+
+    // Uniform(-1, 1) / sqrt(fan-in) weights; a small output layer starts
+    // near the zero action
+    std::uint64_t initState = m_config.seed ^ INIT_SALT;
+    float* parameters = m_policy.getParameters();
+    for (std::size_t layer = 0; layer + 1 < sizes.size(); ++layer) {
+        const int n = sizes[layer];
+        const int m = sizes[layer + 1];
+        double scale = (layer + 2 == sizes.size() ? 0.1 : 1.0) / std::sqrt(static_cast<double>(n));
+        for (int i = 0; i < m * n; ++i) {
+            *parameters++ = static_cast<float>(scale * (2.0 * uniformUnit(splitMix64(initState)) - 1.0));
+        }
+        for (int i = 0; i < m; ++i) {
+            *parameters++ = 0.0f;
+        }
+    }
+
+    const int members = 2 * std::max(1, m_config.populationPairs);
+    for (int member = 0; member < members; ++member) {
+        m_members.push_back(std::make_unique<Rollout>(m_config, m_policy, std::max(1, m_config.episodesPerMember)));
+    }
+    m_evaluation = std::make_unique<Rollout>(m_config, m_policy, std::max(1, m_config.evaluationEpisodes));
+    m_fitness.resize(members);
+    m_pairWeights.resize(members / 2);
+    m_firstMoment.assign(m_policy.getParameterCount(), 0.0);
+    m_secondMoment.assign(m_policy.getParameterCount(), 0.0);
+}
+
+EsTrainer::~EsTrainer() = default;
+
+double EsTrainer::evaluate(const MlpPolicy& policy)
+{
+    return m_evaluation->run(policy, m_config.seed ^ EVALUATION_SALT);
+}
+
+EsGenerationStats EsTrainer::step()
+{
+    auto start = std::chrono::steady_clock::now();
+    const int members = static_cast<int>(m_members.size());
+    const int pairs = members / 2;
+    const std::size_t parameterCount = m_policy.getParameterCount();
+    const double sigma = m_config.sigma;
+
+    // Per-generation keys: pair p's direction is the stream at noiseKey + p
+    const std::uint64_t noiseKey = splitMix64At(m_config.seed ^ NOISE_SALT, static_cast<std::uint64_t>(m_generation));
+    const std::uint64_t episodeSeed = splitMix64At(m_config.seed ^ EPISODE_SALT, static_cast<std::uint64_t>(m_generation));
+
+    // Rollouts: each worker rebuilds its perturbation and returns one scalar
+    m_pool.parallelForDynamic(members, 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t member = begin; member < end; ++member) {
+            Rollout& rollout = *m_members[member];
+            const std::uint64_t key = splitMix64At(noiseKey, member / 2);
+            const double scale = (member % 2 == 0) ? sigma : -sigma;
+            const float* theta = m_policy.getParameters();
+            float* perturbed = rollout.policy.getParameters();
+            for (std::size_t j = 0; j < parameterCount; ++j) {
+                perturbed[j] = static_cast<float>(theta[j] + scale * gaussian(splitMix64At(key, j)));
+            }
+            m_fitness[member] = rollout.run(rollout.policy, episodeSeed);
+        }
+        });
+
+    EsGenerationStats stats;
+    stats.generation = m_generation;
+    stats.meanFitness = std::accumulate(m_fitness.begin(), m_fitness.end(), 0.0) / members;
+    stats.maxFitness = *std::max_element(m_fitness.begin(), m_fitness.end());
+    for (const std::unique_ptr<Rollout>& rollout : m_members) {
+        stats.envSteps += rollout->steps;
+    }
+
+    // Centered ranks in [-0.5, 0.5]: invariant to the reward scale
+    std::vector<int> order(members);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return m_fitness[a] < m_fitness[b]; });
+    std::vector<double> shaped(members);
+    for (int rank = 0; rank < members; ++rank) {
+        shaped[order[rank]] = members > 1 ? static_cast<double>(rank) / (members - 1) - 0.5 : 0.0;
+    }
+    for (int pair = 0; pair < pairs; ++pair) {
+        m_pairWeights[pair] = shaped[2 * pair] - shaped[2 * pair + 1];
+    }
+
+    // Adam on -gradient + weight decay, split by parameter range; the noise
+    // for [begin, end) is regenerated from the pair keys
+    const double BETA1 = 0.9;
+    const double BETA2 = 0.999;
+    const double step = static_cast<double>(m_generation + 1);
+    const double firstCorrection = 1.0 - std::pow(BETA1, step);
+    const double secondCorrection = 1.0 - std::pow(BETA2, step);
+    m_pool.parallelFor(parameterCount, [&](std::size_t begin, std::size_t end) {
+        float* theta = m_policy.getParameters();
+        for (std::size_t j = begin; j < end; ++j) {
+            double sum = 0.0;
+            for (int pair = 0; pair < pairs; ++pair) {
+                sum += m_pairWeights[pair] * gaussian(splitMix64At(splitMix64At(noiseKey, pair), j));
+            }
+            double gradient = -sum / (2.0 * pairs * sigma) + m_config.weightDecay * theta[j];
+            m_firstMoment[j] = BETA1 * m_firstMoment[j] + (1.0 - BETA1) * gradient;
+            m_secondMoment[j] = BETA2 * m_secondMoment[j] + (1.0 - BETA2) * gradient * gradient;
+            double update = (m_firstMoment[j] / firstCorrection)
+                / (std::sqrt(m_secondMoment[j] / secondCorrection) + 1e-8);
+            theta[j] = static_cast<float>(theta[j] - m_config.learningRate * update);
+        }
+        });
+
+    stats.centralFitness = evaluate(m_policy);
+    stats.envSteps += m_evaluation->steps;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ++m_generation;
+    return stats;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "MlpPolicy.h"
+#include "PendulumEnv.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * EsConfig - hyperparameters of EsTrainer
+ */
+struct EsConfig
+{
+    PendulumEnvConfig env;              // task; the defaults are single-pendulum swing-up
+    std::vector<int> hiddenSizes = { 32, 32 };
+    int populationPairs = 64;           // antithetic pairs per generation (2x rollouts)
+    int episodesPerMember = 8;          // episodes per fitness, run in lockstep
+    double sigma = 0.05;                // perturbation scale
+    double learningRate = 0.02;         // Adam step size
+    double weightDecay = 0.005;         // L2 pull on the parameters
+    int evaluationEpisodes = 16;        // central-policy evaluation
+    std::uint64_t seed = 1;
+    int numThreads = 0;                 // counts the calling thread; 0 = hardware threads
+};
+
+/**
+ * EsGenerationStats - what one EsTrainer::step() did
+ */
+struct EsGenerationStats
+{
+    int generation = 0;
+    double meanFitness = 0.0;           // mean episode return over the population
+    double maxFitness = 0.0;
+    double centralFitness = 0.0;        // updated policy on the evaluation episodes
+    long long envSteps = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * EsTrainer - OpenAI-style evolution strategies on MlpPolicy parameters
+ *
+ * Each generation draws populationPairs Gaussian directions eps_p and
+ * evaluates theta + sigma * eps_p and theta - sigma * eps_p. A fitness is the
+ * mean return of episodesPerMember PendulumEnv episodes stepped in
+ * lockstep, so one batched MlpPolicy evaluation covers them all; every
+ * member sees the same episode seeds within a generation (common random
+ * numbers). Fitnesses are replaced by centered ranks, and Adam follows
+ * grad = sum_p (rank+ - rank-) eps_p / (2 * pairs * sigma) - weightDecay * theta.
+ *
+ * Noise is never stored or sent: eps_p[j] is a pure function of
+ * (seed, generation, p, j) through the counter-based SplitMix64 stream,
+ * so a rollout worker regenerates its direction locally and returns one
+ * scalar fitness, and the update regenerates the same values per
+ * parameter chunk. Rollouts are scheduled on a ThreadPool with work
+ * stealing (episode lengths differ wildly early in training), and the
+ * update is split across the same threads by parameter range.
+ */
+class EsTrainer
+{
+public:
+    explicit EsTrainer(const EsConfig& config);
+    ~EsTrainer();
+
+    EsTrainer(const EsTrainer&) = delete;
+    EsTrainer& operator=(const EsTrainer&) = delete;
+
+    // Run one generation and update the central policy
+    EsGenerationStats step();
+
+    // Mean return of a policy over the fixed evaluation episodes
+    double evaluate(const MlpPolicy& policy);
+
+    const MlpPolicy& getPolicy() const { return m_policy; }
+    const EsConfig& getConfig() const { return m_config; }
+    int getGeneration() const { return m_generation; }
+    int getNumThreads() const { return m_pool.getNumThreads(); }
+
+private:
+    struct Rollout;
+
+    EsConfig m_config;
+    MlpPolicy m_policy;
+    ThreadPool m_pool;
+    int m_generation = 0;
+
+    // One rollout slot per population member, plus one for evaluation
+    std::vector<std::unique_ptr<Rollout>> m_members;
+    std::unique_ptr<Rollout> m_evaluation;
+    std::vector<double> m_fitness;          // [2p] = +eps_p, [2p + 1] = -eps_p
+    std::vector<double> m_pairWeights;
+
+    // Adam state
+    std::vector<double> m_firstMoment;
+    std::vector<double> m_secondMoment;
+};
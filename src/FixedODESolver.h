@@ -0,0 +1,105 @@
+#pragma once
+
+#include "DormandPrince87.h"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// State size for systems whose dimension is only known at runtime
+constexpr int DYNAMIC_STATE_SIZE = -1;
+
+/**
+ * StateStorage - state container for N scalars
+ *
+ * std::array for compile-time sizes; std::vector for DYNAMIC_STATE_SIZE,
+ * where resize() sizes solver workspaces on first use (and whenever the
+ * dimension changes) so later steps stay allocation-free.
+ */
+template <int N, typename Scalar = double>
+struct StateStorage
+{
+    using type = std::array<Scalar, N>;
+    static void resize(type&, std::size_t) {}
+};
+
+template <typename Scalar>
+struct StateStorage<DYNAMIC_STATE_SIZE, Scalar>
+{
+    using type = std::vector<Scalar>;
+    static void resize(type& state, std::size_t n) { if (state.size() != n) state.assign(n, Scalar(0.0)); }
+};
+
+/**
+ * FixedODESolver - allocation-free Dormand-Prince 8(7) for a fixed state size
+ *
+ * Same tableau and summation order as ODESolver::stepFixed (so results are
+ * bit-identical), but the state dimension N is normally a compile-time constant and
+ * the derivative is a functor template parameter that writes into
+ * caller-owned storage (N = DYNAMIC_STATE_SIZE takes the size from the
+ * state at runtime):
+ *
+ *     void deriv(double t, const State& state, State& dstate);
+ *
+ * All workspace lives inside the solver, so a step performs no heap
+ * allocation and the derivative call inlines into the stage loops.
+ *
+ * Scalar is the state's arithmetic type: float for throughput, Dual<M> to
+ * carry derivatives through the step. Tableau coefficients are scaled by dt
+ * in double and rounded to Scalar once, so Scalar = double is unchanged.
+ */
+template <int N, typename Scalar = double>
+class FixedODESolver
+{
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+
+    /**
+     * Fixed step (no adaptation) - useful for consistent frame timing
+     *
+     * @param t Current time
+     * @param state Current state, advanced in place
+     * @param deriv Functor computing the derivative into its third argument
+     * @param dt Time step
+     */
+    template <typename Derivative>
+    void stepFixed(double t, State& state, const Derivative& deriv, double dt);
+
+private:
+    static constexpr int STAGES = DormandPrince87::STAGES;
+
+    // Workspace for k values
+    std::array<State, STAGES> k;
+    State tempState;
+};
+
+template <int N, typename Scalar>
+template <typename Derivative>
+void FixedODESolver<N, Scalar>::stepFixed(double t, State& state, const Derivative& deriv, double dt)
+{
+    using Storage = StateStorage<N, Scalar>;
+    const int n = static_cast<int>(state.size());
+    Storage::resize(tempState, n);
+    for (int stage = 0; stage < STAGES; ++stage) {
+        Storage::resize(k[stage], n);
+    }
+
+    // Compute all 13 k values
+    for (int stage = 0; stage < STAGES; ++stage) {
+        for (int i = 0; i < n; ++i) {
+            tempState[i] = state[i];
+            for (int j = 0; j < stage; ++j) {
+                tempState[i] += static_cast<Scalar>(dt * DormandPrince87::a[stage][j]) * k[j][i];
+            }
+        }
+
+        double t_stage = t + DormandPrince87::c[stage] * dt;
+        deriv(t_stage, tempState, k[stage]);
+    }
+
+    // Apply 8th order solution
+    for (int i = 0; i < n; ++i) {
+        for (int stage = 0; stage < STAGES; ++stage) {
+            state[i] += static_cast<Scalar>(dt * DormandPrince87::b8[stage]) * k[stage][i];
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "FixedStepThread.h"
+#include <algorithm>
+
+FixedStepThread::FixedStepThread(double stepSeconds, double maxCatchUpSeconds)
+    : m_step(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(stepSeconds)))
+    , m_maxCatchUp(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(maxCatchUpSeconds)))
+{
+    m_step = std::max(m_step, Clock::duration(1));
+    m_maxCatchUp = std::max(m_maxCatchUp, m_step);
+}
+
+FixedStepThread::~FixedStepThread()
+{
+    stop();
+}
+
+void FixedStepThread::startThread(TickFunction tick, void* context, DestroyFunction destroy)
+{
+    m_tick = tick;
+    m_context = context;
+    m_destroy = destroy;
+    m_running.store(true, std::memory_order_relaxed);
+    m_thread = std::thread(&FixedStepThread::run, this);
+}
+
+void FixedStepThread::stop()
+{
+    if (!isRunning()) return;
+    m_running.store(false, std::memory_order_relaxed);
+    m_thread.join();
+    m_destroy(m_context);
+    m_context = nullptr;
+}
+
+void FixedStepThread::run()
+{
+    Clock::time_point last = Clock::now();
+    Clock::duration accumulator(0);
+    while (m_running.load(std::memory_order_relaxed)) {
+        const Clock::time_point now = Clock::now();
+        accumulator += now - last;
+        last = now;
+        if (accumulator > m_maxCatchUp) {
+            m_dropped.fetch_add(static_cast<std::uint64_t>((accumulator - m_maxCatchUp) / m_step),
+                std::memory_order_relaxed);
+            accumulator = m_maxCatchUp;
+        }
+
+        // Tick k of this batch ends (accumulator - (k + 1) * step) before now
+        while (accumulator >= m_step && m_running.load(std::memory_order_relaxed)) {
+            accumulator -= m_step;
+            const Clock::time_point start = Clock::now();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tick(m_context, now - accumulator);
+            }
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds > m_maxTickSeconds.load(std::memory_order_relaxed)) {
+                m_maxTickSeconds.store(seconds, std::memory_order_relaxed);
+            }
+            m_ticks.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::this_thread::sleep_until(now + (m_step - accumulator));
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * FixedStepThread - runs a simulation tick at a fixed rate on its own thread
+ *
+ * Accumulator timestep: the wall-clock time elapsed since the thread last
+ * woke up is added to an accumulator, and the tick function is called once
+ * for every whole step in it. Simulated time therefore follows real time
+ * however irregularly the thread is scheduled; between wake-ups it sleeps
+ * until the next step is due. A backlog above maxCatchUp (a stall, a
+ * debugger break) is dropped rather than replayed in one burst, and counted.
+ *
+ * Each call of tick(time) holds getMutex(); other threads lock it to read
+ * or modify what the tick function touches. `time` is the steady_clock
+ * instant that the state after the tick corresponds to (consecutive ticks
+ * are exactly one step apart, except across dropped backlog), for
+ * interpolating between published states.
+ *
+ * start() copies the tick callable (anything invocable with a
+ * Clock::time_point) once; ticks call it through a plain function pointer.
+ */
+class FixedStepThread
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FixedStepThread(double stepSeconds, double maxCatchUpSeconds = 0.25);
+    ~FixedStepThread();
+
+    FixedStepThread(const FixedStepThread&) = delete;
+    FixedStepThread& operator=(const FixedStepThread&) = delete;
+
+    template <typename Tick>
+    void start(const Tick& tick)
+    {
+        if (isRunning()) return;
+        startThread(&invoke<Tick>, new Tick(tick), &destroy<Tick>);
+    }
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    std::mutex& getMutex() { return m_mutex; }
+    double getStepSeconds() const { return std::chrono::duration<double>(m_step).count(); }
+    std::uint64_t getTickCount() const { return m_ticks.load(std::memory_order_relaxed); }
+    std::uint64_t getDroppedTicks() const { return m_dropped.load(std::memory_order_relaxed); }
+    // Longest time a single tick held the mutex (seconds)
+    double getMaxTickSeconds() const { return m_maxTickSeconds.load(std::memory_order_relaxed); }
+
+private:
+    using TickFunction = void (*)(void* context, Clock::time_point time);
+    using DestroyFunction = void (*)(void* context);
+
+    template <typename Tick>
+    static void invoke(void* context, Clock::time_point time)
+    {
+        (*static_cast<Tick*>(context))(time);
+    }
+    template <typename Tick>
+    static void destroy(void* context)
+    {
+        delete static_cast<Tick*>(context);
+    }
+
+    Clock::duration m_step;
+    Clock::duration m_maxCatchUp;
+    std::mutex m_mutex;
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    std::atomic<std::uint64_t> m_ticks{ 0 };
+    std::atomic<std::uint64_t> m_dropped{ 0 };
+    std::atomic<double> m_maxTickSeconds{ 0.0 };
+
+    TickFunction m_tick = nullptr;
+    void* m_context = nullptr;
+    DestroyFunction m_destroy = nullptr;
+
+    void startThread(TickFunction tick, void* context, DestroyFunction destroy);
+    void run();
+};
@@ -0,0 +1,406 @@
+#include "IlqrSolver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+    constexpr int N = IlqrSolver::MAX_STATE;
+
+    double seconds(IlqrSolver::Clock::time_point start, IlqrSolver::Clock::time_point end)
+    {
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // State difference with angle components wrapped to [-pi, pi]
+    double difference(const double* a, const double* b, int i)
+    {
+        const double d = a[i] - b[i];
+        return i >= 2 && i % 2 == 0 ? std::remainder(d, 2.0 * PI) : d;
+    }
+}
+
+IlqrSolver::IlqrSolver(const IlqrConfig& config)
+    : m_cart(1.0, 1e9)
+    , m_single(1.0, 1.0)
+    , m_double(1.0, 1.0, 1.0, 1.0)
+{
+    setConfig(config);
+}
+
+void IlqrSolver::setConfig(const IlqrConfig& config)
+{
+    m_config = config;
+    m_config.horizon = std::max(1, config.horizon);
+    m_config.ticksPerStep = std::max(1, config.ticksPerStep);
+    const std::size_t horizon = static_cast<std::size_t>(m_config.horizon);
+    m_u.assign(horizon, 0.0);
+    m_uNew.assign(horizon, 0.0);
+    m_x.assign((horizon + 1) * N, 0.0);
+    m_xNew.assign((horizon + 1) * N, 0.0);
+    m_k.assign(horizon, 0.0);
+    m_K.assign(horizon * N, 0.0);
+    m_fx.assign(horizon * N * N, 0.0);
+    m_fu.assign(horizon * N, 0.0);
+    m_iterationEstimate = 0.0;
+    m_rolloutEstimate = 0.0;
+    resetControls();
+}
+
+bool IlqrSolver::setModel(const Pendulum& pendulum, double dt, double friction, double railLength)
+{
+    const int links = pendulum.getNumAngles();
+    if (links > 2 || !(dt > 0.0)) return false;
+
+    if (links == 1) {
+        m_single.setMass(pendulum.getLinkMass(0));
+        m_single.setLength(pendulum.getLinkLength(0));
+        m_pendulum = &m_single;
+    }
+    else {
+        for (int link = 0; link < 2; ++link) {
+            m_double.setMass(link, pendulum.getLinkMass(link));
+            m_double.setLength(link, pendulum.getLinkLength(link));
+        }
+        m_pendulum = &m_double;
+    }
+    m_pendulum->setGravity(pendulum.getGravity());
+    m_pendulum->setDamping(pendulum.getDamping());
+    m_pendulum->setIntegrator(m_config.integrator);
+    m_cart.setIntegrator(m_config.integrator);
+
+    m_links = links;
+    m_n = 2 + 2 * links;
+    m_dt = dt;
+    m_friction = friction;
+    m_gravity = pendulum.getGravity();
+    m_railLimit = std::max(0.0, railLength / 2.0 - m_config.railMargin);
+
+    // The cart tick is linear in (x, v, a): read its map off unit states
+    for (int column = 0; column < 3; ++column) {
+        m_cart.setPosition(column == 0 ? 1.0 : 0.0);
+        m_cart.setVelocity(column == 1 ? 1.0 : 0.0);
+        m_cart.update(dt, column == 2 ? 1.0 : 0.0, friction, m_gravity);
+        double* target = column < 2 ? nullptr : m_cartB;
+        if (target) {
+            target[0] = m_cart.getPosition();
+            target[1] = m_cart.getVelocity();
+        }
+        else {
+            m_cartA[0][column] = m_cart.getPosition();
+            m_cartA[1][column] = m_cart.getVelocity();
+        }
+    }
+    return true;
+}
+
+void IlqrSolver::shift(int steps)
+{
+    const int horizon = m_config.horizon;
+    steps = std::clamp(steps, 0, horizon);
+    if (steps == 0) return;
+    std::copy(m_u.begin() + steps, m_u.end(), m_u.begin());
+    std::fill(m_u.end() - steps, m_u.end(), 0.0);
+}
+
+void IlqrSolver::resetControls()
+{
+    // Hanging at rest is a stationary point of the cost (zero gradient):
+    // a short push off it gives the first iteration a direction
+    std::fill(m_u.begin(), m_u.end(), 0.0);
+    const int pushSteps = std::max(1, m_config.horizon / 8);
+    for (int t = 0; t < pushSteps && t < m_config.horizon; ++t) m_u[t] = 0.25 * m_config.maxAcceleration;
+}
+
+void IlqrSolver::step(const double* z, double u, double* next)
+{
+    m_cart.setPosition(z[0]);
+    m_cart.setVelocity(z[1]);
+    m_pendulum->setState(z + 2);
+    for (int tick = 0; tick < m_config.ticksPerStep; ++tick) {
+        const double effective = m_cart.update(m_dt, u, m_friction, m_gravity);
+        m_pendulum->update(m_dt, effective);
+    }
+    next[0] = m_cart.getPosition();
+    next[1] = m_cart.getVelocity();
+    m_pendulum->getState(next + 2);
+}
+
+void IlqrSolver::linearize(const double* z, double u, double* fx, double* fu)
+{
+    const int n = m_n;
+    // F = d z_end / d z_start and Fu = d z_end / d u, chained over the ticks
+    double F[N * N] = {};
+    double Fu[N] = {};
+    for (int i = 0; i < n; ++i) F[i * N + i] = 1.0;
+
+    double pendulum[4];
+    std::copy(z + 2, z + n, pendulum);
+    double T[N * N] = {};
+    double Tu[N] = {};
+    for (int row = 0; row < 2; ++row) {
+        for (int col = 0; col < 2; ++col) T[row * N + col] = m_cartA[row][col];
+        Tu[row] = m_cartB[row];
+    }
+
+    for (int tick = 0; tick < m_config.ticksPerStep; ++tick) {
+        // The model cart never reaches a rail end, so the pendulum sees u
+        if (m_links == 1) {
+            m_single.setState(pendulum);
+            std::array<double, 2> next;
+            SinglePendulum::StepJacobian jacobian;
+            m_single.computeStepJacobian(m_dt, u, next, jacobian);
+            for (int row = 0; row < 2; ++row) {
+                for (int col = 0; col < 2; ++col) T[(2 + row) * N + 2 + col] = jacobian[row][col];
+                Tu[2 + row] = jacobian[row][2];
+                pendulum[row] = next[row];
+            }
+        }
+        else {
+            m_double.setState(pendulum);
+            std::array<double, 4> next;
+            DoublePendulum::StepJacobian jacobian;
+            m_double.computeStepJacobian(m_dt, u, next, jacobian);
+            for (int row = 0; row < 4; ++row) {
+                for (int col = 0; col < 4; ++col) T[(2 + row) * N + 2 + col] = jacobian[row][col];
+                Tu[2 + row] = jacobian[row][4];
+                pendulum[row] = next[row];
+            }
+        }
+
+        double nextF[N * N] = {};
+        double nextFu[N] = {};
+        for (int i = 0; i < n; ++i) {
+            nextFu[i] = Tu[i];
+            for (int k = 0; k < n; ++k) {
+                const double t = T[i * N + k];
+                if (t == 0.0) continue;
+                nextFu[i] += t * Fu[k];
+                for (int j = 0; j < n; ++j) nextF[i * N + j] += t * F[k * N + j];
+            }
+        }
+        std::copy(nextF, nextF + N * N, F);
+        std::copy(nextFu, nextFu + N, Fu);
+    }
+    std::copy(F, F + N * N, fx);
+    std::copy(Fu, Fu + N, fu);
+}
+
+double IlqrSolver::stageCost(const double* z, double u, double scale) const
+{
+    const IlqrConfig& c = m_config;
+    const double wall = std::max(0.0, std::abs(z[0]) - m_railLimit);
+    double cost = c.positionWeight * z[0] * z[0] + c.velocityWeight * z[1] * z[1] + c.railWeight * wall * wall;
+    for (int i = 2; i < m_n; i += 2) {
+        cost += c.uprightWeight * (1.0 + std::cos(z[i])) + c.angularVelocityWeight * z[i + 1] * z[i + 1];
+    }
+    return scale * cost + c.controlWeight * u * u;
+}
+
+void IlqrSolver::costDerivatives(const double* z, double scale, double* lx, double* lxx) const
+{
+    const IlqrConfig& c = m_config;
+    const double wall = std::max(0.0, std::abs(z[0]) - m_railLimit);
+    lx[0] = scale * (2.0 * c.positionWeight * z[0] + 2.0 * c.railWeight * wall * (z[0] < 0.0 ? -1.0 : 1.0));
+    lxx[0] = scale * (2.0 * c.positionWeight + (wall > 0.0 ? 2.0 * c.railWeight : 0.0));
+    lx[1] = scale * 2.0 * c.velocityWeight * z[1];
+    lxx[1] = scale * 2.0 * c.velocityWeight;
+    for (int i = 2; i < m_n; i += 2) {
+        // Curvature of 1 + cos is negative near hanging: keep the convex part
+        lx[i] = -scale * c.uprightWeight * std::sin(z[i]);
+        lxx[i] = scale * c.uprightWeight * std::max(0.0, -std::cos(z[i]));
+        lx[i + 1] = scale * 2.0 * c.angularVelocityWeight * z[i + 1];
+        lxx[i + 1] = scale * 2.0 * c.angularVelocityWeight;
+    }
+}
+
+double IlqrSolver::rollout(double alpha, std::vector<double>& u, std::vector<double>& x)
+{
+    const int horizon = m_config.horizon;
+    const double bound = m_config.maxAcceleration;
+    double cost = 0.0;
+    for (int t = 0; t < horizon; ++t) {
+        const double* z = &x[t * N];
+        const double* nominal = &m_x[t * N];
+        double action = m_u[t] + alpha * m_k[t];
+        for (int i = 0; i < m_n; ++i) action += m_K[t * N + i] * difference(z, nominal, i);
+        action = std::clamp(action, -bound, bound);
+        u[t] = action;
+        cost += stageCost(z, action, 1.0);
+        step(z, action, &x[(t + 1) * N]);
+    }
+    return cost + stageCost(&x[horizon * N], 0.0, m_config.terminalScale);
+}
+
+bool IlqrSolver::backwardPass(double& expectedReduction)
+{
+    const int n = m_n;
+    const int horizon = m_config.horizon;
+    const double bound = m_config.maxAcceleration;
+    const double luu = 2.0 * m_config.controlWeight;
+
+    double Vx[N];
+    double Vxx[N * N] = {};
+    double lxx[N];
+    costDerivatives(&m_x[horizon * N], m_config.terminalScale, Vx, lxx);
+    for (int i = 0; i < n; ++i) Vxx[i * N + i] = lxx[i];
+
+    expectedReduction = 0.0;
+    for (int t = horizon - 1; t >= 0; --t) {
+        const double* fx = &m_fx[t * N * N];
+        const double* fu = &m_fu[t * N];
+        double lx[N];
+        costDerivatives(&m_x[t * N], 1.0, lx, lxx);
+        const double lu = luu * m_u[t];
+
+        // Vxx fx, Vxx fu and their regularized versions
+        double VxxFx[N * N] = {};
+        double VxxFu[N] = {};
+        for (int i = 0; i < n; ++i) {
+            for (int k = 0; k < n; ++k) {
+                const double v = Vxx[i * N + k];
+                VxxFu[i] += v * fu[k];
+                for (int j = 0; j < n; ++j) VxxFx[i * N + j] += v * fx[k * N + j];
+            }
+        }
+
+        double Qx[N];
+        double Qxx[N * N];
+        double Qux[N];
+        double Qu = lu;
+        double Quu = luu;
+        for (int j = 0; j < n; ++j) {
+            Qu += fu[j] * Vx[j];
+            Quu += fu[j] * (VxxFu[j] + m_mu * fu[j]);
+            double qx = lx[j];
+            double qux = 0.0;
+            for (int k = 0; k < n; ++k) {
+                qx += fx[k * N + j] * Vx[k];
+                qux += fu[k] * (VxxFx[k * N + j] + m_mu * fx[k * N + j]);
+            }
+            Qx[j] = qx;
+            Qux[j] = qux;
+            for (int i = 0; i < n; ++i) {
+                double q = i == j ? lxx[i] : 0.0;
+                for (int k = 0; k < n; ++k) q += fx[k * N + i] * VxxFx[k * N + j];
+                Qxx[i * N + j] = q;
+            }
+        }
+        if (!(Quu > 0.0)) return false;
+
+        // Scalar box QP: clamp the Newton step to the bound, no gain if clamped
+        const double free = -Qu / Quu;
+        const double k = std::clamp(free, -bound - m_u[t], bound - m_u[t]);
+        const bool clamped = k != free;
+        double* K = &m_K[t * N];
+        for (int j = 0; j < n; ++j) K[j] = clamped ? 0.0 : -Qux[j] / Quu;
+        m_k[t] = k;
+        expectedReduction += k * Qu + 0.5 * k * k * Quu;
+
+        for (int i = 0; i < n; ++i) {
+            Vx[i] = Qx[i] + K[i] * (Quu * k + Qu) + Qux[i] * k;
+            for (int j = 0; j < n; ++j) {
+                Vxx[i * N + j] = Qxx[i * N + j] + K[i] * Quu * K[j] + K[i] * Qux[j] + Qux[i] * K[j];
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < i; ++j) {
+                const double mean = 0.5 * (Vxx[i * N + j] + Vxx[j * N + i]);
+                Vxx[i * N + j] = mean;
+                Vxx[j * N + i] = mean;
+            }
+        }
+    }
+    return true;
+}
+
+const IlqrSolver::SolveStats& IlqrSolver::solve(const double* observation)
+{
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_config.budgetSeconds));
+    m_stats = SolveStats();
+    if (!m_pendulum) return m_stats;
+    m_mu = 1e-6;
+
+    const int horizon = m_config.horizon;
+    const int n = m_n;
+
+    // Nominal trajectory of the warm-start controls
+    std::fill(m_k.begin(), m_k.end(), 0.0);
+    std::fill(m_K.begin(), m_K.end(), 0.0);
+    std::copy(observation, observation + n, m_xNew.begin());
+    Clock::time_point before = Clock::now();
+    m_cost = rollout(0.0, m_uNew, m_xNew);
+    Clock::time_point after = Clock::now();
+    m_rolloutEstimate = std::max(seconds(before, after), 0.9 * m_rolloutEstimate);
+    m_u.swap(m_uNew);
+    m_x.swap(m_xNew);
+
+    static const double ALPHAS[] = { 1.0, 0.5, 0.25, 0.1, 0.03 };
+    for (int iteration = 0; iteration < m_config.maxIterations; ++iteration) {
+        // Only start work whose estimated cost fits the budget (25% margin)
+        if (Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+            1.25 * (m_iterationEstimate + m_rolloutEstimate))) > deadline) {
+            m_stats.budgetHit = true;
+            break;
+        }
+
+        before = Clock::now();
+        for (int t = 0; t < horizon; ++t) linearize(&m_x[t * N], m_u[t], &m_fx[t * N * N], &m_fu[t * N]);
+        double expectedReduction = 0.0;
+        bool ok = backwardPass(expectedReduction);
+        while (!ok && m_mu < 1e6) {
+            m_mu = std::max(m_mu * 10.0, 1e-4);
+            ok = backwardPass(expectedReduction);
+        }
+        after = Clock::now();
+        m_iterationEstimate = std::max(seconds(before, after), 0.9 * m_iterationEstimate);
+        if (!ok) break;
+
+        // Line search along the new feedforward with the feedback gains
+        bool accepted = false;
+        double newCost = m_cost;
+        for (double alpha : ALPHAS) {
+            if (Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(
+                1.25 * m_rolloutEstimate)) > deadline) {
+                m_stats.budgetHit = true;
+                break;
+            }
+            std::copy(observation, observation + n, m_xNew.begin());
+            before = Clock::now();
+            newCost = rollout(alpha, m_uNew, m_xNew);
+            m_rolloutEstimate = std::max(seconds(before, Clock::now()), 0.9 * m_rolloutEstimate);
+            if (newCost < m_cost) {
+                accepted = true;
+                break;
+            }
+        }
+
+        if (!accepted) {
+            if (m_stats.budgetHit) break;
+            // Nothing left to gain: the gains of this pass fit the nominal
+            if (-expectedReduction < 1e-6 * std::abs(m_cost)) {
+                m_stats.converged = true;
+                break;
+            }
+            m_mu = std::max(m_mu * 10.0, 1e-4);
+            if (m_mu > 1e6) break;
+            continue;
+        }
+        const double improvement = m_cost - newCost;
+        m_u.swap(m_uNew);
+        m_x.swap(m_xNew);
+        m_cost = newCost;
+        m_mu = std::max(m_mu * 0.1, 1e-6);
+        ++m_stats.iterations;
+        if (improvement < 1e-6 * std::abs(m_cost)) {
+            m_stats.converged = true;
+            break;
+        }
+    }
+
+    m_stats.cost = m_cost;
+    m_stats.seconds = seconds(start, Clock::now());
+    return m_stats;
+}
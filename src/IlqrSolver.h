@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Cart.h"
+#include "DoublePendulum.h"
+#include "SinglePendulum.h"
+#include <array>
+#include <chrono>
+#include <vector>
+
+/**
+ * IlqrConfig - horizon, budget and cost of IlqrSolver
+ *
+ * Costs are summed per control step over the horizon, on the state at the
+ * start of each step, and once more (times terminalScale) on the final
+ * state. Angles enter through 1 + cos(angle), zero upright, so the same
+ * cost drives swing-up and balance.
+ */
+struct IlqrConfig
+{
+    int horizon = 50;                   // control steps
+    int ticksPerStep = 3;               // physics ticks per control step (action held)
+    IntegratorType integrator = IntegratorType::RK4;    // model integrator
+    double maxAcceleration = 30.0;      // |a| bound (m/s^2)
+    int maxIterations = 30;
+    double budgetSeconds = 0.005;       // hard limit per solve()
+
+    double positionWeight = 0.2;
+    double velocityWeight = 0.01;
+    double uprightWeight = 5.0;         // per link
+    double angularVelocityWeight = 0.01;
+    double controlWeight = 1e-4;
+    double terminalScale = 20.0;
+    double railMargin = 1.0;            // soft walls this far inside the rail ends (m)
+    double railWeight = 100.0;
+};
+
+/**
+ * IlqrSolver - iterative LQR over the cart + single / double pendulum model
+ *
+ * The model is the interactive loop's uncoupled per-tick sequence (Cart
+ * then Pendulum, the configured integrator) with the action held for
+ * ticksPerStep ticks, run on solver-owned Cart and pendulum objects. Each
+ * iteration differentiates the nominal trajectory (per-tick step Jacobians
+ * from computeStepJacobian, chained over the held ticks), runs the
+ * backward Riccati pass and a line-searched forward rollout with the
+ * feedback gains. The acceleration bound is handled exactly in the
+ * backward pass: for a scalar control the box-constrained QP is a clamp,
+ * and a clamped step gets no feedback gain.
+ *
+ * solve() is warm-started from the controls of the previous call; shift()
+ * drops the steps that have been executed since. An iteration (or a line
+ * search rollout) is only started when the running estimate of its cost
+ * still fits into budgetSeconds, so a solve never overruns by more than
+ * the estimate's error.
+ *
+ * Every buffer is sized by setConfig(); setModel(), shift() and solve()
+ * perform no heap allocation.
+ */
+class IlqrSolver
+{
+public:
+    static constexpr int MAX_STATE = 6;     // [x, v, angle1, angVel1, angle2, angVel2]
+    using Clock = std::chrono::steady_clock;
+
+    struct SolveStats
+    {
+        int iterations = 0;             // accepted iterations
+        double cost = 0.0;
+        double seconds = 0.0;
+        bool converged = false;
+        bool budgetHit = false;         // stopped because the next step would not fit
+    };
+
+    explicit IlqrSolver(const IlqrConfig& config = IlqrConfig());
+
+    void setConfig(const IlqrConfig& config);
+    const IlqrConfig& getConfig() const { return m_config; }
+
+    // Copy the physical parameters (1 or 2 links); dt is the physics tick.
+    // Keeps the warm start. False for other link counts.
+    bool setModel(const Pendulum& pendulum, double dt, double friction, double railLength);
+    int getStateSize() const { return m_n; }
+
+    // Warm start: drop `steps` executed control steps, or start over
+    // (zero controls after a short push; also done by setConfig())
+    void shift(int steps);
+    void resetControls();
+
+    // Optimize from a PendulumEnv observation of the model's link count
+    const SolveStats& solve(const double* observation);
+    const SolveStats& getStats() const { return m_stats; }
+
+    // Result: a[step] = getAction(step) + getGain(step) . (z - getNominalState(step)),
+    // angle differences wrapped
+    double getAction(int step) const { return m_u[step]; }
+    const double* getGain(int step) const { return &m_K[step * MAX_STATE]; }
+    const double* getNominalState(int step) const { return &m_x[step * MAX_STATE]; }
+
+private:
+    IlqrConfig m_config;
+    int m_n = 0;
+    int m_links = 0;
+    double m_dt = 1.0 / 144.0;
+    double m_friction = 0.1;
+    double m_gravity = 9.81;
+    double m_railLimit = 4.0;           // |x| beyond which the wall cost starts
+
+    // Model objects (rail effectively unbounded: walls are a cost)
+    Cart m_cart;
+    SinglePendulum m_single;
+    DoublePendulum m_double;
+    Pendulum* m_pendulum = nullptr;
+    double m_cartA[2][2] = {};          // cart tick map (linear)
+    double m_cartB[2] = {};
+
+    // Trajectories, horizon-sized
+    std::vector<double> m_u, m_uNew;
+    std::vector<double> m_x, m_xNew;    // (horizon + 1) * MAX_STATE
+    std::vector<double> m_k;            // feedforward
+    std::vector<double> m_K;            // horizon * MAX_STATE feedback
+    std::vector<double> m_fx;           // horizon * MAX_STATE^2 step Jacobians
+    std::vector<double> m_fu;           // horizon * MAX_STATE
+    double m_cost = 0.0;
+    double m_mu = 1e-6;                 // regularization, reset every solve
+
+    SolveStats m_stats;
+    double m_iterationEstimate = 0.0;   // seconds, derivatives + backward pass
+    double m_rolloutEstimate = 0.0;
+
+    void step(const double* z, double u, double* next);
+    void linearize(const double* z, double u, double* fx, double* fu);
+    double rollout(double alpha, std::vector<double>& u, std::vector<double>& x);
+    double stageCost(const double* z, double u, double scale) const;
+    void costDerivatives(const double* z, double scale, double* lx, double* lxx) const;
+    bool backwardPass(double& expectedReduction);
+};
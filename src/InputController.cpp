@@ -1,4 +1,5 @@
 #include "InputController.h"
+#include <algorithm>
 
 InputController::InputController(GLFWwindow* window)
     : m_window(window)
@@ -7,29 +8,60 @@ InputController::InputController(GLFWwindow* window)
     , m_resetPressed(false)
     , m_spaceWasPressed(false)
     , m_rWasPressed(false)
+    , m_pWasPressed(false)
+    , m_lWasPressed(false)
+    , m_mWasPressed(false)
 {
+    setMaxAcceleration(m_maxAcceleration);
 }
 
-void InputController::update()
+void InputController::setMaxAcceleration(double a)
+{
+    m_maxAcceleration = a;
+    // The MPC has to plan within the limit its output is clamped to below
+    IlqrConfig config = m_mpc.getConfig();
+    if (config.maxAcceleration != a) {
+        config.maxAcceleration = a;
+        m_mpc.setConfig(config);
+    }
+}
+
+bool InputController::loadPolicy(const std::string& path)
+{
+    if (!m_policy.load(path)) return false;
+    m_policyTick = 0;
+    return true;
+}
+
+void InputController::setControlMode(ControlMode mode)
+{
+    m_controlMode = (mode == ControlMode::Policy && !hasPolicy()) ? ControlMode::Keyboard : mode;
+    m_policyTick = 0;
+    // The MPC thread only runs while it is in control
+    if (m_controlMode == ControlMode::Mpc) m_mpc.start();
+    else m_mpc.stop();
+}
+
+void InputController::pollKeys()
 {
     // Reset single-frame events
     m_togglePressed = false;
     m_resetPressed = false;
-    m_cartAcceleration = 0.0;
+    m_keyDirection = 0.0;
 
     // Check A/D keys for cart movement
     if (glfwGetKey(m_window, GLFW_KEY_A) == GLFW_PRESS) {
-        m_cartAcceleration = -m_maxAcceleration;  // Accelerate left
+        m_keyDirection = -1.0;  // Accelerate left
     }
     if (glfwGetKey(m_window, GLFW_KEY_D) == GLFW_PRESS) {
-        m_cartAcceleration = m_maxAcceleration;   // Accelerate right
+        m_keyDirection = 1.0;   // Accelerate right
     }
     // Also support left/right arrow keys
     if (glfwGetKey(m_window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-        m_cartAcceleration = -m_maxAcceleration;  // Accelerate left
+        m_keyDirection = -1.0;  // Accelerate left
     }
     if (glfwGetKey(m_window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-        m_cartAcceleration = m_maxAcceleration;   // Accelerate right
+        m_keyDirection = 1.0;   // Accelerate right
     }
 
     // Check spacebar for toggle (detect "just pressed")
@@ -46,8 +78,64 @@ void InputController::update()
     }
     m_rWasPressed = rPressed;
 
+    // Check P key for keyboard / policy control (detect "just pressed")
+    bool pPressed = (glfwGetKey(m_window, GLFW_KEY_P) == GLFW_PRESS);
+    if (pPressed && !m_pWasPressed) {
+        setControlMode(m_controlMode == ControlMode::Policy ? ControlMode::Keyboard : ControlMode::Policy);
+    }
+    m_pWasPressed = pPressed;
+
+    // Check L key for keyboard / LQR control (detect "just pressed")
+    bool lPressed = (glfwGetKey(m_window, GLFW_KEY_L) == GLFW_PRESS);
+    if (lPressed && !m_lWasPressed) {
+        setControlMode(m_controlMode == ControlMode::Lqr ? ControlMode::Keyboard : ControlMode::Lqr);
+    }
+    m_lWasPressed = lPressed;
+
+    // Check M key for keyboard / MPC control (detect "just pressed")
+    bool mPressed = (glfwGetKey(m_window, GLFW_KEY_M) == GLFW_PRESS);
+    if (mPressed && !m_mWasPressed) {
+        setControlMode(m_controlMode == ControlMode::Mpc ? ControlMode::Keyboard : ControlMode::Mpc);
+    }
+    m_mWasPressed = mPressed;
+
     // ESC to close window
     if (glfwGetKey(m_window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(m_window, true);
     }
+}
+
+void InputController::update(const double* observation, int observationSize)
+{
+    m_cartAcceleration = m_keyDirection * m_maxAcceleration;
+
+    // Policy mode replaces the A/D acceleration
+    m_policyActive = m_controlMode == ControlMode::Policy && observation
+        && observationSize == m_policy.getInputSize();
+    if (m_policyActive) {
+        if (m_policyTick % m_policyInterval == 0) {
+            m_policyAction = std::clamp(m_policy.act(observation), -1.0, 1.0);
+        }
+        ++m_policyTick;
+        m_cartAcceleration = m_policyAction * m_maxAcceleration;
+    }
+
+    // Lqr mode takes over near upright, within the acceleration limit
+    m_lqrActive = m_controlMode == ControlMode::Lqr && observation && m_lqr.hasModel()
+        && observationSize == m_lqr.getGains()->stateSize
+        && LqrController::uprightError(observation, observationSize) < m_captureAngle;
+    if (m_lqrActive) {
+        m_cartAcceleration = std::clamp(m_lqr.act(observation, observationSize),
+            -m_maxAcceleration, m_maxAcceleration);
+    }
+
+    // Mpc mode follows the latest plan; the keys drive the cart until the first one
+    m_mpcActive = false;
+    if (m_controlMode == ControlMode::Mpc && observation) {
+        double a = 0.0;
+        m_mpc.setState(m_mpcTick, observation, observationSize);
+        m_mpcActive = m_mpc.getAcceleration(m_mpcTick, observation, observationSize, a);
+        ++m_mpcTick;
+        if (m_mpcActive) m_cartAcceleration = std::clamp(a, -m_maxAcceleration, m_maxAcceleration);
+    }
 }
\ No newline at end of file
@@ -1,44 +1,136 @@
 #pragma once
 
+#include "LqrController.h"
+#include "MlpPolicy.h"
+#include "MpcController.h"
+#include <cstdint>
 #include <GLFW/glfw3.h>
+#include <string>
 
 /**
  * InputController - handles keyboard and mouse input
  *
  * Maps keys to actions:
  * - A/D: Move cart left/right
+ * - P: Toggle keyboard / policy control (once a policy is loaded)
+ * - L: Toggle keyboard / LQR balance control
+ * - M: Toggle keyboard / MPC swing-up and balance control
  * - Space: Toggle between single and double pendulum
  * - R: Reset simulation
  * - ESC: Quit
+ *
+ * In Policy mode the cart acceleration comes from an MlpPolicy evaluated
+ * on the PendulumEnv observation passed to update(), every
+ * getPolicyInterval() ticks (PendulumEnv's control decimation) and held in
+ * between; its action in [-1, 1] is scaled by the maximum acceleration.
+ * A policy whose input size does not match the observation (e.g. trained
+ * on the double pendulum while the single one is shown) outputs nothing.
+ *
+ * In Lqr mode the LqrController balances the pendulum every tick once all
+ * links are within the capture angle of upright; further out the A/D keys
+ * still drive the cart, so the pendulum can be swung up by hand and caught.
+ * The caller keeps the controller's model current (getLqr().setModel()).
+ *
+ * In Mpc mode the MpcController thread (running only while the mode is
+ * selected) swings the pendulum up and balances it; update() posts each
+ * observation with a tick count and applies the latest plan. The caller
+ * keeps its model current as well (getMpc().setModel()).
+ *
+ * pollKeys() talks to GLFW and must run on the main thread; update() runs
+ * on the physics thread. The object is not synchronized itself: callers
+ * hold the simulation lock around both.
  */
 class InputController
 {
 public:
+    enum class ControlMode
+    {
+        Keyboard,
+        Policy,
+        Lqr,
+        Mpc
+    };
+
     InputController(GLFWwindow* window);
 
-    // Update input state (call once per frame)
-    void update();
+    // Read the keyboard (main thread, once per frame): held keys, key
+    // events and control mode toggles
+    void pollKeys();
+    // Compute the cart acceleration for one physics tick from the last
+    // polled keys and the active controller; observation is the current
+    // PendulumEnv observation, used in Policy, Lqr and Mpc mode
+    void update(const double* observation = nullptr, int observationSize = 0);
 
     // Query current input state
     double getCartAcceleration() const { return m_cartAcceleration; }
     bool shouldTogglePendulum() const { return m_togglePressed; }
     bool shouldReset() const { return m_resetPressed; }
-    // Runtime tuning for maximum acceleration applied by A/D keys
-    void setMaxAcceleration(double a) { m_maxAcceleration = a; }
+    // Runtime tuning for maximum acceleration applied by A/D keys and the
+    // controllers; also the MPC's planning limit (restarts a running MPC)
+    void setMaxAcceleration(double a);
     double getMaxAcceleration() const { return m_maxAcceleration; }
 
+    // Policy control
+    bool loadPolicy(const std::string& path);
+    bool hasPolicy() const { return m_policy.isLoaded(); }
+    const MlpPolicy& getPolicy() const { return m_policy; }
+    void setControlMode(ControlMode mode);
+    ControlMode getControlMode() const { return m_controlMode; }
+    // True when the last update() took its acceleration from the policy
+    bool isPolicyActive() const { return m_policyActive; }
+    void setPolicyInterval(int ticks) { m_policyInterval = ticks > 0 ? ticks : 1; }
+    int getPolicyInterval() const { return m_policyInterval; }
+
+    // LQR balance control
+    LqrController& getLqr() { return m_lqr; }
+    const LqrController& getLqr() const { return m_lqr; }
+    // True when the last update() took its acceleration from the LQR
+    bool isLqrActive() const { return m_lqrActive; }
+    void setCaptureAngle(double radians) { m_captureAngle = radians; }
+    double getCaptureAngle() const { return m_captureAngle; }
+
+    // MPC control
+    MpcController& getMpc() { return m_mpc; }
+    const MpcController& getMpc() const { return m_mpc; }
+    // True when the last update() took its acceleration from an MPC plan
+    bool isMpcActive() const { return m_mpcActive; }
+    // Ticks posted to the MPC thread (plan ages are measured in these)
+    std::uint64_t getMpcTick() const { return m_mpcTick; }
+
 private:
     GLFWwindow* m_window;
 
     // Input state
     double m_cartAcceleration;   // Acceleration to apply to cart
+    double m_keyDirection = 0.0; // -1 / 0 / +1 from the held A/D or arrow keys
     bool m_togglePressed;        // Space pressed this frame?
     bool m_resetPressed;         // R pressed this frame?
 
     // Previous key states (for detecting "just pressed")
     bool m_spaceWasPressed;
     bool m_rWasPressed;
+    bool m_pWasPressed;
+    bool m_lWasPressed;
+    bool m_mWasPressed;
 
     // Maximum acceleration (m/s^2) used when keys are pressed
     double m_maxAcceleration = 30.0;
+
+    // Policy mode: the action is refreshed every m_policyInterval ticks
+    MlpPolicy m_policy;
+    ControlMode m_controlMode = ControlMode::Keyboard;
+    bool m_policyActive = false;
+    int m_policyInterval = 4;
+    int m_policyTick = 0;
+    double m_policyAction = 0.0;
+
+    // Lqr mode: balance within m_captureAngle (rad) of upright
+    LqrController m_lqr;
+    bool m_lqrActive = false;
+    double m_captureAngle = 0.6;
+
+    // Mpc mode: observations are posted with a running tick count
+    MpcController m_mpc;
+    bool m_mpcActive = false;
+    std::uint64_t m_mpcTick = 0;
 };
\ No newline at end of file
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "FixedODESolver.h"
+#include "ScalarTraits.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+/**
+ * Integrators - family of fixed-step integrators for compile-time state sizes
+ *
+ * Every integrator follows the FixedODESolver policy: a State typedef and
+ *
+ *     template <typename Derivative>
+ *     void stepFixed(double t, State& state, const Derivative& deriv, double dt);
+ *
+ * with the derivative functor writing into caller-owned storage. They trade
+ * accuracy for cost (derivative evaluations per step):
+ *
+ *   SemiImplicitEuler  1   symplectic, 1st order
+ *   VelocityVerlet     3+  symplectic, 2nd order (generalized leapfrog)
+ *   Yoshida4           7+  symplectic, 4th order
+ *   RK4                4   classic Runge-Kutta, 4th order
+ *   DormandPrince87   13   Dormand-Prince 8(7), 8th order (FixedODESolver)
+ *
+ * The symplectic methods assume the state is laid out as [position, velocity]
+ * pairs (e.g. [angle1, angVel1, angle2, angVel2]), which every simulated
+ * system in this project uses; they read the accelerations from the odd
+ * derivative components. N = DYNAMIC_STATE_SIZE works on std::vector state
+ * whose size is only known at runtime. The leapfrog-based methods iterate their implicit
+ * half kick while the accelerations still depend on the velocities, so their
+ * cost grows with that coupling (see GeneralizedLeapfrog).
+ *
+ * All of them take the state's scalar type as a second template parameter
+ * (default double; see FixedODESolver). Step sizes and times stay double.
+ */
+enum class IntegratorType
+{
+    SemiImplicitEuler,
+    VelocityVerlet,
+    Yoshida4,
+    RK4,
+    DormandPrince87
+};
+
+constexpr int INTEGRATOR_TYPE_COUNT = 5;
+
+inline const char* getIntegratorName(IntegratorType type)
+{
+    switch (type) {
+    case IntegratorType::SemiImplicitEuler: return "Semi-implicit Euler";
+    case IntegratorType::VelocityVerlet: return "Velocity Verlet";
+    case IntegratorType::Yoshida4: return "Yoshida 4th order";
+    case IntegratorType::RK4: return "RK4";
+    case IntegratorType::DormandPrince87: return "Dormand-Prince 8(7)";
+    }
+    return "Unknown";
+}
+
+/**
+ * SemiImplicitEulerIntegrator - kick with the acceleration, then drift with the new velocity
+ */
+template <int N, typename Scalar = double>
+class SemiImplicitEulerIntegrator
+{
+    static_assert(N == DYNAMIC_STATE_SIZE || N % 2 == 0, "symplectic integrators need [position, velocity] pairs");
+
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+    using Storage = StateStorage<N, Scalar>;
+
+    template <typename Derivative>
+    void stepFixed(double t, State& state, const Derivative& deriv, double dt)
+    {
+        const int n = static_cast<int>(state.size());
+        Storage::resize(dstate, n);
+
+        deriv(t, state, dstate);
+        for (int i = 0; i < n; i += 2) {
+            state[i + 1] += static_cast<Scalar>(dt) * dstate[i + 1];
+            state[i] += static_cast<Scalar>(dt) * state[i + 1];
+        }
+    }
+
+private:
+    State dstate;
+};
+
+/**
+ * GeneralizedLeapfrog - symmetric kick-drift-kick step for velocity-dependent forces
+ *
+ * The pendulum accelerations depend on the angular velocities (damping,
+ * Coriolis terms), which turns the explicit leapfrog into a first order
+ * method. The generalized leapfrog makes the first half kick implicit:
+ *
+ *     v+ = v + h/2 a(q, v+)        (fixed-point iteration)
+ *     q' = q + h v+
+ *     v' = v+ + h/2 a(q', v+)
+ *
+ * The step is its own adjoint, hence 2nd order and a valid base method for
+ * Yoshida's composition. With velocity-independent forces the first
+ * iteration already converges and it reduces to velocity Verlet.
+ */
+template <int N, typename Scalar = double>
+class GeneralizedLeapfrog
+{
+    static_assert(N == DYNAMIC_STATE_SIZE || N % 2 == 0, "symplectic integrators need [position, velocity] pairs");
+
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+    using Storage = StateStorage<N, Scalar>;
+
+    // Seed the acceleration guess for the first implicit kick of a step
+    template <typename Derivative>
+    void begin(double t, const State& state, const Derivative& deriv)
+    {
+        Storage::resize(accel, state.size());
+        Storage::resize(startVelocity, state.size());
+        deriv(t, state, accel);
+    }
+
+    // One leapfrog step of size h; leaves a(q', v+) as the next kick's guess
+    template <typename Derivative>
+    void step(double t, State& state, const Derivative& deriv, double h)
+    {
+        const Scalar halfH = static_cast<Scalar>(0.5 * h);
+        const int n = static_cast<int>(state.size());
+
+        for (int i = 0; i < n; i += 2) {
+            startVelocity[i] = state[i + 1];
+            state[i + 1] += halfH * accel[i + 1];
+        }
+        for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+            deriv(t, state, accel);
+            double change = 0.0;
+            for (int i = 0; i < n; i += 2) {
+                Scalar v = startVelocity[i] + halfH * accel[i + 1];
+                double value = ScalarTraits<Scalar>::value(v);
+                double previous = ScalarTraits<Scalar>::value(state[i + 1]);
+                change = std::max(change, std::abs(value - previous) / (1.0 + std::abs(value)));
+                state[i + 1] = v;
+            }
+            if (change <= TOLERANCE) break;
+        }
+
+        for (int i = 0; i < n; i += 2) {
+            state[i] += static_cast<Scalar>(h) * state[i + 1];
+        }
+
+        deriv(t + h, state, accel);
+        for (int i = 0; i < n; i += 2) {
+            state[i + 1] += halfH * accel[i + 1];
+        }
+    }
+
+private:
+    static constexpr int MAX_ITERATIONS = 8;
+    // 1e-14 in double; a few ulps for lower-precision scalars
+    static constexpr double TOLERANCE = std::max(1e-14, 4.0 * ScalarTraits<Scalar>::EPSILON);
+
+    State accel;
+    State startVelocity;    // only the even slots are used
+};
+
+/**
+ * VelocityVerletIntegrator - one generalized leapfrog step per update
+ */
+template <int N, typename Scalar = double>
+class VelocityVerletIntegrator
+{
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+
+    template <typename Derivative>
+    void stepFixed(double t, State& state, const Derivative& deriv, double dt)
+    {
+        leapfrog.begin(t, state, deriv);
+        leapfrog.step(t, state, deriv, dt);
+    }
+
+private:
+    GeneralizedLeapfrog<N, Scalar> leapfrog;
+};
+
+/**
+ * Yoshida4Integrator - 4th order symplectic composition of three leapfrog steps
+ *
+ * Substeps of w1 dt, w0 dt, w1 dt with Yoshida's (1990) coefficients
+ * w1 = 1 / (2 - 2^(1/3)), w0 = -2^(1/3) / (2 - 2^(1/3)).
+ */
+template <int N, typename Scalar = double>
+class Yoshida4Integrator
+{
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+
+    template <typename Derivative>
+    void stepFixed(double t, State& state, const Derivative& deriv, double dt)
+    {
+        const double w1 = 1.3512071919596576340476878089715;    // 1 / (2 - 2^(1/3))
+        const double w0 = -1.7024143839193152680953756179429;   // -2^(1/3) / (2 - 2^(1/3))
+
+        leapfrog.begin(t, state, deriv);
+        leapfrog.step(t, state, deriv, w1 * dt);
+        leapfrog.step(t + w1 * dt, state, deriv, w0 * dt);
+        leapfrog.step(t + (w1 + w0) * dt, state, deriv, w1 * dt);
+    }
+
+private:
+    GeneralizedLeapfrog<N, Scalar> leapfrog;
+};
+
+/**
+ * RK4Integrator - classic 4th order Runge-Kutta
+ */
+template <int N, typename Scalar = double>
+class RK4Integrator
+{
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+    using Storage = StateStorage<N, Scalar>;
+
+    template <typename Derivative>
+    void stepFixed(double t, State& state, const Derivative& deriv, double dt)
+    {
+        const double halfDt = 0.5 * dt;
+        const Scalar halfStep = static_cast<Scalar>(halfDt);
+        const Scalar fullStep = static_cast<Scalar>(dt);
+        const Scalar two = static_cast<Scalar>(2.0);
+        const int n = static_cast<int>(state.size());
+        Storage::resize(k1, n);
+        Storage::resize(k2, n);
+        Storage::resize(k3, n);
+        Storage::resize(k4, n);
+        Storage::resize(tempState, n);
+
+        deriv(t, state, k1);
+        for (int i = 0; i < n; ++i) tempState[i] = state[i] + halfStep * k1[i];
+        deriv(t + halfDt, tempState, k2);
+        for (int i = 0; i < n; ++i) tempState[i] = state[i] + halfStep * k2[i];
+        deriv(t + halfDt, tempState, k3);
+        for (int i = 0; i < n; ++i) tempState[i] = state[i] + fullStep * k3[i];
+        deriv(t + dt, tempState, k4);
+
+        for (int i = 0; i < n; ++i) {
+            state[i] += static_cast<Scalar>(dt / 6.0) * (k1[i] + two * k2[i] + two * k3[i] + k4[i]);
+        }
+    }
+
+private:
+    State k1, k2, k3, k4;
+    State tempState;
+};
+
+/**
+ * IntegratorSet - one workspace per integrator, dispatched by IntegratorType
+ *
+ * Lets a simulated system pick its integrator at runtime while each
+ * integrator's step stays a fully inlined template instantiation.
+ */
+template <int N, typename Scalar = double>
+class IntegratorSet
+{
+public:
+    using State = typename StateStorage<N, Scalar>::type;
+
+    template <typename Derivative>
+    void stepFixed(IntegratorType type, double t, State& state, const Derivative& deriv, double dt)
+    {
+        switch (type) {
+        case IntegratorType::SemiImplicitEuler: semiImplicitEuler.stepFixed(t, state, deriv, dt); break;
+        case IntegratorType::VelocityVerlet: velocityVerlet.stepFixed(t, state, deriv, dt); break;
+        case IntegratorType::Yoshida4: yoshida4.stepFixed(t, state, deriv, dt); break;
+        case IntegratorType::RK4: rk4.stepFixed(t, state, deriv, dt); break;
+        case IntegratorType::DormandPrince87: dormandPrince87.stepFixed(t, state, deriv, dt); break;
+        }
+    }
+
+private:
+    SemiImplicitEulerIntegrator<N, Scalar> semiImplicitEuler;
+    VelocityVerletIntegrator<N, Scalar> velocityVerlet;
+    Yoshida4Integrator<N, Scalar> yoshida4;
+    RK4Integrator<N, Scalar> rk4;
+    FixedODESolver<N, Scalar> dormandPrince87;
+};
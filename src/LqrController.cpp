@@ -0,0 +1,286 @@
+#include "LqrController.h"
+#include "DoublePendulum.h"
+#include "SinglePendulum.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+    constexpr int N = LqrController::MAX_STATE;
+
+    // Dense n x n matrices (n <= MAX_STATE), row-major in fixed storage
+    struct Matrix
+    {
+        int n = 0;
+        std::array<double, N * N> a = {};
+
+        explicit Matrix(int size) : n(size) {}
+        double& operator()(int row, int col) { return a[row * N + col]; }
+        double operator()(int row, int col) const { return a[row * N + col]; }
+
+        static Matrix identity(int size)
+        {
+            Matrix m(size);
+            for (int i = 0; i < size; ++i) m(i, i) = 1.0;
+            return m;
+        }
+    };
+
+    Matrix multiply(const Matrix& x, const Matrix& y)
+    {
+        Matrix r(x.n);
+        for (int i = 0; i < x.n; ++i) {
+            for (int k = 0; k < x.n; ++k) {
+                const double xik = x(i, k);
+                for (int j = 0; j < x.n; ++j) r(i, j) += xik * y(k, j);
+            }
+        }
+        return r;
+    }
+
+    Matrix transpose(const Matrix& x)
+    {
+        Matrix r(x.n);
+        for (int i = 0; i < x.n; ++i) {
+            for (int j = 0; j < x.n; ++j) r(i, j) = x(j, i);
+        }
+        return r;
+    }
+
+    Matrix add(const Matrix& x, const Matrix& y)
+    {
+        Matrix r(x.n);
+        for (int i = 0; i < N * N; ++i) r.a[i] = x.a[i] + y.a[i];
+        return r;
+    }
+
+    double maxAbs(const Matrix& x)
+    {
+        double m = 0.0;
+        for (double v : x.a) m = std::max(m, std::abs(v));
+        return m;
+    }
+
+    // Gauss-Jordan with partial pivoting; false when (numerically) singular
+    bool invert(const Matrix& x, Matrix& inverse)
+    {
+        Matrix m = x;
+        inverse = Matrix::identity(x.n);
+        for (int col = 0; col < x.n; ++col) {
+            int pivot = col;
+            for (int row = col + 1; row < x.n; ++row) {
+                if (std::abs(m(row, col)) > std::abs(m(pivot, col))) pivot = row;
+            }
+            if (!(std::abs(m(pivot, col)) > 1e-300)) return false;
+            for (int j = 0; j < x.n; ++j) {
+                std::swap(m(col, j), m(pivot, j));
+                std::swap(inverse(col, j), inverse(pivot, j));
+            }
+            const double scale = 1.0 / m(col, col);
+            for (int j = 0; j < x.n; ++j) {
+                m(col, j) *= scale;
+                inverse(col, j) *= scale;
+            }
+            for (int row = 0; row < x.n; ++row) {
+                const double factor = m(row, col);
+                if (row == col || factor == 0.0) continue;
+                for (int j = 0; j < x.n; ++j) {
+                    m(row, j) -= factor * m(col, j);
+                    inverse(row, j) -= factor * inverse(col, j);
+                }
+            }
+        }
+        return true;
+    }
+
+    double wrapAngle(double angle)
+    {
+        return std::remainder(angle, 2.0 * PI);
+    }
+}
+
+LqrController::LqrController(const LqrWeights& weights)
+    : m_weights(weights)
+{
+}
+
+void LqrController::setWeights(const LqrWeights& weights)
+{
+    m_weights = weights;
+    m_cache.clear();
+    m_active = nullptr;
+}
+
+LqrController::Key LqrController::makeKey(const Pendulum& pendulum, double dt, double friction)
+{
+    const int links = pendulum.getNumAngles();
+    return { static_cast<double>(links),
+        pendulum.getLinkMass(0), pendulum.getLinkLength(0),
+        links > 1 ? pendulum.getLinkMass(1) : 0.0, links > 1 ? pendulum.getLinkLength(1) : 0.0,
+        pendulum.getGravity(), pendulum.getDamping(), friction, dt,
+        static_cast<double>(pendulum.getIntegrator()) };
+}
+
+bool LqrController::setModel(const Pendulum& pendulum, double dt, double friction)
+{
+    const Key key = makeKey(pendulum, dt, friction);
+    if (m_active && key == m_activeKey) return m_active->stabilizing;
+
+    auto found = m_cache.find(key);
+    if (found == m_cache.end()) {
+        if (m_cache.size() >= MAX_CACHED) m_cache.clear();
+        found = m_cache.emplace(key, solve(pendulum, dt, friction, m_weights)).first;
+        ++m_solveCount;
+    }
+    m_activeKey = key;
+    m_active = &found->second;
+    return m_active->stabilizing;
+}
+
+double LqrController::act(const double* observation, int observationSize) const
+{
+    if (!hasModel() || observationSize != m_active->stateSize) return 0.0;
+
+    // State error: angles measured from upright (pi in the hanging-zero convention)
+    double acceleration = -m_active->k[0] * observation[0] - m_active->k[1] * observation[1];
+    for (int i = 2; i < observationSize; i += 2) {
+        acceleration -= m_active->k[i] * wrapAngle(observation[i] - PI) + m_active->k[i + 1] * observation[i + 1];
+    }
+    return acceleration;
+}
+
+double LqrController::uprightError(const double* observation, int observationSize)
+{
+    double error = 0.0;
+    for (int i = 2; i < observationSize; i += 2) {
+        error = std::max(error, std::abs(wrapAngle(observation[i] - PI)));
+    }
+    return error;
+}
+
+LqrController::Gains LqrController::solve(const Pendulum& pendulum, double dt, double friction,
+    const LqrWeights& weights)
+{
+    Gains gains;
+    const int links = pendulum.getNumAngles();
+    if (links > 2 || !(dt > 0.0)) return gains;
+    const int n = 2 + 2 * links;
+    gains.stateSize = n;
+
+    // Linear model z' = A z + B a around upright, z = [x, v, dtheta1, omega1, ...]
+    Matrix A(n);
+    std::array<double, N> B = {};
+
+    // Cart block: Cart::update is linear in (x, v, a) off the rail ends
+    for (int column = 0; column < 3; ++column) {
+        Cart cart(1.0, 1e9);
+        cart.setIntegrator(pendulum.getIntegrator());
+        cart.setPosition(column == 0 ? 1.0 : 0.0);
+        cart.setVelocity(column == 1 ? 1.0 : 0.0);
+        cart.update(dt, column == 2 ? 1.0 : 0.0, friction, pendulum.getGravity());
+        if (column < 2) {
+            A(0, column) = cart.getPosition();
+            A(1, column) = cart.getVelocity();
+        }
+        else {
+            B[0] = cart.getPosition();
+            B[1] = cart.getVelocity();
+        }
+    }
+
+    // Pendulum block: the exact step Jacobian at the upright equilibrium
+    if (links == 1) {
+        SinglePendulum upright(pendulum.getLinkMass(0), pendulum.getLinkLength(0));
+        upright.setGravity(pendulum.getGravity());
+        upright.setDamping(pendulum.getDamping());
+        upright.setIntegrator(pendulum.getIntegrator());
+        upright.setAngle(PI);
+        std::array<double, 2> next;
+        SinglePendulum::StepJacobian jacobian;
+        upright.computeStepJacobian(dt, 0.0, next, jacobian);
+        for (int row = 0; row < 2; ++row) {
+            for (int col = 0; col < 2; ++col) A(2 + row, 2 + col) = jacobian[row][col];
+            B[2 + row] = jacobian[row][2];
+        }
+    }
+    else {
+        DoublePendulum upright(pendulum.getLinkMass(0), pendulum.getLinkLength(0),
+            pendulum.getLinkMass(1), pendulum.getLinkLength(1));
+        upright.setGravity(pendulum.getGravity());
+        upright.setDamping(pendulum.getDamping());
+        upright.setIntegrator(pendulum.getIntegrator());
+        upright.setAngle(0, PI);
+        upright.setAngle(1, PI);
+        std::array<double, 4> next;
+        DoublePendulum::StepJacobian jacobian;
+        upright.computeStepJacobian(dt, 0.0, next, jacobian);
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) A(2 + row, 2 + col) = jacobian[row][col];
+            B[2 + row] = jacobian[row][4];
+        }
+    }
+
+    Matrix Q(n);
+    Q(0, 0) = weights.position;
+    Q(1, 1) = weights.velocity;
+    for (int link = 0; link < links; ++link) {
+        Q(2 + 2 * link, 2 + 2 * link) = weights.angle;
+        Q(3 + 2 * link, 3 + 2 * link) = weights.angularVelocity;
+    }
+    const double R = weights.control;
+    if (!(R > 0.0)) return gains;
+
+    // Structure-preserving doubling for P = Q + A'PA - A'PB (R + B'PB)^-1 B'PA:
+    //   W = (I + G H)^-1,  A <- A W A,  G <- G + A W G A',  H <- H + A' H W A
+    // starting from G = B R^-1 B', H = Q; H converges to P
+    Matrix Ak = A;
+    Matrix G(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) G(i, j) = B[i] * B[j] / R;
+    }
+    Matrix H = Q;
+    const Matrix I = Matrix::identity(n);
+    bool converged = false;
+    for (int iteration = 1; iteration <= 64 && !converged; ++iteration) {
+        Matrix W(n);
+        if (!invert(add(I, multiply(G, H)), W)) return gains;
+        const Matrix AW = multiply(Ak, W);
+        const Matrix At = transpose(Ak);
+        const Matrix nextG = add(G, multiply(multiply(AW, G), At));
+        const Matrix nextH = add(H, multiply(multiply(multiply(At, H), W), Ak));
+        Ak = multiply(AW, Ak);
+
+        double change = 0.0;
+        for (int i = 0; i < N * N; ++i) change = std::max(change, std::abs(nextH.a[i] - H.a[i]));
+        converged = change <= 1e-12 * maxAbs(nextH);
+        G = nextG;
+        H = nextH;
+        gains.iterations = iteration;
+    }
+    if (!converged) return gains;
+
+    // K = (R + B'PB)^-1 B'PA
+    std::array<double, N> PB = {};
+    double BPB = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) PB[i] += H(i, j) * B[j];
+        BPB += B[i] * PB[i];
+    }
+    for (int j = 0; j < n; ++j) {
+        double BPA = 0.0;
+        for (int i = 0; i < n; ++i) BPA += PB[i] * A(i, j);
+        gains.k[j] = BPA / (R + BPB);
+    }
+
+    // Closed loop A - B K must decay: square it up to 2^20 ticks
+    Matrix closed = A;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) closed(i, j) -= B[i] * gains.k[j];
+    }
+    for (int squaring = 0; squaring < 20 && maxAbs(closed) < 1e12; ++squaring) {
+        closed = multiply(closed, closed);
+    }
+    gains.stabilizing = maxAbs(closed) < 1e-3;
+    return gains;
+}
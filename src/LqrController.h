@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Cart.h"
+#include "Pendulum.h"
+#include <array>
+#include <cstddef>
+#include <map>
+
+/**
+ * LqrWeights - quadratic cost of LqrController
+ *
+ * Stage cost per physics tick: position * x^2 + velocity * v^2 +
+ * sum over links of (angle * dtheta^2 + angularVelocity * omega^2) +
+ * control * a^2, with dtheta the angle away from upright and a the cart
+ * acceleration (m/s^2).
+ */
+struct LqrWeights
+{
+    double position = 1.0;
+    double velocity = 1.0;
+    double angle = 100.0;
+    double angularVelocity = 1.0;
+    double control = 0.01;
+};
+
+/**
+ * LqrController - balances a single or double pendulum upright on the cart
+ *
+ * The tick-to-tick map of the uncoupled model (Cart::update followed by
+ * Pendulum::update with the selected integrator and dt) is linearized
+ * around the upright equilibrium: the pendulum block comes from
+ * computeStepJacobian (dual numbers), the cart block from stepping a Cart
+ * on unit states (its update is linear away from the rail ends). The
+ * discrete algebraic Riccati equation for that model is solved by the
+ * structure-preserving doubling algorithm, which converges quadratically
+ * (a few dozen small dense iterations) where plain Riccati iteration
+ * would need thousands at 144 Hz.
+ *
+ * Gains are cached in a table keyed by the parameters the linearization
+ * depends on: link count, link masses and lengths, gravity, damping, cart
+ * friction, dt and integrator. setModel() is meant to be called every tick
+ * with the live objects; it compares the key with the previous call and
+ * only looks up (or solves) when a parameter has changed, so the steady
+ * state cost of the controller is the key comparison plus one dot product.
+ *
+ * Chains of three or more links are not handled (setModel() returns false).
+ */
+class LqrController
+{
+public:
+    static constexpr int MAX_STATE = 6;             // [x, v, dtheta1, omega1, dtheta2, omega2]
+    static constexpr std::size_t MAX_CACHED = 1024; // the table is dropped when it fills up
+
+    struct Gains
+    {
+        std::array<double, MAX_STATE> k = {};       // a = -k . state error
+        int stateSize = 0;
+        int iterations = 0;                         // doubling steps to convergence
+        bool stabilizing = false;                   // closed loop verified to decay
+    };
+
+    explicit LqrController(const LqrWeights& weights = LqrWeights());
+
+    // Weights are part of every cached solution: changing them clears the table
+    void setWeights(const LqrWeights& weights);
+    const LqrWeights& getWeights() const { return m_weights; }
+
+    // Select the gains for this system (cached). False for unsupported link
+    // counts or when no stabilizing solution was found; act() then returns 0.
+    bool setModel(const Pendulum& pendulum, double dt, double friction);
+    bool hasModel() const { return m_active && m_active->stabilizing; }
+    const Gains* getGains() const { return m_active; }
+
+    // Cart acceleration for a PendulumEnv observation [x, v, angle1, angVel1, ...]
+    // of the current model's link count (0 on a size mismatch)
+    double act(const double* observation, int observationSize) const;
+    // Largest |angle from upright| over the links of an observation
+    static double uprightError(const double* observation, int observationSize);
+
+    // Solve without the cache (benchmarks, tools)
+    static Gains solve(const Pendulum& pendulum, double dt, double friction, const LqrWeights& weights);
+
+    std::size_t getCacheSize() const { return m_cache.size(); }
+    long long getSolveCount() const { return m_solveCount; }
+
+private:
+    using Key = std::array<double, 10>;
+
+    LqrWeights m_weights;
+    std::map<Key, Gains> m_cache;
+    Key m_activeKey = {};
+    const Gains* m_active = nullptr;
+    long long m_solveCount = 0;
+
+    static Key makeKey(const Pendulum& pendulum, double dt, double friction);
+};
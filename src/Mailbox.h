@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Mailbox - lock-free latest-value exchange between two threads
+ *
+ * One writer publishes values, one reader picks up the most recent one;
+ * intermediate values the reader never saw are dropped. Three slots
+ * (triple buffering): the writer fills its back slot and swaps it with the
+ * shared middle slot, the reader swaps the middle slot with its front slot
+ * when a new value is there. Both sides are wait-free - one atomic
+ * exchange - and never touch the slot the other side is using, so T is
+ * copied in and out without locks or torn reads. Slots are on separate
+ * cache lines.
+ *
+ * T should be trivially copyable; write() and read() must each be called
+ * from a single thread.
+ */
+template <typename T>
+class Mailbox
+{
+public:
+    Mailbox() = default;
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    // Writer: slot to fill, then publish() it (or write() in one call)
+    T& beginWrite() { return m_slots[m_back].value; }
+    void publish()
+    {
+        m_back = m_middle.exchange(static_cast<std::uint8_t>(m_back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+    void write(const T& value)
+    {
+        beginWrite() = value;
+        publish();
+    }
+
+    // Reader: true when a value newer than the last read was published;
+    // getFront() is the latest value read (default-constructed before any)
+    bool read()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& getFront() const { return m_slots[m_front].value; }
+
+private:
+    static constexpr std::uint8_t INDEX = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4;
+
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    Slot m_slots[3];
+    alignas(64) std::atomic<std::uint8_t> m_middle{ 1 };
+    alignas(64) std::uint8_t m_back = 2;        // writer only
+    alignas(64) std::uint8_t m_front = 0;       // reader only
+};
@@ -0,0 +1,150 @@
+#include "MlpPolicy.h"
+#include "SimdDispatch.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+    const char FILE_MAGIC[4] = { 'P', 'M', 'L', 'P' };
+    constexpr std::uint32_t FILE_VERSION = 1;
+
+    std::size_t countParameters(const std::vector<int>& sizes)
+    {
+        std::size_t count = 0;
+        for (std::size_t layer = 0; layer + 1 < sizes.size(); ++layer) {
+            count += static_cast<std::size_t>(sizes[layer + 1]) * (sizes[layer] + 1);
+        }
+        return count;
+    }
+}
+
+MlpPolicy::MlpPolicy(const std::vector<int>& layerSizes)
+{
+    if (!isValidShape(layerSizes)) {
+        std::cerr << "ERROR: MlpPolicy needs at least input and output sizes in [1, "
+            << MAX_WIDTH << "]" << std::endl;
+        return;
+    }
+    m_sizes = layerSizes;
+    m_parameters.assign(countParameters(m_sizes), 0.0f);
+}
+
+bool MlpPolicy::isValidShape(const std::vector<int>& sizes)
+{
+    if (sizes.size() < 2) return false;
+    for (int size : sizes) {
+        if (size < 1 || size > MAX_WIDTH) return false;
+    }
+    return true;
+}
+
+bool MlpPolicy::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR: Failed to open policy file: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint32_t layers = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&layers), sizeof(layers));
+    if (!file || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || version != FILE_VERSION
+        || layers < 1 || layers > 64) {
+        std::cerr << "ERROR: Not a version " << FILE_VERSION << " policy file: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint32_t> rawSizes(layers + 1);
+    file.read(reinterpret_cast<char*>(rawSizes.data()), rawSizes.size() * sizeof(std::uint32_t));
+    std::vector<int> sizes;
+    for (std::uint32_t size : rawSizes) {
+        sizes.push_back(static_cast<int>(std::min<std::uint32_t>(size, MAX_WIDTH + 1)));
+    }
+    if (!file || !isValidShape(sizes)) {
+        std::cerr << "ERROR: Policy layer sizes must be in [1, " << MAX_WIDTH << "]: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<float> parameters(countParameters(sizes));
+    file.read(reinterpret_cast<char*>(parameters.data()), parameters.size() * sizeof(float));
+    if (!file) {
+        std::cerr << "ERROR: Policy file is truncated: " << path << std::endl;
+        return false;
+    }
+
+    m_sizes = std::move(sizes);
+    m_parameters = std::move(parameters);
+    return true;
+}
+
+bool MlpPolicy::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !isLoaded()) {
+        std::cerr << "ERROR: Failed to write policy file: " << path << std::endl;
+        return false;
+    }
+    std::uint32_t version = FILE_VERSION;
+    std::uint32_t layers = static_cast<std::uint32_t>(m_sizes.size() - 1);
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.write(reinterpret_cast<const char*>(&layers), sizeof(layers));
+    for (int size : m_sizes) {
+        std::uint32_t value = static_cast<std::uint32_t>(size);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    file.write(reinterpret_cast<const char*>(m_parameters.data()), m_parameters.size() * sizeof(float));
+    if (!file) {
+        std::cerr << "ERROR: Failed to write policy file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void MlpPolicy::evaluate(const double* observation, double* actions) const
+{
+    evaluateBlock(observation, 1, actions);
+}
+
+double MlpPolicy::act(const double* observation) const
+{
+    double actions[MAX_WIDTH];
+    evaluateBlock(observation, 1, actions);
+    return actions[0];
+}
+
+void MlpPolicy::evaluateBatch(const double* observations, std::size_t count, double* actions) const
+{
+    const std::size_t inputSize = static_cast<std::size_t>(getInputSize());
+    const std::size_t outputSize = static_cast<std::size_t>(getOutputSize());
+    const std::size_t width = static_cast<std::size_t>(getBlockWidth());
+    for (std::size_t first = 0; first < count; first += width) {
+        int lanes = static_cast<int>(std::min(width, count - first));
+        evaluateBlock(observations + first * inputSize, lanes, actions + first * outputSize);
+    }
+}
+
+int MlpPolicy::getBlockWidth()
+{
+    return getSimdKernels().policy.width;
+}
+
+void MlpPolicy::evaluateBlock(const double* observations, int lanes, double* actions) const
+{
+    if (!isLoaded()) {
+        std::fill(actions, actions + static_cast<std::size_t>(lanes) * std::max(1, getOutputSize()), 0.0);
+        return;
+    }
+
+    getSimdKernels().policy.evaluateBlock(m_sizes.data(), m_sizes.size(), m_parameters.data(),
+        observations, lanes, actions);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * MlpPolicy - small fully connected network mapping an observation to
+ * actions in [-1, 1]
+ *
+ * Every layer is y = tanh(W x + b): tanh on the hidden layers and on the
+ * output, which keeps actions in the PendulumEnv range. The input is the
+ * PendulumEnv observation (2 + 2 * numLinks doubles); the first output is
+ * the cart action, scaled by the maximum acceleration like the A/D keys.
+ *
+ * Inference runs in float with SimdFloat: a block of getBlockWidth()
+ * observations is transposed so each lane holds one observation, then
+ * every layer is a sequence of broadcast-weight multiply-adds over the
+ * block. The block kernel is picked at runtime for the CPU (SimdDispatch.h).
+ * A single evaluate() is a block with one live lane through the same
+ * kernel, so the viewer and the batched headless path compute
+ * bit-identical actions. All scratch lives
+ * on the stack (layers are at most MAX_WIDTH wide): the evaluation calls
+ * are const, allocation free and safe to call from several threads.
+ *
+ * Weights file (little endian):
+ *   char[4]  "PMLP"
+ *   uint32   version (1)
+ *   uint32   number of layers L
+ *   uint32   sizes[L + 1]          input size, hidden sizes..., output size
+ *   per layer l: float32 W[sizes[l+1]][sizes[l]] (row-major), float32 b[sizes[l+1]]
+ *
+ * getParameters() exposes the same per-layer (W, b) sequence as one flat
+ * float array, for trainers that perturb or optimize it in place.
+ */
+class MlpPolicy
+{
+public:
+    static constexpr int MAX_WIDTH = 256;
+
+    MlpPolicy() = default;
+    // Zero-initialized network with the given sizes (input, hidden..., output)
+    explicit MlpPolicy(const std::vector<int>& layerSizes);
+
+    // Both print an error and return false on failure; a failed load
+    // leaves the previous network in place
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    bool isLoaded() const { return !m_parameters.empty(); }
+    int getInputSize() const { return m_sizes.empty() ? 0 : m_sizes.front(); }
+    int getOutputSize() const { return m_sizes.empty() ? 0 : m_sizes.back(); }
+    const std::vector<int>& getLayerSizes() const { return m_sizes; }
+
+    std::size_t getParameterCount() const { return m_parameters.size(); }
+    float* getParameters() { return m_parameters.data(); }
+    const float* getParameters() const { return m_parameters.data(); }
+
+    // getOutputSize() actions for one observation of getInputSize() doubles
+    void evaluate(const double* observation, double* actions) const;
+    // First action only
+    double act(const double* observation) const;
+
+    // count observations (row-major, getInputSize() doubles each) to
+    // count x getOutputSize() actions
+    void evaluateBatch(const double* observations, std::size_t count, double* actions) const;
+
+    // Observations per SIMD block in the kernel evaluateBatch() runs now
+    static int getBlockWidth();
+
+private:
+    std::vector<int> m_sizes;
+    std::vector<float> m_parameters;
+
+    static bool isValidShape(const std::vector<int>& sizes);
+    void evaluateBlock(const double* observations, int lanes, double* actions) const;
+};
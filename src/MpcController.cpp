@@ -0,0 +1,174 @@
+#include "MpcController.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+MpcController::MpcController(const IlqrConfig& config)
+    : m_config(config)
+{
+}
+
+MpcController::~MpcController()
+{
+    stop();
+}
+
+bool MpcController::Model::operator==(const Model& other) const
+{
+    return links == other.links && mass[0] == other.mass[0] && mass[1] == other.mass[1]
+        && length[0] == other.length[0] && length[1] == other.length[1] && gravity == other.gravity
+        && damping == other.damping && friction == other.friction && dt == other.dt
+        && railLength == other.railLength;
+}
+
+void MpcController::start()
+{
+    if (isRunning()) return;
+    m_running.store(true, std::memory_order_relaxed);
+    // The thread starts from the last posted model; states and plans of a
+    // previous run are stale
+    m_models.write(m_model);
+    m_inputs.write(Input());
+    m_plans.write(MpcPlan());
+    m_thread = std::thread(&MpcController::run, this);
+}
+
+void MpcController::stop()
+{
+    if (!isRunning()) return;
+    m_running.store(false, std::memory_order_relaxed);
+    m_thread.join();
+}
+
+void MpcController::setConfig(const IlqrConfig& config)
+{
+    const bool running = isRunning();
+    stop();
+    m_config = config;
+    if (running) start();
+}
+
+bool MpcController::setModel(const Pendulum& pendulum, double dt, double friction, double railLength)
+{
+    Model model;
+    model.links = pendulum.getNumAngles();
+    if (model.links > 2) return false;
+    for (int link = 0; link < model.links; ++link) {
+        model.mass[link] = pendulum.getLinkMass(link);
+        model.length[link] = pendulum.getLinkLength(link);
+    }
+    model.gravity = pendulum.getGravity();
+    model.damping = pendulum.getDamping();
+    model.friction = friction;
+    model.dt = dt;
+    model.railLength = railLength;
+    if (!(model == m_model)) {
+        m_model = model;
+        m_models.write(model);
+    }
+    return true;
+}
+
+void MpcController::setState(std::uint64_t tick, const double* observation, int observationSize)
+{
+    if (observationSize > IlqrSolver::MAX_STATE) return;
+    Input& input = m_inputs.beginWrite();
+    input.tick = tick;
+    input.stateSize = observationSize;
+    std::copy(observation, observation + observationSize, input.state);
+    m_inputs.publish();
+}
+
+bool MpcController::getAcceleration(std::uint64_t tick, const double* observation, int observationSize,
+    double& acceleration)
+{
+    m_plans.read();
+    const MpcPlan& plan = m_plans.getFront();
+    if (plan.steps == 0 || plan.stateSize != observationSize || tick < plan.tick) return false;
+    const std::uint64_t step = (tick - plan.tick) / static_cast<std::uint64_t>(plan.ticksPerStep);
+    if (step >= static_cast<std::uint64_t>(plan.steps)) return false;
+
+    const double PI = 3.14159265358979323846;
+    double a = plan.action[step];
+    for (int i = 0; i < observationSize; ++i) {
+        double error = observation[i] - plan.nominal[step][i];
+        if (i >= 2 && i % 2 == 0) error = std::remainder(error, 2.0 * PI);
+        a += plan.gain[step][i] * error;
+    }
+    acceleration = std::clamp(a, -m_config.maxAcceleration, m_config.maxAcceleration);
+    return true;
+}
+
+void MpcController::run()
+{
+    // Everything the thread touches per solve is allocated here, up front
+    IlqrSolver solver(m_config);
+    SinglePendulum single(1.0, 1.0);
+    DoublePendulum pair(1.0, 1.0, 1.0, 1.0);
+    bool haveModel = false;
+    bool haveSolution = false;
+    std::uint64_t lastTick = 0;
+    std::uint64_t solveCount = 0;
+    double maxSolveSeconds = 0.0;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (m_models.read()) {
+            const Model& model = m_models.getFront();
+            Pendulum* pendulum = nullptr;
+            if (model.links == 1) {
+                single.setMass(model.mass[0]);
+                single.setLength(model.length[0]);
+                pendulum = &single;
+            }
+            else if (model.links == 2) {
+                for (int link = 0; link < 2; ++link) {
+                    pair.setMass(link, model.mass[link]);
+                    pair.setLength(link, model.length[link]);
+                }
+                pendulum = &pair;
+            }
+            haveModel = pendulum != nullptr;
+            if (haveModel) {
+                pendulum->setGravity(model.gravity);
+                pendulum->setDamping(model.damping);
+                haveModel = solver.setModel(*pendulum, model.dt, model.friction, model.railLength);
+            }
+            solver.resetControls();
+            haveSolution = false;
+        }
+
+        if (!haveModel || !m_inputs.read() || m_inputs.getFront().stateSize != solver.getStateSize()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        // Warm start: drop the control steps executed since the last solve
+        const Input& input = m_inputs.getFront();
+        const int ticksPerStep = solver.getConfig().ticksPerStep;
+        if (haveSolution && input.tick > lastTick) {
+            const std::uint64_t elapsed = (input.tick - lastTick + ticksPerStep / 2) / ticksPerStep;
+            solver.shift(static_cast<int>(std::min<std::uint64_t>(elapsed, solver.getConfig().horizon)));
+        }
+        const IlqrSolver::SolveStats& stats = solver.solve(input.state);
+        lastTick = input.tick;
+        haveSolution = true;
+        maxSolveSeconds = std::max(maxSolveSeconds, stats.seconds);
+
+        MpcPlan& plan = m_plans.beginWrite();
+        plan.tick = input.tick;
+        plan.steps = std::min(MpcPlan::MAX_STEPS, solver.getConfig().horizon);
+        plan.ticksPerStep = ticksPerStep;
+        plan.stateSize = solver.getStateSize();
+        for (int step = 0; step < plan.steps; ++step) {
+            plan.action[step] = solver.getAction(step);
+            std::copy(solver.getGain(step), solver.getGain(step) + plan.stateSize, plan.gain[step]);
+            std::copy(solver.getNominalState(step), solver.getNominalState(step) + plan.stateSize, plan.nominal[step]);
+        }
+        plan.solveCount = ++solveCount;
+        plan.iterations = stats.iterations;
+        plan.solveSeconds = stats.seconds;
+        plan.maxSolveSeconds = maxSolveSeconds;
+        plan.budgetHit = stats.budgetHit;
+        m_plans.publish();
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "IlqrSolver.h"
+#include "Mailbox.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * MpcPlan - what the MPC thread publishes after every solve
+ *
+ * The first `steps` control steps of the optimized trajectory, starting at
+ * physics tick `tick` (the tick of the state it was solved from): the
+ * action, feedback gain and nominal state of each step.
+ */
+struct MpcPlan
+{
+    static constexpr int MAX_STEPS = 32;
+
+    std::uint64_t tick = 0;
+    int steps = 0;                      // 0 = no plan yet
+    int ticksPerStep = 1;
+    int stateSize = 0;
+    double action[MAX_STEPS] = {};
+    double gain[MAX_STEPS][IlqrSolver::MAX_STATE] = {};
+    double nominal[MAX_STEPS][IlqrSolver::MAX_STATE] = {};
+
+    // Solve that produced the plan
+    std::uint64_t solveCount = 0;
+    int iterations = 0;
+    double solveSeconds = 0.0;
+    double maxSolveSeconds = 0.0;       // since start()
+    bool budgetHit = false;
+};
+
+/**
+ * MpcController - receding-horizon iLQR on its own thread
+ *
+ * The control loop posts the measured state every tick (setState) and
+ * asks for the acceleration to apply (getAcceleration); the MPC thread
+ * repeatedly takes the newest state, shifts its previous solution by the
+ * control steps that have elapsed since (warm start), runs IlqrSolver
+ * under its hard time budget and publishes an MpcPlan. State, model and
+ * plan travel through Mailboxes, so neither side ever waits for the other.
+ *
+ * Between plans the loop follows the latest one with its feedback gains,
+ * a = action[i] + gain[i] . (z - nominal[i]) for the step i covering the
+ * current tick, which absorbs the solve latency. A plan older than its
+ * MAX_STEPS steps is not used.
+ */
+class MpcController
+{
+public:
+    explicit MpcController(const IlqrConfig& config = IlqrConfig());
+    ~MpcController();
+
+    MpcController(const MpcController&) = delete;
+    MpcController& operator=(const MpcController&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    // Takes effect on the next start() (restarts a running controller)
+    void setConfig(const IlqrConfig& config);
+    const IlqrConfig& getConfig() const { return m_config; }
+
+    // Control loop side. setModel() is cheap when nothing changed (call it
+    // every tick); a changed model restarts the optimization from scratch.
+    bool setModel(const Pendulum& pendulum, double dt, double friction, double railLength);
+    void setState(std::uint64_t tick, const double* observation, int observationSize);
+    // False while there is no usable plan for this tick and state size
+    bool getAcceleration(std::uint64_t tick, const double* observation, int observationSize,
+        double& acceleration);
+    // Latest plan seen by getAcceleration()
+    const MpcPlan& getPlan() const { return m_plans.getFront(); }
+
+private:
+    struct Model
+    {
+        int links = 0;
+        double mass[2] = {};
+        double length[2] = {};
+        double gravity = 0.0;
+        double damping = 0.0;
+        double friction = 0.0;
+        double dt = 0.0;
+        double railLength = 0.0;
+
+        bool operator==(const Model& other) const;
+    };
+
+    struct Input
+    {
+        std::uint64_t tick = 0;
+        int stateSize = 0;
+        double state[IlqrSolver::MAX_STATE] = {};
+    };
+
+    IlqrConfig m_config;
+    Model m_model;                      // last posted (control loop side)
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+
+    Mailbox<Model> m_models;
+    Mailbox<Input> m_inputs;
+    Mailbox<MpcPlan> m_plans;
+
+    void run();
+};
@@ -2,47 +2,40 @@
 #include <cmath>
 #include <algorithm>
 
-// Dormand-Prince 8(7) a matrix coefficients
-const double ODESolver::a[STAGES][STAGES] = {
-    {0.0},
-    {1.0 / 18.0},
-    {1.0 / 48.0, 1.0 / 16.0},
-    {1.0 / 32.0, 0.0, 3.0 / 32.0},
-    {5.0 / 16.0, 0.0, -75.0 / 64.0, 75.0 / 64.0},
-    {3.0 / 80.0, 0.0, 0.0, 3.0 / 16.0, 3.0 / 20.0},
-    {29443841.0 / 614563906.0, 0.0, 0.0, 77736538.0 / 692538347.0, -28693883.0 / 1125000000.0, 23124283.0 / 1800000000.0},
-    {16016141.0 / 946692911.0, 0.0, 0.0, 61564180.0 / 158732637.0, 22789713.0 / 633445777.0, 545815736.0 / 2771057229.0, -180193667.0 / 1043307555.0},
-    {39632708.0 / 573591083.0, 0.0, 0.0, -433636366.0 / 683701615.0, -421739975.0 / 2616292301.0, 100302831.0 / 723423059.0, 790204164.0 / 839813087.0, 800635310.0 / 3783071287.0},
-    {246121993.0 / 1340847787.0, 0.0, 0.0, -37695042795.0 / 15268766246.0, -309121744.0 / 1061227803.0, -12992083.0 / 490766935.0, 6005943493.0 / 2108947869.0, 393006217.0 / 1396673457.0, 123872331.0 / 1001029789.0},
-    {-1028468189.0 / 846180014.0, 0.0, 0.0, 8478235783.0 / 508512852.0, 1311729495.0 / 1432422823.0, -10304129995.0 / 1701304382.0, -48777925059.0 / 3047939560.0, 15336726248.0 / 1032824649.0, -45442868181.0 / 3398467696.0, 3065993473.0 / 597172653.0},
-    {185892177.0 / 718116043.0, 0.0, 0.0, -3185094517.0 / 667107341.0, -477755414.0 / 1098053517.0, -703635378.0 / 230739211.0, 5731566787.0 / 1027545527.0, 5232866602.0 / 850066563.0, -4093664535.0 / 808688257.0, 3962137247.0 / 1805957418.0, 65686358.0 / 487910083.0},
-    {403863854.0 / 491063109.0, 0.0, 0.0, -5068492393.0 / 434740067.0, -411421997.0 / 543043805.0, 652783627.0 / 914296604.0, 11173962825.0 / 925320556.0, -13158990841.0 / 6184727034.0, 3936647629.0 / 1978049680.0, -160528059.0 / 685178525.0, 248638103.0 / 1413531060.0, 0.0}
-};
-
 ODESolver::ODESolver()
 {
 }
 
 void ODESolver::initializeWorkspace(size_t stateSize)
 {
-    if (k.size() != STAGES || (k.size() > 0 && k[0].size() != stateSize)) {
-        k.resize(STAGES);
-        for (int i = 0; i < STAGES; ++i) {
+    if (k.size() != DOP853::STAGES_DENSE || (k.size() > 0 && k[0].size() != stateSize)) {
+        k.resize(DOP853::STAGES_DENSE);
+        for (int i = 0; i < DOP853::STAGES_DENSE; ++i) {
             k[i].resize(stateSize);
         }
         tempState.resize(stateSize);
+        newState.resize(stateSize);
+        denseCoeffs.resize(8);
+        for (auto& coeffs : denseCoeffs) {
+            coeffs.resize(stateSize);
+        }
+        fsalValid = false;
+        denseValid = false;
     }
 }
 
-double ODESolver::step(double t, std::vector<double>& state,
-    DerivativeFunction derivFunc,
-    double dt, double tolerance)
+void ODESolver::evaluate(DerivativeFunction& derivFunc, double t,
+    const std::vector<double>& state, std::vector<double>& out)
 {
-    initializeWorkspace(state.size());
+    std::vector<double> deriv = derivFunc(t, state);
+    std::copy(deriv.begin(), deriv.end(), out.begin());
+    ++derivativeEvaluations;
+}
 
+void ODESolver::computeStages(double t, const std::vector<double>& state,
+    DerivativeFunction& derivFunc, double dt)
+{
     const size_t n = state.size();
-    std::vector<double> state8(n);
-    std::vector<double> state7(n);
 
     // Compute all 13 k values
     for (int stage = 0; stage < STAGES; ++stage) {
@@ -50,92 +43,282 @@ double ODESolver::step(double t, std::vector<double>& state,
         for (size_t i = 0; i < n; ++i) {
             tempState[i] = state[i];
             for (int j = 0; j < stage; ++j) {
-                tempState[i] += dt * a[stage][j] * k[j][i];
+                tempState[i] += dt * DormandPrince87::a[stage][j] * k[j][i];
             }
         }
 
         // Evaluate derivative
-        double t_stage = t + c[stage] * dt;
-        std::vector<double> deriv = derivFunc(t_stage, tempState);
+        double t_stage = t + DormandPrince87::c[stage] * dt;
+        evaluate(derivFunc, t_stage, tempState, k[stage]);
+    }
+}
 
-        // Store k value
+double ODESolver::step(double t, std::vector<double>& state,
+    DerivativeFunction derivFunc,
+    double dt, double tolerance)
+{
+    // Start from the remembered step size unless the caller asks for less
+    double h = (suggestedDt > 0.0) ? std::min(dt, suggestedDt) : dt;
+    return adaptiveStep(t, state, derivFunc, h, tolerance);
+}
+
+double ODESolver::adaptiveStep(double t, std::vector<double>& state,
+    DerivativeFunction& derivFunc, double dt, double tolerance)
+{
+    initializeWorkspace(state.size());
+
+    const size_t n = state.size();
+    const double alpha = 1.0 / 8.0 - 0.2 * BETA;
+    bool rejected = false;
+
+    // First stage: reuse the previous step's last derivative when the caller
+    // continues from exactly where that step ended (FSAL)
+    if (fsalValid && t == fsalTime && state == newState) {
+        std::swap(k[0], k[DOP853::STAGES]);
+    }
+    else {
+        evaluate(derivFunc, t, state, k[0]);
+    }
+    fsalValid = false;
+
+    // Retry with smaller steps until the error is within tolerance.
+    // k[0] stays valid across attempts, so a retry costs 11 evaluations.
+    while (true) {
+        for (int stage = 1; stage < DOP853::STAGES; ++stage) {
+            for (size_t i = 0; i < n; ++i) {
+                tempState[i] = state[i];
+                for (int j = 0; j < stage; ++j) {
+                    tempState[i] += dt * DOP853::a[stage][j] * k[j][i];
+                }
+            }
+            evaluate(derivFunc, t + DOP853::c[stage] * dt, tempState, k[stage]);
+        }
+
+        // 8th order solution
         for (size_t i = 0; i < n; ++i) {
-            k[stage][i] = deriv[i];
+            newState[i] = state[i];
+            for (int stage = 0; stage < DOP853::STAGES; ++stage) {
+                newState[i] += dt * DOP853::b[stage] * k[stage][i];
+            }
         }
+
+        double error = computeError(state, dt, tolerance);
+
+        if (error <= 1.0 || dt < MIN_STEP) {
+            // PI controller: weigh in the previous accepted error for smoother steps
+            double factor = SAFETY * std::pow(error, -alpha) * std::pow(previousError, BETA);
+            factor = std::min(MAX_FACTOR, std::max(MIN_FACTOR, factor));
+            if (rejected) {
+                factor = std::min(factor, 1.0);  // Don't grow right after a rejection
+            }
+
+            suggestedDt = dt * factor;
+            previousError = std::max(error, 1e-4);
+            ++acceptedSteps;
+
+            // Derivative at the new point: first stage of the next step and
+            // an endpoint condition of the interpolant
+            evaluate(derivFunc, t + dt, newState, k[DOP853::STAGES]);
+            fsalValid = true;
+            fsalTime = t + dt;
+
+            if (denseEnabled) {
+                prepareDenseOutput(t, state, derivFunc, dt);
+            }
+            else {
+                denseValid = false;
+            }
+
+            std::copy(newState.begin(), newState.end(), state.begin());
+            return dt;
+        }
+
+        // Reject step and try smaller dt
+        double factor = SAFETY * std::pow(error, -1.0 / 8.0);
+        dt *= std::max(MIN_FACTOR, factor);
+        rejected = true;
+        ++rejectedSteps;
     }
+}
 
-    // Compute 8th order solution
-    for (size_t i = 0; i < n; ++i) {
-        state8[i] = state[i];
-        for (int stage = 0; stage < STAGES; ++stage) {
-            state8[i] += dt * b8[stage] * k[stage][i];
+void ODESolver::prepareDenseOutput(double t, const std::vector<double>& state,
+    DerivativeFunction& derivFunc, double dt)
+{
+    const size_t n = state.size();
+
+    // Three extra stages (k[13..15]) feed the 7th order terms
+    for (int stage = DOP853::STAGES + 1; stage < DOP853::STAGES_DENSE; ++stage) {
+        for (size_t i = 0; i < n; ++i) {
+            tempState[i] = state[i];
+            for (int j = 0; j < stage; ++j) {
+                tempState[i] += dt * DOP853::a[stage][j] * k[j][i];
+            }
         }
+        evaluate(derivFunc, t + DOP853::c[stage] * dt, tempState, k[stage]);
     }
 
-    // Compute 7th order solution for error estimation
+    // Interpolant in Hairer's nested form (see denseOutput)
     for (size_t i = 0; i < n; ++i) {
-        state7[i] = state[i];
-        for (int stage = 0; stage < STAGES; ++stage) {
-            state7[i] += dt * b7[stage] * k[stage][i];
+        double diff = newState[i] - state[i];
+        double bspl = dt * k[0][i] - diff;
+        denseCoeffs[0][i] = state[i];
+        denseCoeffs[1][i] = diff;
+        denseCoeffs[2][i] = bspl;
+        denseCoeffs[3][i] = diff - dt * k[DOP853::STAGES][i] - bspl;
+        for (int m = 0; m < 4; ++m) {
+            double sum = 0.0;
+            for (int stage = 0; stage < DOP853::STAGES_DENSE; ++stage) {
+                sum += DOP853::d[m][stage] * k[stage][i];
+            }
+            denseCoeffs[4 + m][i] = dt * sum;
         }
     }
 
-    // Estimate error
-    double error = computeError(state8, state7);
+    stepStart = t;
+    stepSize = dt;
+    denseValid = true;
+}
 
-    // Accept step if error is small enough
-    if (error < tolerance || dt < 1e-10) {
-        state = state8;
-        return dt;
+bool ODESolver::denseOutput(double t, std::vector<double>& out) const
+{
+    if (!denseValid || t < stepStart || t > stepStart + stepSize) {
+        return false;
     }
-    else {
-        // Reject step and try smaller dt
-        double safety = 0.9;
-        double newDt = safety * dt * std::pow(tolerance / error, 1.0 / 8.0);
-        newDt = std::max(newDt, dt * 0.2);  // Don't shrink too much
-        return step(t, state, derivFunc, newDt, tolerance);
+
+    const size_t n = denseCoeffs[0].size();
+    out.resize(n);
+
+    double s = (t - stepStart) / stepSize;
+    double s1 = 1.0 - s;
+    for (size_t i = 0; i < n; ++i) {
+        double high = denseCoeffs[4][i] + s * (denseCoeffs[5][i] + s1 * (denseCoeffs[6][i] + s * denseCoeffs[7][i]));
+        out[i] = denseCoeffs[0][i] + s * (denseCoeffs[1][i] + s1 * (denseCoeffs[2][i]
+            + s * (denseCoeffs[3][i] + s1 * high)));
     }
+    return true;
 }
 
-void ODESolver::stepFixed(double t, std::vector<double>& state,
-    DerivativeFunction derivFunc, double dt)
+int ODESolver::integrateTo(double t, double tEnd, std::vector<double>& state,
+    DerivativeFunction derivFunc, double tolerance)
 {
-    initializeWorkspace(state.size());
+    if (suggestedDt <= 0.0) {
+        suggestedDt = initialStepSize(t, tEnd, state, derivFunc, tolerance);
+    }
 
-    const size_t n = state.size();
+    int steps = 0;
+    while (t < tEnd) {
+        double remaining = tEnd - t;
+        double h = suggestedDt;
 
-    // Compute all 13 k values
-    for (int stage = 0; stage < STAGES; ++stage) {
-        for (size_t i = 0; i < n; ++i) {
-            tempState[i] = state[i];
-            for (int j = 0; j < stage; ++j) {
-                tempState[i] += dt * a[stage][j] * k[j][i];
-            }
+        // Land exactly on tEnd; stretch by up to 1% rather than leave a sliver
+        bool lastStep = (1.01 * h >= remaining);
+        if (lastStep) {
+            h = remaining;
         }
 
-        double t_stage = t + c[stage] * dt;
-        std::vector<double> deriv = derivFunc(t_stage, tempState);
+        double suggestedBefore = suggestedDt;
+        double taken = adaptiveStep(t, state, derivFunc, h, tolerance);
+        ++steps;
 
-        for (size_t i = 0; i < n; ++i) {
-            k[stage][i] = deriv[i];
+        if (lastStep && taken == h) {
+            // Clipping was only for landing, so keep the controller's longer step
+            suggestedDt = std::max(suggestedDt, suggestedBefore);
+            break;
         }
+        t += taken;
+    }
+    return steps;
+}
+
+double ODESolver::initialStepSize(double t, double tEnd, const std::vector<double>& state,
+    DerivativeFunction& derivFunc, double tolerance)
+{
+    // Starting step heuristic from Hairer, Norsett & Wanner (HNW93, II.4):
+    // balance the first and second derivative against the tolerance.
+    initializeWorkspace(state.size());
+
+    const size_t n = state.size();
+    const double maxStep = tEnd - t;
+    std::vector<double>& f0 = k[DOP853::STAGES + 1];
+    std::vector<double>& f1 = k[DOP853::STAGES + 2];
+
+    evaluate(derivFunc, t, state, f0);
+    double normState = 0.0;
+    double normDeriv = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double scale = tolerance + tolerance * std::abs(state[i]);
+        normState += (state[i] / scale) * (state[i] / scale);
+        normDeriv += (f0[i] / scale) * (f0[i] / scale);
     }
+    normState = std::sqrt(normState / static_cast<double>(n));
+    normDeriv = std::sqrt(normDeriv / static_cast<double>(n));
+
+    double h = (normState <= 1e-5 || normDeriv <= 1e-5) ? 1e-6
+        : 0.01 * normState / normDeriv;
+    h = std::min(h, maxStep);
+
+    // Explicit Euler probe for the second derivative
+    for (size_t i = 0; i < n; ++i) {
+        tempState[i] = state[i] + h * f0[i];
+    }
+    evaluate(derivFunc, t + h, tempState, f1);
+
+    double normSecond = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double scale = tolerance + tolerance * std::abs(state[i]);
+        normSecond += ((f1[i] - f0[i]) / scale) * ((f1[i] - f0[i]) / scale);
+    }
+    normSecond = std::sqrt(normSecond / static_cast<double>(n)) / h;
+    double derivSize = std::max(normSecond, normDeriv);
+
+    double h1 = (derivSize <= 1e-15) ? std::max(1e-6, h * 1e-3)
+        : std::pow(0.01 / derivSize, 1.0 / 8.0);
+
+    return std::min({ 100.0 * h, h1, maxStep });
+}
+
+void ODESolver::stepFixed(double t, std::vector<double>& state,
+    DerivativeFunction derivFunc, double dt)
+{
+    initializeWorkspace(state.size());
+
+    const size_t n = state.size();
+
+    computeStages(t, state, derivFunc, dt);
 
     // Apply 8th order solution
     for (size_t i = 0; i < n; ++i) {
         for (int stage = 0; stage < STAGES; ++stage) {
-            state[i] += dt * b8[stage] * k[stage][i];
+            state[i] += dt * DormandPrince87::b8[stage] * k[stage][i];
         }
     }
 }
 
-double ODESolver::computeError(const std::vector<double>& state8,
-    const std::vector<double>& state7)
+double ODESolver::computeError(const std::vector<double>& state,
+    double dt, double tolerance) const
 {
-    double error = 0.0;
-    for (size_t i = 0; i < state8.size(); ++i) {
-        double diff = std::abs(state8[i] - state7[i]);
-        error = std::max(error, diff);
+    // DOP853 error measure: the 5th order estimate, damped by the 3rd order
+    // one where they disagree. Each component is scaled by atol + rtol * |y|
+    // so large and small state variables weigh alike. A value <= 1 means the
+    // step meets the tolerance.
+    const size_t n = state.size();
+    double err5 = 0.0;
+    double err3 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double scale = tolerance + tolerance * std::max(std::abs(state[i]), std::abs(newState[i]));
+        double e5 = 0.0;
+        double e3 = 0.0;
+        for (int stage = 0; stage < DOP853::STAGES; ++stage) {
+            e5 += DOP853::e5[stage] * k[stage][i];
+            e3 += (DOP853::b[stage] - DOP853::b3[stage]) * k[stage][i];
+        }
+        err5 += (e5 / scale) * (e5 / scale);
+        err3 += (e3 / scale) * (e3 / scale);
     }
-    return error;
-}
\ No newline at end of file
+
+    double denominator = err5 + 0.01 * err3;
+    if (denominator <= 0.0) {
+        denominator = 1.0;
+    }
+    return std::abs(dt) * err5 / std::sqrt(static_cast<double>(n) * denominator);
+}
@@ -1,13 +1,26 @@
 #pragma once
 
+#include "DOP853.h"
+#include "DormandPrince87.h"
 #include <functional>
 #include <vector>
 
 /**
- * ODESolver - Dormand-Prince 8(7) Runge-Kutta solver
+ * ODESolver - high-order Runge-Kutta solver
  *
- * High-accuracy adaptive ODE solver used in the chaos video.
- * 8th order solution with 7th order error estimation.
+ * High-accuracy ODE solver used in the chaos video.
+ * - Adaptive stepping uses Hairer's DOP853: 8th order solution, combined
+ *   5th/3rd order error estimation, FSAL reuse of the last stage, and an
+ *   optional 7th order dense output over the last accepted step.
+ * - Fixed stepping uses Dormand-Prince 8(7) (the same tableau as
+ *   FixedODESolver), for consistent frame timing.
+ *
+ * Dense output lets callers take large adaptive steps and sample the state
+ * at arbitrary times (e.g. frame or control times) without extra steps:
+ *
+ *     solver.setDenseOutput(true);
+ *     while (t < tSample) t += solver.step(t, state, f, maxDt, tol);
+ *     solver.denseOutput(tSample, sampled);
  */
 class ODESolver
 {
@@ -18,61 +31,115 @@ public:
     ODESolver();
 
     /**
-     * Take one adaptive step using Dormand-Prince 8(7)
+     * Take one adaptive step using DOP853
+     *
+     * The first attempt uses the step size this solver accepted last time
+     * (capped at dt). Rejected attempts shrink the step iteratively until the
+     * scaled error estimate is within tolerance; the PI controller's proposal
+     * for the next step is remembered for the following call.
      *
      * @param t Current time
      * @param state Current state vector
      * @param derivFunc Function that computes derivatives
-     * @param dt Suggested time step (will be adjusted)
-     * @param tolerance Error tolerance for adaptive stepping
+     * @param dt Maximum time step for this call
+     * @param tolerance Relative and absolute error tolerance
      * @return Actual time step taken
      */
     double step(double t, std::vector<double>& state,
         DerivativeFunction derivFunc,
         double dt, double tolerance = 1e-8);
 
+    /**
+     * Integrate adaptively from t to tEnd with as few steps as the tolerance allows
+     *
+     * Steps are only shortened to land exactly on tEnd; a final step that
+     * would overshoot by less than 1% is stretched instead of leaving a
+     * sliver, and clipping does not shrink the remembered step size.
+     *
+     * @return Number of accepted steps
+     */
+    int integrateTo(double t, double tEnd, std::vector<double>& state,
+        DerivativeFunction derivFunc, double tolerance = 1e-8);
+
     /**
      * Fixed step (no adaptation) - useful for consistent frame timing
      */
     void stepFixed(double t, std::vector<double>& state,
         DerivativeFunction derivFunc, double dt);
 
+    /**
+     * Dense output: enable to build the 7th order interpolant on every
+     * accepted adaptive step (three extra derivative evaluations per step)
+     */
+    void setDenseOutput(bool enabled) { denseEnabled = enabled; }
+    bool isDenseOutputEnabled() const { return denseEnabled; }
+
+    /**
+     * Evaluate the continuous extension of the last accepted adaptive step
+     *
+     * @param t Time within [getStepStart(), getStepEnd()]
+     * @param out Receives the interpolated state
+     * @return false if dense output is unavailable or t is outside the last step
+     */
+    bool denseOutput(double t, std::vector<double>& out) const;
+    double getStepStart() const { return stepStart; }
+    double getStepEnd() const { return stepStart + stepSize; }
+
+    // Step size the controller proposes for the next step (0 before the first step)
+    double getSuggestedStep() const { return suggestedDt; }
+    void setSuggestedStep(double dt) { suggestedDt = dt; }
+
+    // Step statistics since construction / the last resetStatistics()
+    int getAcceptedSteps() const { return acceptedSteps; }
+    int getRejectedSteps() const { return rejectedSteps; }
+    int getDerivativeEvaluations() const { return derivativeEvaluations; }
+    void resetStatistics() { acceptedSteps = 0; rejectedSteps = 0; derivativeEvaluations = 0; }
+
 private:
-    // Dormand-Prince 8(7) Butcher tableau coefficients
-    static constexpr int STAGES = 13;
-
-    // Time coefficients (c values)
-    static constexpr double c[STAGES] = {
-        0.0, 1.0 / 18.0, 1.0 / 12.0, 1.0 / 8.0, 5.0 / 16.0, 3.0 / 8.0, 59.0 / 400.0,
-        93.0 / 200.0, 5490023248.0 / 9719169821.0, 13.0 / 20.0, 1201146811.0 / 1299019798.0,
-        1.0, 1.0
-    };
-
-    // Integration weights for 8th order solution (b values)
-    static constexpr double b8[STAGES] = {
-        14005451.0 / 335480064.0, 0.0, 0.0, 0.0, 0.0,
-        -59238493.0 / 1068277825.0, 181606767.0 / 758867731.0,
-        561292985.0 / 797845732.0, -1041891430.0 / 1371343529.0,
-        760417239.0 / 1151165299.0, 118820643.0 / 751138087.0,
-        -528747749.0 / 2220607170.0, 1.0 / 4.0
-    };
-
-    // Integration weights for 7th order solution (b* values) for error estimation
-    static constexpr double b7[STAGES] = {
-        13451932.0 / 455176623.0, 0.0, 0.0, 0.0, 0.0,
-        -808719846.0 / 976000145.0, 1757004468.0 / 5645159321.0,
-        656045339.0 / 265891186.0, -3867574721.0 / 1518517206.0,
-        465885868.0 / 322736535.0, 53011238.0 / 667516719.0, 2.0 / 45.0, 0.0
-    };
-
-    // a matrix coefficients (how k values combine)
-    static const double a[STAGES][STAGES];
-
-    // Workspace for k values
+    static constexpr int STAGES = DormandPrince87::STAGES;
+
+    // Step size controller (PI, Hairer & Wanner style)
+    static constexpr double SAFETY = 0.9;
+    static constexpr double MIN_FACTOR = 0.2;   // Don't shrink too much per attempt
+    static constexpr double MAX_FACTOR = 6.0;   // ...or grow too much per step
+    static constexpr double BETA = 0.04;        // Weight of the previous error
+    static constexpr double MIN_STEP = 1e-10;   // Accept unconditionally below this
+
+    // Workspace for k values (sized for the larger of the two tableaus)
     std::vector<std::vector<double>> k;
     std::vector<double> tempState;
+    std::vector<double> newState;
+
+    // Controller memory carried between calls
+    double suggestedDt = 0.0;
+    double previousError = 1e-4;
+
+    // FSAL: k[12] holds f(fsalTime, newState) after an accepted step
+    bool fsalValid = false;
+    double fsalTime = 0.0;
+
+    // Dense output of the last accepted step
+    bool denseEnabled = false;
+    bool denseValid = false;
+    double stepStart = 0.0;
+    double stepSize = 0.0;
+    std::vector<std::vector<double>> denseCoeffs;
+
+    int acceptedSteps = 0;
+    int rejectedSteps = 0;
+    int derivativeEvaluations = 0;
 
     void initializeWorkspace(size_t stateSize);
-    double computeError(const std::vector<double>& state8,
-        const std::vector<double>& state7);
-};
\ No newline at end of file
+    void evaluate(DerivativeFunction& derivFunc, double t,
+        const std::vector<double>& state, std::vector<double>& out);
+    void computeStages(double t, const std::vector<double>& state,
+        DerivativeFunction& derivFunc, double dt);
+    double adaptiveStep(double t, std::vector<double>& state,
+        DerivativeFunction& derivFunc, double dt, double tolerance);
+    void prepareDenseOutput(double t, const std::vector<double>& state,
+        DerivativeFunction& derivFunc, double dt);
+    double initialStepSize(double t, double tEnd, const std::vector<double>& state,
+        DerivativeFunction& derivFunc, double tolerance);
+    double computeError(const std::vector<double>& state,
+        double dt, double tolerance) const;
+};
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "Integrators.h"
+
 /**
  * Pendulum base class - common interface for all pendulum types
  *
  * This is an abstract base class that defines the interface
- * for both single and double pendulums.
+ * for both single and double pendulums. Implementations keep all mutable
+ * state, including integrator workspaces, in the instance: distinct
+ * pendulums may be updated concurrently on different threads.
  */
 class Pendulum
 {
@@ -20,12 +24,27 @@ public:
     virtual double getAngle(int index) const = 0;
     virtual double getAngularVelocity(int index) const = 0;
 
+    // Generic per-link access (used by CartPendulumSystem)
+    virtual double getLinkMass(int index) const = 0;
+    virtual double getLinkLength(int index) const = 0;
+    virtual void setLinkState(int index, double angle, double angularVelocity) = 0;
+
+    // Whole dynamic state [angle1, angVel1, angle2, ...], 2 * getNumAngles()
+    // doubles, in one call (snapshots). Integrator workspaces hold only
+    // per-step scratch, so this is everything update() carries over.
+    virtual void getState(double* state) const = 0;
+    virtual void setState(const double* state) = 0;
+
     // Set gravity (called from main loop)
     void setGravity(double g) { m_gravity = g; }
     double getGravity() const { return m_gravity; }
     void setDamping(double d) { m_damping = d; }
     double getDamping() const { return m_damping; }
 
+    // Integrator used by update() (default: Dormand-Prince 8(7))
+    void setIntegrator(IntegratorType type) { m_integrator = type; }
+    IntegratorType getIntegrator() const { return m_integrator; }
+
     // Energy instrumentation: kinetic / potential energy of the pendulum
     virtual double getKineticEnergy(double cartVelocity) const = 0;
     virtual double getPotentialEnergy() const = 0;
@@ -37,4 +56,5 @@ protected:
     // Physics constants
     double m_gravity = 9.81;  // m/s^2 - can be changed at runtime
     double m_damping = 0.1;   // generic damping term (applies as angular damping)
+    IntegratorType m_integrator = IntegratorType::DormandPrince87;
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "SimdDouble.h"
+#include <cmath>
+
+/**
+ * PendulumDynamics - equations of motion shared by every integration path
+ *
+ * Templated on the arithmetic type so the scalar classes (Cart,
+ * SinglePendulum, DoublePendulum with Real = double), the batched integrator
+ * (BatchCartPendulum with Real = SimdDouble or SimdFloat, one environment
+ * per lane) and derivative computations (Real = Dual<M>, see Dual.h)
+ * evaluate exactly the same physics. Branches are expressed with select()
+ * so they work lane-wise.
+ *
+ * Angles use the downward-zero convention (theta = 0 is hanging down) and
+ * the cart acceleration acts as a prescribed horizontal pivot acceleration.
+ */
+namespace PendulumDynamics
+{
+    /**
+     * Cart on the rail: the applied acceleration minus viscous friction
+     *   x_dd = a - friction * v
+     */
+    template <typename Real>
+    Real cartAcceleration(Real velocity, Real appliedAccel, Real friction)
+    {
+        Real frictionAccel = -friction * velocity;
+        return appliedAccel + frictionAccel;
+    }
+
+    /**
+     * Single pendulum on a cart
+     *
+     * With the downward-zero convention the gravity term is -g*sin(theta),
+     * cart acceleration couples with -cos(theta), and a simple viscous
+     * damping term acts on the angular velocity:
+     *   theta_dd = (-g*sin(theta) - a*cos(theta) - d*omega) / L
+     */
+    template <typename Real>
+    Real singleAngularAcceleration(Real angle, Real angularVel, Real cartAccel,
+        Real gravity, Real damping, Real length)
+    {
+        using std::sin;
+        using std::cos;
+
+        Real numerator = -gravity * sin(angle) - cartAccel * cos(angle);
+        return (numerator - damping * angularVel) / length;
+    }
+
+    /**
+     * Double pendulum on a cart
+     *
+     * Lagrangian-derived equations for a double pendulum with a moving support.
+     * Using positions:
+     *  x1 = x_cart + L1*sin(theta1), y1 = -L1*cos(theta1)
+     *  x2 = x1 + L2*sin(theta2), y2 = y1 - L2*cos(theta2)
+     * the Euler-Lagrange equations give a 2x2 linear system
+     *   A * [theta1_dd; theta2_dd] = RHS
+     * which is solved in closed form.
+     */
+    template <typename Real>
+    void doubleAngularAccelerations(Real theta1, Real theta2,
+        Real omega1, Real omega2, Real cartAccel,
+        Real g, Real damping, Real m1, Real m2, Real L1, Real L2,
+        Real& alpha1, Real& alpha2)
+    {
+        using std::sin;
+        using std::cos;
+        using std::abs;
+
+        Real dtheta = theta1 - theta2; // note sign used in cos/sin below
+        Real c = cos(dtheta);
+        Real s = sin(dtheta);
+
+        // Mass-inertia matrix coefficients
+        Real A11 = (m1 + m2) * L1;
+        Real A12 = m2 * L2 * c;
+        Real A21 = m2 * L1 * c;
+        Real A22 = m2 * L2;
+
+        // Right-hand side (move all non-acceleration terms to RHS)
+        Real RHS1 = - (m1 + m2) * g * sin(theta1)
+                    - m2 * L2 * omega2 * omega2 * s
+                    - (m1 + m2) * cartAccel * cos(theta1)
+                    - damping * omega1;
+
+        Real RHS2 = m2 * L1 * omega1 * omega1 * s
+                    - m2 * g * sin(theta2)
+                    - m2 * cartAccel * cos(theta2)
+                    - damping * omega2;
+
+        // Solve 2x2 linear system
+        Real det = A11 * A22 - A12 * A21;
+        Real solved1 = (RHS1 * A22 - A12 * RHS2) / det;
+        Real solved2 = (A11 * RHS2 - RHS1 * A21) / det;
+
+        // Ill-conditioned; fall back to simple decoupled estimates
+        Real fallback1 = RHS1 / select(A11 > Real(1e-12), A11, Real(1.0));
+        Real fallback2 = RHS2 / select(A22 > Real(1e-12), A22, Real(1.0));
+
+        auto illConditioned = abs(det) < Real(1e-12);
+        alpha1 = select(illConditioned, fallback1, solved1);
+        alpha2 = select(illConditioned, fallback2, solved2);
+    }
+}
@@ -0,0 +1,185 @@
+#include "PendulumEnv.h"
+#include "ChainPendulum.h"
+#include "DoublePendulum.h"
+#include "Random.h"
+#include "SinglePendulum.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    std::unique_ptr<Pendulum> createPendulum(const PendulumEnvConfig& config)
+    {
+        if (config.numLinks >= 3) {
+            return std::make_unique<ChainPendulum>(config.numLinks, config.linkMass, config.linkLength);
+        }
+        if (config.numLinks == 2) {
+            return std::make_unique<DoublePendulum>(config.linkMass, config.linkLength,
+                config.linkMass, config.linkLength);
+        }
+        return std::make_unique<SinglePendulum>(config.linkMass, config.linkLength);
+    }
+}
+
+PendulumEnv::PendulumEnv(const PendulumEnvConfig& config)
+    : m_config(config)
+    , m_cart(config.cartMass, config.railLength)
+    , m_pendulum(createPendulum(config))
+    , m_coupled(m_cart, *m_pendulum)
+    , m_observation(2 + 2 * m_pendulum->getNumAngles(), 0.0)
+    , m_linkState(2 * m_pendulum->getNumAngles(), 0.0)
+{
+    m_config.substeps = std::max(1, m_config.substeps);
+    m_cart.setIntegrator(config.integrator);
+    m_pendulum->setIntegrator(config.integrator);
+    m_pendulum->setGravity(config.gravity);
+    m_pendulum->setDamping(config.damping);
+    reset(0);
+}
+
+const double* PendulumEnv::reset(std::uint64_t seed)
+{
+    setSeed(seed);
+    return reset();
+}
+
+const double* PendulumEnv::reset()
+{
+    resetInto(m_observation.data());
+    return m_observation.data();
+}
+
+void PendulumEnv::saveSnapshot(void* snapshot) const
+{
+    PendulumEnvSnapshot* header = static_cast<PendulumEnvSnapshot*>(snapshot);
+    header->cartPosition = m_cart.getPosition();
+    header->cartVelocity = m_cart.getVelocity();
+    header->appliedAcceleration = m_appliedAcceleration;
+    header->effectiveAcceleration = m_effectiveAcceleration;
+    header->rngState = m_rngState;
+    header->episodeSteps = m_episodeSteps;
+    header->numLinks = m_pendulum->getNumAngles();
+    m_pendulum->getState(reinterpret_cast<double*>(header + 1));
+}
+
+bool PendulumEnv::restoreSnapshot(const void* snapshot)
+{
+    const PendulumEnvSnapshot* header = static_cast<const PendulumEnvSnapshot*>(snapshot);
+    if (header->numLinks != m_pendulum->getNumAngles()) {
+        std::cerr << "ERROR: Cannot restore a " << header->numLinks << "-link snapshot into a "
+            << m_pendulum->getNumAngles() << "-link environment" << std::endl;
+        return false;
+    }
+    m_cart.setPosition(header->cartPosition);
+    m_cart.setVelocity(header->cartVelocity);
+    m_appliedAcceleration = header->appliedAcceleration;
+    m_effectiveAcceleration = header->effectiveAcceleration;
+    m_rngState = header->rngState;
+    m_episodeSteps = header->episodeSteps;
+    m_pendulum->setState(reinterpret_cast<const double*>(header + 1));
+    writeObservation(m_cart, *m_pendulum, m_observation.data());
+    return true;
+}
+
+bool PendulumEnv::copyStateFrom(const PendulumEnv& other)
+{
+    if (other.m_pendulum->getNumAngles() != m_pendulum->getNumAngles()) {
+        std::cerr << "ERROR: Cannot copy a " << other.m_pendulum->getNumAngles() << "-link state into a "
+            << m_pendulum->getNumAngles() << "-link environment" << std::endl;
+        return false;
+    }
+    m_cart.setPosition(other.m_cart.getPosition());
+    m_cart.setVelocity(other.m_cart.getVelocity());
+    m_appliedAcceleration = other.m_appliedAcceleration;
+    m_effectiveAcceleration = other.m_effectiveAcceleration;
+    m_rngState = other.m_rngState;
+    m_episodeSteps = other.m_episodeSteps;
+    other.m_pendulum->getState(m_linkState.data());
+    m_pendulum->setState(m_linkState.data());
+    writeObservation(m_cart, *m_pendulum, m_observation.data());
+    return true;
+}
+
+PendulumEnv::StepResult PendulumEnv::step(double action)
+{
+    return stepInto(action, m_observation.data());
+}
+
+void PendulumEnv::resetInto(double* observation)
+{
+    m_cart.reset();
+    const int links = m_pendulum->getNumAngles();
+    for (int link = 0; link < links; ++link) {
+        double angle = (link == 0 ? m_config.initialAngle : 0.0) + uniform(m_config.initialAngleNoise);
+        double angularVelocity = uniform(m_config.initialVelocityNoise);
+        m_pendulum->setLinkState(link, angle, angularVelocity);
+    }
+    m_episodeSteps = 0;
+    m_appliedAcceleration = 0.0;
+    m_effectiveAcceleration = 0.0;
+    writeObservation(m_cart, *m_pendulum, observation);
+}
+
+PendulumEnv::StepResult PendulumEnv::stepInto(double action, double* observation)
+{
+    action = std::clamp(action, -1.0, 1.0);
+    const double appliedAcceleration = action * m_config.maxAcceleration;
+
+    // Same per-tick sequence as the interactive loop, with the action held
+    for (int tick = 0; tick < m_config.substeps; ++tick) {
+        if (m_config.coupled) {
+            m_effectiveAcceleration = m_coupled.update(m_config.dt, appliedAcceleration, m_config.friction);
+        }
+        else {
+            m_effectiveAcceleration = m_cart.update(m_config.dt, appliedAcceleration,
+                m_config.friction, m_config.gravity);
+            m_pendulum->update(m_config.dt, m_effectiveAcceleration);
+        }
+    }
+    m_appliedAcceleration = appliedAcceleration;
+    ++m_episodeSteps;
+    writeObservation(m_cart, *m_pendulum, observation);
+
+    StepResult result;
+    result.observation = observation;
+    result.reward = computeReward(action);
+
+    bool diverged = false;
+    for (int i = 0; i < getObservationSize(); ++i) {
+        diverged = diverged || !std::isfinite(observation[i]);
+    }
+    bool atRailEnd = std::abs(m_cart.getPosition()) >= 0.5 * m_cart.getRailLength();
+    result.terminated = diverged || (m_config.terminateAtRailEnd && atRailEnd);
+    result.truncated = !result.terminated && m_episodeSteps >= m_config.maxEpisodeSteps;
+    return result;
+}
+
+void PendulumEnv::writeObservation(const Cart& cart, const Pendulum& pendulum, double* observation)
+{
+    observation[0] = cart.getPosition();
+    observation[1] = cart.getVelocity();
+    const int links = pendulum.getNumAngles();
+    for (int link = 0; link < links; ++link) {
+        observation[2 + 2 * link] = pendulum.getAngle(link);
+        observation[3 + 2 * link] = pendulum.getAngularVelocity(link);
+    }
+}
+
+double PendulumEnv::computeReward(double action) const
+{
+    const int links = m_pendulum->getNumAngles();
+    double uprightness = 0.0;
+    for (int link = 0; link < links; ++link) {
+        uprightness += 0.5 * (1.0 - std::cos(m_pendulum->getAngle(link)));
+    }
+    uprightness /= links;
+
+    double position = m_cart.getPosition() / (0.5 * m_cart.getRailLength());
+    return uprightness - m_config.actionCost * action * action - m_config.positionCost * position * position;
+}
+
+double PendulumEnv::uniform(double halfWidth)
+{
+    return (2.0 * uniformUnit(splitMix64(m_rngState)) - 1.0) * halfWidth;
+}
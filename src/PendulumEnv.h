@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Cart.h"
+#include "CartPendulumSystem.h"
+#include "Pendulum.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * PendulumEnvConfig - fixed parameters of a PendulumEnv
+ *
+ * Physical defaults match the interactive viewer. An action in [-1, 1] is
+ * scaled to the cart acceleration like the A/D keys (InputController) and
+ * held for `substeps` physics ticks of `dt` (control decimation).
+ */
+struct PendulumEnvConfig
+{
+    int numLinks = 1;                   // 1 single, 2 double, 3+ ChainPendulum
+    int substeps = 4;                   // physics ticks per step(); 144 Hz / 4 = 36 Hz control
+    double dt = 1.0 / 144.0;            // physics tick (s)
+    int maxEpisodeSteps = 500;          // truncation limit (steps, not ticks)
+    bool coupled = false;               // integrate with CartPendulumSystem
+    IntegratorType integrator = IntegratorType::DormandPrince87;
+
+    double maxAcceleration = 30.0;      // m/s^2 at |action| = 1
+    double cartMass = 1.0;
+    double railLength = 10.0;
+    double linkMass = 1.0;              // every link
+    double linkLength = 1.0;            // every link
+    double gravity = 9.81;
+    double damping = 0.1;
+    double friction = 0.1;
+
+    // Reset distribution: first link at initialAngle (0 = hanging down),
+    // others hanging; every angle and angular velocity gets uniform noise
+    double initialAngle = 0.0;
+    double initialAngleNoise = 0.05;        // rad
+    double initialVelocityNoise = 0.05;     // rad/s
+
+    // reward = uprightness - actionCost * action^2 - positionCost * (x / halfRail)^2,
+    // where uprightness = mean over links of (1 - cos(angle)) / 2 is 1 upright
+    double actionCost = 0.001;
+    double positionCost = 0.01;
+    bool terminateAtRailEnd = true;     // end the episode when the cart hits a rail end
+};
+
+/**
+ * PendulumEnvSnapshot - fixed part of a PendulumEnv state snapshot
+ *
+ * A snapshot is this header followed by the pendulum state, 2 * numLinks
+ * doubles [angle1, angVel1, ...]; PendulumEnv::getSnapshotBytes() is the
+ * total. It is plain data (memcpy, SnapshotArena slots, shared memory) and
+ * holds no parameters: it restores into environments of the same config.
+ */
+struct PendulumEnvSnapshot
+{
+    double cartPosition;
+    double cartVelocity;
+    double appliedAcceleration;
+    double effectiveAcceleration;
+    std::uint64_t rngState;
+    std::int32_t episodeSteps;
+    std::int32_t numLinks;
+};
+
+/**
+ * PendulumEnv - headless, Gym-style cart-pendulum environment
+ *
+ * reset(seed) starts an episode; step(action) advances it and returns the
+ * observation, reward and the terminated / truncated flags. The observation
+ * is [cart position, cart velocity, angle1, angular velocity1, angle2, ...]
+ * read from Cart and Pendulum, so its size is 2 + 2 * numLinks.
+ *
+ * The environment owns its cart, pendulum and observation buffer; after
+ * construction (and the first step, which sizes the chain integrator's
+ * workspace) step() and reset() perform no heap allocation. The returned
+ * observation pointer stays valid until the next call; the *Into variants
+ * write it into caller storage instead (VecEnv fills batch rows that way).
+ * Environments are independent and may be stepped concurrently from
+ * different threads.
+ */
+class PendulumEnv
+{
+public:
+    struct StepResult
+    {
+        const double* observation;
+        double reward;
+        bool terminated;    // episode ended inside the MDP (rail end, diverged state)
+        bool truncated;     // hit maxEpisodeSteps
+    };
+
+    explicit PendulumEnv(const PendulumEnvConfig& config = PendulumEnvConfig());
+
+    PendulumEnv(const PendulumEnv&) = delete;
+    PendulumEnv& operator=(const PendulumEnv&) = delete;
+
+    // Start a new episode; the initial state depends only on the seed
+    const double* reset(std::uint64_t seed);
+    // Start a new episode from the continuing random stream
+    const double* reset();
+
+    // Apply action (clamped to [-1, 1]) for config.substeps physics ticks
+    StepResult step(double action);
+
+    // reset() / step() writing the observation to getObservationSize() doubles at observation
+    void resetInto(double* observation);
+    StepResult stepInto(double action, double* observation);
+
+    // Restart the random stream used by reset()
+    void setSeed(std::uint64_t seed) { m_rngState = seed; }
+
+    // Save / restore the whole dynamic state: a few doubles copied, no
+    // allocation. A restored environment continues exactly as the saved one
+    // (same random stream too; setSeed() after restoring to diverge).
+    // Restoring needs the same number of links and prints an error otherwise.
+    std::size_t getSnapshotBytes() const { return getSnapshotBytes(m_pendulum->getNumAngles()); }
+    static std::size_t getSnapshotBytes(int numLinks)
+    {
+        return sizeof(PendulumEnvSnapshot) + 2 * static_cast<std::size_t>(numLinks) * sizeof(double);
+    }
+    void saveSnapshot(void* snapshot) const;
+    bool restoreSnapshot(const void* snapshot);
+    // Continue from another environment's current state (a one-step fork)
+    bool copyStateFrom(const PendulumEnv& other);
+
+    int getObservationSize() const { return static_cast<int>(m_observation.size()); }
+    const double* getObservation() const { return m_observation.data(); }
+    int getEpisodeSteps() const { return m_episodeSteps; }
+    const PendulumEnvConfig& getConfig() const { return m_config; }
+
+    // Commanded and delivered cart acceleration of the last physics tick
+    double getAppliedAcceleration() const { return m_appliedAcceleration; }
+    double getEffectiveAcceleration() const { return m_effectiveAcceleration; }
+
+    const Cart& getCart() const { return m_cart; }
+    const Pendulum& getPendulum() const { return *m_pendulum; }
+
+    // The observation layout above, for any cart and pendulum (the viewer
+    // and headless runner feed policies trained on this environment)
+    static void writeObservation(const Cart& cart, const Pendulum& pendulum, double* observation);
+
+private:
+    PendulumEnvConfig m_config;
+    Cart m_cart;
+    std::unique_ptr<Pendulum> m_pendulum;
+    CartPendulumSystem m_coupled;
+    std::vector<double> m_observation;
+
+    std::vector<double> m_linkState;    // copyStateFrom() scratch
+    int m_episodeSteps = 0;
+    double m_appliedAcceleration = 0.0;
+    double m_effectiveAcceleration = 0.0;
+    std::uint64_t m_rngState = 0;
+
+    double computeReward(double action) const;
+    double uniform(double halfWidth);   // uniform in [-halfWidth, halfWidth)
+};
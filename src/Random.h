@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * SplitMix64 - small, fast 64-bit generator, identical on every platform
+ *
+ * Used where results must be reproducible from a seed (environment resets).
+ * splitMix64() advances the state and returns the next output; also a good
+ * hash for deriving independent seeds (e.g. one per environment).
+ */
+inline std::uint64_t splitMix64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Output `index` of the stream that starts at `state`, without advancing
+// it: SplitMix64 is counter based, so any element is O(1) to reach
+inline std::uint64_t splitMix64At(std::uint64_t state, std::uint64_t index)
+{
+    std::uint64_t s = state + index * 0x9E3779B97F4A7C15ULL;
+    return splitMix64(s);
+}
+
+// Uniform double in [0, 1) from the top 53 bits
+inline double uniformUnit(std::uint64_t bits)
+{
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Philox4x32-10 - counter-based generator (Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3")
+ *
+ * A keyed bijection of a 128-bit counter: the output depends only on
+ * (counter, key), never on what was drawn before. Encoding "what is being
+ * sampled" in the counter (environment, episode, draw) makes each value
+ * reproducible regardless of the order or thread it is computed on.
+ */
+struct Philox4x32
+{
+    std::uint32_t v[4];
+};
+
+inline Philox4x32 philox4x32(Philox4x32 counter, std::uint64_t key)
+{
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    std::uint32_t* c = counter.v;
+    for (int round = 0; round < 10; ++round) {
+        const std::uint64_t p0 = 0xD2511F53ULL * c[0];
+        const std::uint64_t p1 = 0xCD9E8D57ULL * c[2];
+        const std::uint32_t next[4] = {
+            static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k0, static_cast<std::uint32_t>(p1),
+            static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k1, static_cast<std::uint32_t>(p0) };
+        c[0] = next[0];
+        c[1] = next[1];
+        c[2] = next[2];
+        c[3] = next[3];
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    return counter;
+}
+
+// The two 64-bit words of a Philox block (for uniformUnit)
+inline std::uint64_t philoxWord(const Philox4x32& block, int word)
+{
+    return static_cast<std::uint64_t>(block.v[2 * word]) << 32 | block.v[2 * word + 1];
+}
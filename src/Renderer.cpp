@@ -1,5 +1,6 @@
 #include "Renderer.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -45,7 +46,53 @@ void Renderer::initialize()
     glLineWidth(2.0f);
 }
 
-void Renderer::render(const Cart& cart, const Pendulum& pendulum, bool isSingle)
+SceneSnapshot SceneSnapshot::capture(const Cart& cart, const Pendulum& pendulum, double time)
+{
+    SceneSnapshot scene;
+    scene.time = time;
+    scene.cartPosition = cart.getPosition();
+    scene.cartWidth = cart.getWidth();
+    scene.cartHeight = cart.getHeight();
+    scene.railLength = cart.getRailLength();
+    scene.numAngles = std::min(pendulum.getNumAngles(), 2);
+    for (int link = 0; link < scene.numAngles; ++link) {
+        scene.angle[link] = pendulum.getAngle(link);
+        scene.length[link] = pendulum.getLinkLength(link);
+    }
+    return scene;
+}
+
+SceneSnapshot SceneSnapshot::interpolate(const SceneSnapshot& previous, const SceneSnapshot& current, double alpha)
+{
+    if (previous.numAngles != current.numAngles) return current;
+    const double TWO_PI = 6.28318530717958647692;
+    auto lerp = [alpha](double a, double b) { return a + alpha * (b - a); };
+
+    SceneSnapshot scene = current;
+    scene.time = lerp(previous.time, current.time);
+    // A jump of more than half the rail is a wrap-around, not motion
+    if (std::abs(current.cartPosition - previous.cartPosition) < 0.5 * current.railLength) {
+        scene.cartPosition = lerp(previous.cartPosition, current.cartPosition);
+    }
+    for (int link = 0; link < scene.numAngles; ++link) {
+        scene.angle[link] = previous.angle[link]
+            + alpha * std::remainder(current.angle[link] - previous.angle[link], TWO_PI);
+        scene.length[link] = lerp(previous.length[link], current.length[link]);
+    }
+    return scene;
+}
+
+void Renderer::render(const Cart& cart, const Pendulum& pendulum)
+{
+    render(SceneSnapshot::capture(cart, pendulum, 0.0));
+}
+
+void Renderer::render(const SceneSnapshot& previous, const SceneSnapshot& current, double alpha)
+{
+    render(SceneSnapshot::interpolate(previous, current, std::clamp(alpha, 0.0, 1.0)));
+}
+
+void Renderer::render(const SceneSnapshot& scene)
 {
     // Clear screen
     glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
@@ -56,79 +103,72 @@ void Renderer::render(const Cart& cart, const Pendulum& pendulum, bool isSingle)
 
     // Draw rail (horizontal line at y=0)
     // Draw stylized rail
-    drawRail(cart);
+    drawRail(scene.railLength);
 
     // Draw cart - position it so it sits ON the rail
-    glm::vec2 cartPos(cart.getPosition(), static_cast<float>(cart.getHeight() / 2.0));  // Center cart above rail
-    glm::vec2 cartSize(static_cast<float>(cart.getWidth()), static_cast<float>(cart.getHeight()));
+    glm::vec2 cartPos(scene.cartPosition, static_cast<float>(scene.cartHeight / 2.0));  // Center cart above rail
+    glm::vec2 cartSize(static_cast<float>(scene.cartWidth), static_cast<float>(scene.cartHeight));
 
     // Cart body
     drawRectangle(cartPos, cartSize, glm::vec3(0.22f, 0.45f, 0.7f));
     // Top panel
-    drawRectangle(cartPos + glm::vec2(0.0f, static_cast<float>(cart.getHeight()*0.15)), glm::vec2(cartSize.x * 0.9f, cartSize.y * 0.4f), glm::vec3(0.18f, 0.36f, 0.55f));
+    drawRectangle(cartPos + glm::vec2(0.0f, static_cast<float>(scene.cartHeight*0.15)), glm::vec2(cartSize.x * 0.9f, cartSize.y * 0.4f), glm::vec3(0.18f, 0.36f, 0.55f));
 
     // Wheels (two wheels under the cart)
     float wheelOffset = cartSize.x * 0.33f;
-    float wheelY = static_cast<float>(-cart.getHeight() / 2.0 + 0.0f); // wheels aligned slightly below cart center
+    float wheelY = static_cast<float>(-scene.cartHeight / 2.0 + 0.0f); // wheels aligned slightly below cart center
     drawWheel(cartPos + glm::vec2(-wheelOffset, wheelY), 0.08f, glm::vec3(0.05f,0.05f,0.05f), glm::vec3(0.6f,0.6f,0.6f));
     drawWheel(cartPos + glm::vec2(wheelOffset, wheelY), 0.08f, glm::vec3(0.05f,0.05f,0.05f), glm::vec3(0.6f,0.6f,0.6f));
 
     // Draw pendulum(s)
-    if (isSingle) {
+    if (scene.numAngles == 1) {
         // Single pendulum
-        const SinglePendulum* sp = dynamic_cast<const SinglePendulum*>(&pendulum);
-        if (sp) {
-            double angle = sp->getAngle(0);
-            double length = sp->getLength();
-
-            // Pendulum starts at top of cart
-            // Pendulum starts at top of cart (top of cart is cartPos + half height)
-            glm::vec2 pendulumStart = cartPos + glm::vec2(0.0f, static_cast<float>(cart.getHeight() / 2.0));
-            // Physics uses angle where 0 = hanging down; convert to screen coords
-            // (x = L*sin(theta), y = -L*cos(theta)) because +y is up in screen space.
-            glm::vec2 pendulumEnd = pendulumStart + glm::vec2(
-                static_cast<float>(length * std::sin(angle)),
-                static_cast<float>(-length * std::cos(angle))
-            );
-
-            // Draw rod
-            drawLine(pendulumStart, pendulumEnd, glm::vec3(0.85f, 0.75f, 0.25f), 0.03f);
-            // Mass with rim
-            drawCircle(pendulumEnd, 0.10f, glm::vec3(0.95f, 0.85f, 0.35f));
-            drawCircle(pendulumEnd, 0.06f, glm::vec3(0.25f,0.18f,0.08f));
-        }
+        double angle = scene.angle[0];
+        double length = scene.length[0];
+
+        // Pendulum starts at top of cart (top of cart is cartPos + half height)
+        glm::vec2 pendulumStart = cartPos + glm::vec2(0.0f, static_cast<float>(scene.cartHeight / 2.0));
+        // Physics uses angle where 0 = hanging down; convert to screen coords
+        // (x = L*sin(theta), y = -L*cos(theta)) because +y is up in screen space.
+        glm::vec2 pendulumEnd = pendulumStart + glm::vec2(
+            static_cast<float>(length * std::sin(angle)),
+            static_cast<float>(-length * std::cos(angle))
+        );
+
+        // Draw rod
+        drawLine(pendulumStart, pendulumEnd, glm::vec3(0.85f, 0.75f, 0.25f), 0.03f);
+        // Mass with rim
+        drawCircle(pendulumEnd, 0.10f, glm::vec3(0.95f, 0.85f, 0.35f));
+        drawCircle(pendulumEnd, 0.06f, glm::vec3(0.25f,0.18f,0.08f));
     }
-    else {
+    else if (scene.numAngles == 2) {
         // Double pendulum
-        const DoublePendulum* dp = dynamic_cast<const DoublePendulum*>(&pendulum);
-        if (dp) {
-            double angle1 = dp->getAngle(0);
-            double angle2 = dp->getAngle(1);
-            double length1 = dp->getLength(0);
-            double length2 = dp->getLength(1);
-
-            // First pendulum starts at top of cart
-            glm::vec2 start = cartPos + glm::vec2(0.0f, static_cast<float>(cart.getHeight() / 2.0));
-            glm::vec2 joint = start + glm::vec2(
-                static_cast<float>(length1 * std::sin(angle1)),
-                static_cast<float>(-length1 * std::cos(angle1))
-            );
-
-            // Second pendulum starts at end of first
-            glm::vec2 end = joint + glm::vec2(
-                static_cast<float>(length2 * std::sin(angle2)),
-                static_cast<float>(-length2 * std::cos(angle2))
-            );
-
-            // Draw first rod (yellow)
-            drawLine(start, joint, glm::vec3(0.85f,0.75f,0.25f), 0.03f);
-            drawCircle(joint, 0.10f, glm::vec3(0.95f,0.85f,0.35f));
-            drawCircle(joint, 0.06f, glm::vec3(0.25f,0.18f,0.08f));
-
-            drawLine(joint, end, glm::vec3(0.22f,0.5f,0.92f), 0.03f);
-            drawCircle(end, 0.10f, glm::vec3(0.35f,0.68f,1.0f));
-            drawCircle(end, 0.06f, glm::vec3(0.08f,0.06f,0.03f));
-        }
+        double angle1 = scene.angle[0];
+        double angle2 = scene.angle[1];
+        double length1 = scene.length[0];
+        double length2 = scene.length[1];
+
+        // First pendulum starts at top of cart
+        glm::vec2 start = cartPos + glm::vec2(0.0f, static_cast<float>(scene.cartHeight / 2.0));
+        glm::vec2 joint = start + glm::vec2(
+            static_cast<float>(length1 * std::sin(angle1)),
+            static_cast<float>(-length1 * std::cos(angle1))
+        );
+
+        // Second pendulum starts at end of first
+        glm::vec2 end = joint + glm::vec2(
+            static_cast<float>(length2 * std::sin(angle2)),
+            static_cast<float>(-length2 * std::cos(angle2))
+        );
+
+        // Draw first rod (yellow)
+        drawLine(start, joint, glm::vec3(0.85f,0.75f,0.25f), 0.03f);
+        drawCircle(joint, 0.10f, glm::vec3(0.95f,0.85f,0.35f));
+        drawCircle(joint, 0.06f, glm::vec3(0.25f,0.18f,0.08f));
+
+        drawLine(joint, end, glm::vec3(0.22f,0.5f,0.92f), 0.03f);
+        drawCircle(end, 0.10f, glm::vec3(0.35f,0.68f,1.0f));
+        drawCircle(end, 0.06f, glm::vec3(0.08f,0.06f,0.03f));
     }
 }
 
@@ -146,9 +186,9 @@ void Renderer::drawWheel(const glm::vec2& center, float radius, const glm::vec3&
     drawLine(center, spokeEnd, glm::vec3(0.1f,0.1f,0.1f), 0.015f);
 }
 
-void Renderer::drawRail(const Cart& cart)
+void Renderer::drawRail(double railLength)
 {
-    float halfRail = cart.getRailLength() / 2.0f;
+    float halfRail = static_cast<float>(railLength / 2.0);
     // Base rail strip (dark)
     drawLine(glm::vec2(-halfRail, 0.0f), glm::vec2(halfRail, 0.0f), glm::vec3(0.12f,0.12f,0.12f), 0.12f);
     // Top shiny rail edge
@@ -9,6 +9,29 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+/**
+ * SceneSnapshot - what Renderer draws of the simulation at one instant
+ *
+ * Taken by the physics thread after each tick (capture()) and handed to
+ * the render loop, which draws between the two latest ones.
+ */
+struct SceneSnapshot
+{
+    double time = 0.0;                  // seconds, on the clock used to interpolate
+    double cartPosition = 0.0;
+    double cartWidth = 0.0;
+    double cartHeight = 0.0;
+    double railLength = 0.0;
+    int numAngles = 0;                  // 1 or 2 drawn links
+    double angle[2] = {};
+    double length[2] = {};
+
+    static SceneSnapshot capture(const Cart& cart, const Pendulum& pendulum, double time);
+    // previous + alpha * (current - previous); angles the short way round,
+    // and no sweep across the rail when the cart wrapped or the link count changed
+    static SceneSnapshot interpolate(const SceneSnapshot& previous, const SceneSnapshot& current, double alpha);
+};
+
 /**
  * Renderer - handles all OpenGL rendering in 2D
  */
@@ -19,7 +42,10 @@ public:
     ~Renderer();
     
     void initialize();
-    void render(const Cart& cart, const Pendulum& pendulum, bool isSingle);
+    void render(const Cart& cart, const Pendulum& pendulum);
+    // Draws the state alpha of the way from previous to current (0..1)
+    void render(const SceneSnapshot& previous, const SceneSnapshot& current, double alpha);
+    void render(const SceneSnapshot& scene);
     void onWindowResize(int width, int height);
     // Adjust view width to fit the given rail length (meters). Max cap applied.
     void setViewWidthForRail(double railLength);
@@ -48,7 +74,7 @@ private:
     void drawCircle(const glm::vec2& position, float radius, 
                    const glm::vec3& color);
     void drawWheel(const glm::vec2& center, float radius, const glm::vec3& tireColor, const glm::vec3& rimColor);
-    void drawRail(const Cart& cart);
+    void drawRail(double railLength);
     
     void updateProjection();
     
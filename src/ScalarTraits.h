@@ -0,0 +1,18 @@
+#pragma once
+
+#include <limits>
+
+/**
+ * ScalarTraits - what generic numerical code needs to know about a scalar type
+ *
+ * The integrators and equations of motion are templated on the scalar
+ * (double, float, or Dual<M> for forward-mode derivatives). Control flow such
+ * as convergence tests only looks at the plain value, in double precision,
+ * against a tolerance no tighter than the scalar's precision allows.
+ */
+template <typename Scalar>
+struct ScalarTraits
+{
+    static double value(Scalar x) { return static_cast<double>(x); }
+    static constexpr double EPSILON = std::numeric_limits<Scalar>::epsilon();
+};
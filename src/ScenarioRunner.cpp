@@ -0,0 +1,366 @@
+#include "ScenarioRunner.h"
+#include "Cart.h"
+#include "CartPendulumSystem.h"
+#include "ChainPendulum.h"
+#include "DoublePendulum.h"
+#include "IlqrSolver.h"
+#include "LqrController.h"
+#include "MlpPolicy.h"
+#include "PendulumEnv.h"
+#include "SinglePendulum.h"
+#include "TrajectoryRecorder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace
+{
+    std::string trim(const std::string& text)
+    {
+        std::size_t begin = 0;
+        std::size_t end = text.size();
+        while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) ++begin;
+        while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) --end;
+        return text.substr(begin, end - begin);
+    }
+
+    std::string lower(std::string text)
+    {
+        for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+
+    bool parseDouble(const std::string& text, double& value)
+    {
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return !text.empty() && *end == '\0' && std::isfinite(value);
+    }
+
+    bool parseInt(const std::string& text, int& value)
+    {
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        value = static_cast<int>(parsed);
+        return !text.empty() && *end == '\0' && parsed == value;
+    }
+
+    bool parseBool(const std::string& text, bool& value)
+    {
+        const std::string word = lower(text);
+        if (word == "1" || word == "true" || word == "yes" || word == "on") value = true;
+        else if (word == "0" || word == "false" || word == "no" || word == "off") value = false;
+        else return false;
+        return true;
+    }
+
+    bool parseIntegrator(const std::string& text, IntegratorType& type)
+    {
+        int index = 0;
+        if (!parseInt(text, index)) {
+            for (index = 0; index < INTEGRATOR_TYPE_COUNT; ++index) {
+                if (lower(text) == lower(getIntegratorName(static_cast<IntegratorType>(index)))) break;
+            }
+        }
+        if (index < 0 || index >= INTEGRATOR_TYPE_COUNT) return false;
+        type = static_cast<IntegratorType>(index);
+        return true;
+    }
+
+    bool parseController(const std::string& text, ScenarioController& controller)
+    {
+        const ScenarioController all[] = { ScenarioController::Scripted, ScenarioController::Policy,
+            ScenarioController::Lqr, ScenarioController::Mpc };
+        for (ScenarioController candidate : all) {
+            if (lower(text) == ScenarioRunner::getControllerName(candidate)) {
+                controller = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Names become file names (PendulumBatch --output-dir): no separators or ".."
+    bool isValidName(const std::string& name)
+    {
+        return !name.empty() && name.find_first_of("/\\") == std::string::npos
+            && name.find("..") == std::string::npos;
+    }
+
+    double uprightError(const Pendulum& pendulum)
+    {
+        const double PI = 3.14159265358979323846;
+        double error = 0.0;
+        for (int link = 0; link < pendulum.getNumAngles(); ++link) {
+            error = std::max(error, std::abs(std::remainder(pendulum.getAngle(link) - PI, 2.0 * PI)));
+        }
+        return error;
+    }
+}
+
+const char* ScenarioRunner::getControllerName(ScenarioController controller)
+{
+    switch (controller) {
+    case ScenarioController::Scripted: return "scripted";
+    case ScenarioController::Policy: return "policy";
+    case ScenarioController::Lqr: return "lqr";
+    case ScenarioController::Mpc: return "mpc";
+    }
+    return "unknown";
+}
+
+bool ScenarioRunner::set(Scenario& scenario, const std::string& key, const std::string& value)
+{
+    bool ok = true;
+    if (key == "name") { scenario.name = value; ok = isValidName(value); }
+    else if (key == "links") ok = parseInt(value, scenario.links);
+    else if (key == "coupled") ok = parseBool(value, scenario.coupled);
+    else if (key == "integrator") ok = parseIntegrator(value, scenario.integrator);
+    else if (key == "dt") ok = parseDouble(value, scenario.dt);
+    else if (key == "duration") ok = parseDouble(value, scenario.duration);
+    else if (key == "gravity") ok = parseDouble(value, scenario.gravity);
+    else if (key == "friction") ok = parseDouble(value, scenario.friction);
+    else if (key == "cart_mass") ok = parseDouble(value, scenario.cartMass);
+    else if (key == "rail_length") ok = parseDouble(value, scenario.railLength);
+    else if (key == "mass1") ok = parseDouble(value, scenario.mass[0]);
+    else if (key == "mass2") ok = parseDouble(value, scenario.mass[1]);
+    else if (key == "length1") ok = parseDouble(value, scenario.length[0]);
+    else if (key == "length2") ok = parseDouble(value, scenario.length[1]);
+    else if (key == "angle1") ok = parseDouble(value, scenario.initialAngle[0]);
+    else if (key == "angle2") ok = parseDouble(value, scenario.initialAngle[1]);
+    else if (key == "controller") ok = parseController(value, scenario.controller);
+    else if (key == "accel") ok = parseDouble(value, scenario.accelAmplitude);
+    else if (key == "freq") ok = parseDouble(value, scenario.accelFrequency);
+    else if (key == "policy") scenario.policyPath = value;
+    else if (key == "policy_every") ok = parseInt(value, scenario.policyEvery);
+    else if (key == "max_accel") ok = parseDouble(value, scenario.maxAcceleration);
+    else if (key == "mpc_iterations") ok = parseInt(value, scenario.mpcIterations);
+    else if (key == "mpc_budget") ok = parseDouble(value, scenario.mpcBudget);
+    else if (key == "output") scenario.outputPath = value;
+    else {
+        std::cerr << "ERROR: Unknown scenario key: " << key << std::endl;
+        return false;
+    }
+    if (!ok) std::cerr << "ERROR: Bad value for scenario key " << key << ": " << value << std::endl;
+    return ok;
+}
+
+bool ScenarioRunner::load(const std::string& path, const Scenario& defaults, std::vector<Scenario>& scenarios)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "ERROR: Failed to open scenario file: " << path << std::endl;
+        return false;
+    }
+
+    Scenario base = defaults;
+    Scenario* current = &base;
+    std::vector<Scenario> loaded;
+    std::string line;
+    for (int number = 1; std::getline(file, line); ++number) {
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        if (line.front() == '[' && line.back() == ']') {
+            loaded.push_back(base);
+            loaded.back().name = trim(line.substr(1, line.size() - 2));
+            current = &loaded.back();
+            if (isValidName(current->name)) continue;
+        }
+        else {
+            const std::size_t equals = line.find('=');
+            if (equals != std::string::npos
+                && set(*current, trim(line.substr(0, equals)), trim(line.substr(equals + 1)))) {
+                continue;
+            }
+        }
+        std::cerr << "ERROR: " << path << ":" << number
+            << ": expected [name] (without '/', '\\' or '..') or key = value" << std::endl;
+        return false;
+    }
+    if (loaded.empty()) {
+        std::cerr << "ERROR: No [scenario] sections in " << path << std::endl;
+        return false;
+    }
+    scenarios.insert(scenarios.end(), loaded.begin(), loaded.end());
+    return true;
+}
+
+bool ScenarioRunner::validate(const Scenario& scenario)
+{
+    const std::string prefix = "ERROR: Scenario " + scenario.name + ": ";
+    if (!isValidName(scenario.name)) {
+        std::cerr << prefix << "names must be non-empty and contain no '/', '\\' or '..'" << std::endl;
+        return false;
+    }
+    if (scenario.links < 1 || !(scenario.dt > 0.0) || scenario.duration < 0.0 || scenario.policyEvery < 1) {
+        std::cerr << prefix << "needs links >= 1, dt > 0, duration >= 0 and policy_every >= 1" << std::endl;
+        return false;
+    }
+    if (!(scenario.cartMass > 0.0 && scenario.railLength > 0.0 && scenario.mass[0] > 0.0
+        && scenario.mass[1] > 0.0 && scenario.length[0] > 0.0 && scenario.length[1] > 0.0)) {
+        std::cerr << prefix << "masses, lengths and rail length must be positive" << std::endl;
+        return false;
+    }
+    if (scenario.coupled && scenario.links > 2) {
+        std::cerr << prefix << "coupled dynamics need 1 or 2 links" << std::endl;
+        return false;
+    }
+    if ((scenario.controller == ScenarioController::Lqr || scenario.controller == ScenarioController::Mpc)
+        && scenario.links > 2) {
+        std::cerr << prefix << getControllerName(scenario.controller) << " control needs 1 or 2 links" << std::endl;
+        return false;
+    }
+    if (scenario.controller == ScenarioController::Policy && scenario.policyPath.empty()) {
+        std::cerr << prefix << "policy control needs a policy file" << std::endl;
+        return false;
+    }
+    if (scenario.controller == ScenarioController::Mpc && (scenario.mpcIterations < 1 || scenario.mpcBudget < 0.0)) {
+        std::cerr << prefix << "mpc_iterations must be >= 1 and mpc_budget >= 0" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ScenarioResult ScenarioRunner::run(const Scenario& scenario, const TickObserver& observer)
+{
+    ScenarioResult result;
+    if (!validate(scenario)) return result;
+    const std::string prefix = "ERROR: Scenario " + scenario.name + ": ";
+
+    Cart cart(scenario.cartMass, scenario.railLength);
+    std::unique_ptr<Pendulum> pendulum;
+    if (scenario.links > 2) {
+        auto p = std::make_unique<ChainPendulum>(scenario.links, scenario.mass[0], scenario.length[0]);
+        p->setInitialAngle(0, scenario.initialAngle[0]);
+        p->setInitialAngle(1, scenario.initialAngle[1]);
+        pendulum = std::move(p);
+    }
+    else if (scenario.links == 2) {
+        auto p = std::make_unique<DoublePendulum>(scenario.mass[0], scenario.length[0],
+            scenario.mass[1], scenario.length[1]);
+        p->setInitialAngle(0, scenario.initialAngle[0]);
+        p->setInitialAngle(1, scenario.initialAngle[1]);
+        pendulum = std::move(p);
+    }
+    else {
+        auto p = std::make_unique<SinglePendulum>(scenario.mass[0], scenario.length[0]);
+        p->setInitialAngle(scenario.initialAngle[0]);
+        pendulum = std::move(p);
+    }
+    pendulum->reset();
+    pendulum->setGravity(scenario.gravity);
+    pendulum->setDamping(scenario.friction);
+    pendulum->setIntegrator(scenario.integrator);
+    cart.setIntegrator(scenario.integrator);
+    CartPendulumSystem coupled(cart, *pendulum);
+
+    const int numAngles = pendulum->getNumAngles();
+    std::vector<double> observation(2 + 2 * numAngles);
+
+    MlpPolicy policy;
+    if (scenario.controller == ScenarioController::Policy) {
+        if (!policy.load(scenario.policyPath)) return result;
+        if (policy.getInputSize() != static_cast<int>(observation.size())) {
+            std::cerr << prefix << "policy expects " << policy.getInputSize() << " inputs, the "
+                << numAngles << "-link observation has " << observation.size() << std::endl;
+            return result;
+        }
+    }
+    LqrController lqr;
+    if (scenario.controller == ScenarioController::Lqr
+        && !lqr.setModel(*pendulum, scenario.dt, scenario.friction)) {
+        std::cerr << prefix << "no stabilizing LQR gains for these parameters" << std::endl;
+        return result;
+    }
+    IlqrConfig mpcConfig;
+    mpcConfig.maxAcceleration = scenario.maxAcceleration;
+    mpcConfig.maxIterations = scenario.mpcIterations;
+    // No wall-clock limit: the same result on any machine and under any load
+    mpcConfig.budgetSeconds = scenario.mpcBudget > 0.0 ? scenario.mpcBudget : 1e6;
+    IlqrSolver mpc(mpcConfig);
+    if (scenario.controller == ScenarioController::Mpc) {
+        mpc.setModel(*pendulum, scenario.dt, scenario.friction, scenario.railLength);
+    }
+
+    TrajectoryRecorder recorder;
+    if (!scenario.outputPath.empty() && !recorder.open(scenario.outputPath, numAngles, scenario.dt)) {
+        return result;
+    }
+
+    const double TWO_PI = 2.0 * 3.14159265358979323846;
+    const std::uint64_t ticks = static_cast<std::uint64_t>(std::llround(scenario.duration / scenario.dt));
+    const double initialEnergy = 0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity()
+        + pendulum->getTotalEnergy(cart.getVelocity());
+    double simulationTime = 0.0;
+    double appliedAcceleration = 0.0;
+    double effectiveAcceleration = 0.0;
+    double heldAction = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::uint64_t tick = 0; tick <= ticks; ++tick) {
+        if (recorder.isOpen() && !recorder.record(0, simulationTime, cart, *pendulum,
+            appliedAcceleration, effectiveAcceleration)) {
+            return result;
+        }
+        if (observer) observer(tick, simulationTime, cart, *pendulum);
+        if (tick == ticks) break;
+
+        switch (scenario.controller) {
+        case ScenarioController::Scripted:
+            appliedAcceleration = scenario.accelAmplitude;
+            if (scenario.accelFrequency > 0.0) {
+                appliedAcceleration *= std::sin(TWO_PI * scenario.accelFrequency * simulationTime);
+            }
+            break;
+        case ScenarioController::Policy:
+            if (tick % scenario.policyEvery == 0) {
+                PendulumEnv::writeObservation(cart, *pendulum, observation.data());
+                heldAction = std::clamp(policy.act(observation.data()), -1.0, 1.0);
+            }
+            appliedAcceleration = heldAction * scenario.maxAcceleration;
+            break;
+        case ScenarioController::Lqr:
+            PendulumEnv::writeObservation(cart, *pendulum, observation.data());
+            appliedAcceleration = std::clamp(lqr.act(observation.data(), static_cast<int>(observation.size())),
+                -scenario.maxAcceleration, scenario.maxAcceleration);
+            break;
+        case ScenarioController::Mpc:
+            // Re-plan every control step, one step shifted; the action is held in between
+            if (tick % mpcConfig.ticksPerStep == 0) {
+                PendulumEnv::writeObservation(cart, *pendulum, observation.data());
+                if (tick > 0) mpc.shift(1);
+                mpc.solve(observation.data());
+                heldAction = mpc.getAction(0);
+            }
+            appliedAcceleration = heldAction;
+            break;
+        }
+
+        if (scenario.coupled) {
+            effectiveAcceleration = coupled.update(scenario.dt, appliedAcceleration, scenario.friction);
+        }
+        else {
+            effectiveAcceleration = cart.update(scenario.dt, appliedAcceleration,
+                scenario.friction, scenario.gravity);
+            pendulum->update(scenario.dt, effectiveAcceleration);
+        }
+        simulationTime += scenario.dt;
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ok = true;
+    result.ticks = ticks;
+    result.simulatedSeconds = simulationTime;
+    result.finalCartPosition = cart.getPosition();
+    result.finalUprightError = uprightError(*pendulum);
+    result.energyDrift = 0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity()
+        + pendulum->getTotalEnergy(cart.getVelocity()) - initialEnergy;
+    result.records = recorder.isOpen() ? recorder.getRecordCount() : 0;
+    return result;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Integrators.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class Cart;
+class Pendulum;
+
+/**
+ * ScenarioController - what drives the cart in a Scenario
+ */
+enum class ScenarioController
+{
+    Scripted,       // accel * sin(2 pi freq t), constant when freq is 0
+    Policy,         // MlpPolicy weights file
+    Lqr,            // LQR balance control (1-2 links)
+    Mpc             // iLQR receding horizon, solved synchronously (1-2 links)
+};
+
+/**
+ * Scenario - one unattended simulation run
+ *
+ * Defaults are the viewer's. In a scenario file (ScenarioRunner::load)
+ * every field is a `key = value` line; the key is given next to each field.
+ */
+struct Scenario
+{
+    std::string name = "scenario";                          // [name] section header; no '/', '\\' or '..'
+    int links = 1;                                          // links: 1, 2, 3+ = chain
+    bool coupled = false;                                   // coupled: cart + pendulum as one system (1-2 links)
+    IntegratorType integrator = IntegratorType::DormandPrince87;   // integrator: index or name
+    double dt = 1.0 / 144.0;                                // dt (s)
+    double duration = 10.0;                                 // duration (simulated s)
+
+    double gravity = 9.81;                                  // gravity
+    double friction = 0.1;                                  // friction: cart friction and link damping
+    double cartMass = 1.0;                                  // cart_mass
+    double railLength = 10.0;                               // rail_length
+    double mass[2] = { 1.0, 1.0 };                          // mass1, mass2 (chain: mass1 per link)
+    double length[2] = { 1.0, 1.0 };                        // length1, length2 (chain: length1 per link)
+    double initialAngle[2] = { 0.5, 0.0 };                  // angle1, angle2 (rad, 0 = hanging)
+
+    ScenarioController controller = ScenarioController::Scripted;   // controller: scripted, policy, lqr, mpc
+    double accelAmplitude = 0.0;                            // accel (m/s^2, scripted)
+    double accelFrequency = 0.0;                            // freq (Hz, scripted)
+    std::string policyPath;                                 // policy
+    int policyEvery = 4;                                    // policy_every (ticks)
+    double maxAcceleration = 30.0;                          // max_accel (m/s^2, policy / lqr / mpc)
+    int mpcIterations = 30;                                 // mpc_iterations per solve
+    double mpcBudget = 0.0;                                 // mpc_budget (s per solve, 0 = iterations only)
+
+    std::string outputPath;                                 // output: trajectory file, empty = none
+};
+
+/**
+ * ScenarioResult - outcome of ScenarioRunner::run
+ */
+struct ScenarioResult
+{
+    bool ok = false;                    // false: setup failed (reported on std::cerr)
+    std::uint64_t ticks = 0;
+    double simulatedSeconds = 0.0;
+    double wallSeconds = 0.0;
+    double finalCartPosition = 0.0;
+    double finalUprightError = 0.0;     // largest |angle - pi| of any link at the end (rad)
+    double energyDrift = 0.0;           // final - initial total energy (J)
+    std::uint64_t records = 0;          // written to outputPath
+};
+
+/**
+ * ScenarioRunner - parses and runs Scenarios without a window
+ *
+ * A scenario file holds `key = value` lines (keys as in Scenario, `#`
+ * comments). Lines before the first `[name]` header change the defaults;
+ * each header starts a scenario from the defaults as they are at that
+ * point. run() uses the same objects and per-tick sequence as the
+ * interactive loop, unpaced: controller, then cart and pendulum (or the
+ * coupled system), then one record per tick when an output path is set.
+ * PendulumBatch and PendulumHeadless both run through it. A run touches
+ * nothing shared, so scenarios can run concurrently; MPC runs with
+ * mpc_budget 0 are deterministic.
+ */
+class ScenarioRunner
+{
+public:
+    // Parse one value into scenario (false and an error message otherwise)
+    static bool set(Scenario& scenario, const std::string& key, const std::string& value);
+    // Append the scenarios of a file; false on the first bad line
+    static bool load(const std::string& path, const Scenario& defaults, std::vector<Scenario>& scenarios);
+    // Name usable as a file name, parameters in range and the controller
+    // available for the link count
+    static bool validate(const Scenario& scenario);
+
+    static const char* getControllerName(ScenarioController controller);
+
+    // Called with the state at the start of every tick and once after the
+    // last one (tick == ticks), where the trajectory record is written
+    using TickObserver = std::function<void(std::uint64_t tick, double time, const Cart& cart,
+        const Pendulum& pendulum)>;
+
+    static ScenarioResult run(const Scenario& scenario, const TickObserver& observer = TickObserver());
+};
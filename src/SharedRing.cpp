@@ -0,0 +1,240 @@
+#include "SharedRing.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    // Slots start on their own cache lines
+    constexpr std::size_t CACHE_LINE = 64;
+
+    std::size_t roundUp(std::size_t bytes)
+    {
+        return (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    }
+
+    // Shared (not FUTEX_PRIVATE) operations: the word lives in a mapping
+    // that another process also waits on
+    // false when the timeout expired
+    bool futexWait(std::atomic<std::uint32_t>& word, std::uint32_t value, int timeoutMs)
+    {
+        timespec timeout{ timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+        return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, value, &timeout,
+            nullptr, 0) == 0 || errno != ETIMEDOUT;
+    }
+
+    void futexWake(std::atomic<std::uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+
+    // A pid that is 0 (not attached yet) or still runs counts as alive.
+    // kill() EPERM means it exists under another user; a zombie (a forked
+    // peer not reaped yet, often by the waiting process itself) is dead
+    bool isAlive(const std::atomic<std::int32_t>& pid)
+    {
+        const pid_t value = pid.load(std::memory_order_acquire);
+        if (value == 0) return true;
+        if (kill(value, 0) != 0 && errno == ESRCH) return false;
+
+        std::ifstream stat("/proc/" + std::to_string(value) + "/stat");
+        std::string line;
+        if (!std::getline(stat, line)) return true;
+        const std::size_t state = line.rfind(')');
+        return state == std::string::npos || state + 2 >= line.size() || line[state + 2] != 'Z';
+    }
+
+    void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+    close();
+}
+
+bool SharedMemorySegment::create(const std::string& name, std::size_t bytes)
+{
+    close();
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "ERROR: shm_open(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "ERROR: ftruncate(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "ERROR: mmap(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+    m_name = name;
+    m_data = data;
+    m_size = bytes;
+    m_owner = true;
+    return true;
+}
+
+bool SharedMemorySegment::open(const std::string& name)
+{
+    close();
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "ERROR: shm_open(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        std::cerr << "ERROR: shared memory " << name << " is empty" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "ERROR: mmap(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    m_name = name;
+    m_data = data;
+    m_size = bytes;
+    m_owner = false;
+    return true;
+}
+
+void SharedMemorySegment::close()
+{
+    if (m_data) {
+        munmap(m_data, m_size);
+        if (m_owner) shm_unlink(m_name.c_str());
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_owner = false;
+}
+
+std::uint32_t SharedRing::roundSlotCount(std::uint32_t slots)
+{
+    std::uint32_t rounded = 1;
+    while (rounded < slots && rounded < (1u << 31)) rounded <<= 1;
+    return rounded;
+}
+
+std::size_t SharedRing::getRequiredBytes(std::uint32_t slots, std::size_t slotBytes)
+{
+    return roundUp(sizeof(Control)) + roundSlotCount(slots) * roundUp(slotBytes);
+}
+
+SharedRing::SharedRing(void* memory, std::uint32_t slots, std::size_t slotBytes)
+    : m_control(static_cast<Control*>(memory))
+    , m_data(static_cast<unsigned char*>(memory) + roundUp(sizeof(Control)))
+    , m_slots(roundSlotCount(slots))
+    , m_slotBytes(roundUp(slotBytes))
+{
+    // Spinning only pays off when the peer can run at the same time
+    m_spinCount = std::thread::hardware_concurrency() > 1 ? 20000 : 0;
+}
+
+void SharedRing::initialize()
+{
+    new (m_control) Control();
+    m_control->head.store(0, std::memory_order_relaxed);
+    m_control->headWaiters.store(0, std::memory_order_relaxed);
+    m_control->tail.store(0, std::memory_order_relaxed);
+    m_control->tailWaiters.store(0, std::memory_order_relaxed);
+    m_control->writerPid.store(0, std::memory_order_relaxed);
+    m_control->readerPid.store(0, std::memory_order_release);
+}
+
+void SharedRing::attachWriter()
+{
+    m_control->writerPid.store(static_cast<std::int32_t>(getpid()), std::memory_order_release);
+}
+
+void SharedRing::attachReader()
+{
+    m_control->readerPid.store(static_cast<std::int32_t>(getpid()), std::memory_order_release);
+}
+
+void* SharedRing::beginWrite()
+{
+    // Full while head - tail == slots
+    std::uint32_t head = m_control->head.load(std::memory_order_relaxed);
+    if (!waitWhileEqual(m_control->tail, m_control->tailWaiters, head - m_slots, m_control->readerPid)) {
+        return nullptr;
+    }
+    return m_data + (head & (m_slots - 1)) * m_slotBytes;
+}
+
+void SharedRing::endWrite()
+{
+    advance(m_control->head, m_control->headWaiters);
+}
+
+const void* SharedRing::beginRead()
+{
+    std::uint32_t tail = m_control->tail.load(std::memory_order_relaxed);
+    if (!waitWhileEqual(m_control->head, m_control->headWaiters, tail, m_control->writerPid)) {
+        return nullptr;
+    }
+    return m_data + (tail & (m_slots - 1)) * m_slotBytes;
+}
+
+void SharedRing::endRead()
+{
+    advance(m_control->tail, m_control->tailWaiters);
+}
+
+bool SharedRing::waitWhileEqual(std::atomic<std::uint32_t>& counter, std::atomic<std::uint32_t>& waiters,
+    std::uint32_t value, const std::atomic<std::int32_t>& peerPid)
+{
+    for (int spin = 0; spin < m_spinCount; ++spin) {
+        if (counter.load(std::memory_order_acquire) != value) return true;
+        cpuRelax();
+    }
+    // Register before the final check; advance() bumps the counter before
+    // reading waiters, so one of the two sides always sees the other
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool changed = true;
+    while (counter.load(std::memory_order_seq_cst) == value) {
+        if (!futexWait(counter, value, PEER_CHECK_MS) && !isAlive(peerPid)) {
+            // One last look: the peer may have advanced just before exiting
+            changed = counter.load(std::memory_order_seq_cst) != value;
+            break;
+        }
+    }
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return changed;
+}
+
+void SharedRing::advance(std::atomic<std::uint32_t>& counter, std::atomic<std::uint32_t>& waiters)
+{
+    counter.fetch_add(1, std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_seq_cst) != 0) {
+        futexWake(counter);
+    }
+}
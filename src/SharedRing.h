@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * SharedMemorySegment - named POSIX shared-memory mapping (shm_open + mmap)
+ *
+ * create() makes (or truncates) the object and unlinks it again in the
+ * destructor; open() maps an existing one at its current size. Both print
+ * an error and return false on failure. Linux only.
+ */
+class SharedMemorySegment
+{
+public:
+    SharedMemorySegment() = default;
+    ~SharedMemorySegment();
+
+    SharedMemorySegment(const SharedMemorySegment&) = delete;
+    SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+
+    bool create(const std::string& name, std::size_t bytes);
+    bool open(const std::string& name);
+    void close();
+
+    void* getData() const { return m_data; }
+    std::size_t getSize() const { return m_size; }
+
+private:
+    std::string m_name;
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_owner = false;
+};
+
+/**
+ * SharedRing - lock-free single-producer / single-consumer ring of
+ * fixed-size slots, laid out in caller-provided (usually shared) memory
+ *
+ * The producer fills the slot returned by beginWrite() in place and
+ * publishes it with endWrite(); the consumer reads beginRead() in place
+ * and hands the slot back with endRead(). Nothing is copied or serialized.
+ *
+ * Head and tail are free-running 32-bit counters on separate cache lines.
+ * The slot count is rounded up to a power of two so that counter & (slots
+ * - 1) stays continuous when the counters wrap.
+ * A side that finds the ring full / empty spins for getSpinCount()
+ * iterations, then sleeps on the counter with a process-shared futex; the
+ * other side only issues FUTEX_WAKE when a waiter has registered, so the
+ * fast path is two atomic operations and no system call.
+ *
+ * Both processes construct a SharedRing over the same memory; exactly one
+ * of them calls initialize() before the other attaches. Each side records
+ * its pid with attachWriter() / attachReader(); a sleeping side wakes every
+ * PEER_CHECK_MS to check that the peer still exists, and beginWrite() /
+ * beginRead() return nullptr once it has exited. Until the peer has
+ * attached, they wait for it.
+ */
+class SharedRing
+{
+public:
+    // Slot count actually used for a requested one: at least 1, rounded up
+    // to a power of two
+    static std::uint32_t roundSlotCount(std::uint32_t slots);
+    static std::size_t getRequiredBytes(std::uint32_t slots, std::size_t slotBytes);
+
+    SharedRing() = default;
+    SharedRing(void* memory, std::uint32_t slots, std::size_t slotBytes);
+
+    static constexpr int PEER_CHECK_MS = 100;
+
+    void initialize();
+    void attachWriter();
+    void attachReader();
+
+    // nullptr: the peer exited while this side waited
+    void* beginWrite();
+    void endWrite();
+    const void* beginRead();
+    void endRead();
+
+    // Busy-wait iterations before sleeping; 0 = sleep immediately
+    void setSpinCount(int spins) { m_spinCount = spins; }
+    int getSpinCount() const { return m_spinCount; }
+
+    std::uint32_t getSlotCount() const { return m_slots; }
+    std::size_t getSlotBytes() const { return m_slotBytes; }
+
+private:
+    struct Control
+    {
+        alignas(64) std::atomic<std::uint32_t> head;
+        std::atomic<std::uint32_t> headWaiters;
+        alignas(64) std::atomic<std::uint32_t> tail;
+        std::atomic<std::uint32_t> tailWaiters;
+        alignas(64) std::atomic<std::int32_t> writerPid;   // 0 until attached
+        std::atomic<std::int32_t> readerPid;
+    };
+
+    Control* m_control = nullptr;
+    unsigned char* m_data = nullptr;
+    std::uint32_t m_slots = 0;
+    std::size_t m_slotBytes = 0;
+    int m_spinCount = 0;
+
+    // Block until counter != value (true) or the peer has exited (false)
+    bool waitWhileEqual(std::atomic<std::uint32_t>& counter, std::atomic<std::uint32_t>& waiters,
+        std::uint32_t value, const std::atomic<std::int32_t>& peerPid);
+    void advance(std::atomic<std::uint32_t>& counter, std::atomic<std::uint32_t>& waiters);
+};
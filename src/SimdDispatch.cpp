@@ -0,0 +1,129 @@
+#include "SimdDispatch.h"
+#include "SimdKernels.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(PENDULUM_SIMD_DISPATCH) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One kernel table per compiled copy of SimdKernels.cpp
+namespace simd_baseline
+{
+    const SimdKernels& getKernels();
+}
+
+#if defined(PENDULUM_SIMD_DISPATCH)
+namespace simd_avx2
+{
+    const SimdKernels& getKernels();
+}
+
+namespace simd_avx512
+{
+    const SimdKernels& getKernels();
+}
+#endif
+
+namespace
+{
+    SimdLevel detectSupportedLevel()
+    {
+#if defined(PENDULUM_SIMD_DISPATCH) && defined(_MSC_VER)
+        // CPUID feature bits plus XGETBV: the OS must save the wide registers
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return SimdLevel::BASELINE;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        if (!osxsave || !avx) return SimdLevel::BASELINE;
+        const unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(info, 7, 0);
+        const unsigned ebx = static_cast<unsigned>(info[1]);
+        // AVX-512 F, DQ, CD, BW, VL: what /arch:AVX512 may emit
+        const unsigned avx512Bits = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+        if ((xcr0 & 0xe6) == 0xe6 && (ebx & avx512Bits) == avx512Bits) return SimdLevel::AVX512;
+        if ((xcr0 & 0x6) == 0x6 && (ebx & (1u << 5)) && fma) return SimdLevel::AVX2;
+        return SimdLevel::BASELINE;
+#elif defined(PENDULUM_SIMD_DISPATCH)
+        // Also checks that the OS saves the wide registers
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")
+            && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512bw")
+            && __builtin_cpu_supports("avx512vl")) {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SimdLevel::AVX2;
+        return SimdLevel::BASELINE;
+#else
+        // Only the project-flag copy was built
+        return SimdLevel::BASELINE;
+#endif
+    }
+
+    SimdLevel clampLevel(SimdLevel level)
+    {
+        return static_cast<int>(level) < static_cast<int>(getSupportedSimdLevel()) ? level : getSupportedSimdLevel();
+    }
+
+    // Supported level, capped by PENDULUM_SIMD
+    SimdLevel initialLevel()
+    {
+        const char* requested = std::getenv("PENDULUM_SIMD");
+        if (!requested || !*requested) return getSupportedSimdLevel();
+        for (SimdLevel level : { SimdLevel::BASELINE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+            if (std::strcmp(requested, getSimdLevelName(level)) == 0) return clampLevel(level);
+        }
+        std::cerr << "ERROR: Unknown PENDULUM_SIMD level '" << requested
+            << "' (baseline, avx2 or avx512); using " << getSimdLevelName(getSupportedSimdLevel()) << std::endl;
+        return getSupportedSimdLevel();
+    }
+
+    std::atomic<SimdLevel>& currentLevel()
+    {
+        static std::atomic<SimdLevel> level(initialLevel());
+        return level;
+    }
+}
+
+SimdLevel getSupportedSimdLevel()
+{
+    static const SimdLevel supported = detectSupportedLevel();
+    return supported;
+}
+
+SimdLevel getSimdLevel()
+{
+    return currentLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel setSimdLevel(SimdLevel level)
+{
+    level = clampLevel(level);
+    currentLevel().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+const char* getSimdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    default: return "baseline";
+    }
+}
+
+const SimdKernels& getSimdKernels()
+{
+    switch (getSimdLevel()) {
+#if defined(PENDULUM_SIMD_DISPATCH)
+    case SimdLevel::AVX2: return simd_avx2::getKernels();
+    case SimdLevel::AVX512: return simd_avx512::getKernels();
+#endif
+    default: return simd_baseline::getKernels();
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+struct SimdKernels;
+
+/**
+ * SimdDispatch - runtime choice of the instruction set for the batched kernels
+ *
+ * The SoA kernels behind BasicBatchCartPendulum (SimdKernels.cpp) are
+ * compiled once with the project flags - the portable baseline, scalar
+ * lanes unless PENDULUM_NATIVE_ARCH is on - and, on x86, again for AVX2
+ * (+FMA) and AVX-512. The first call detects the widest set this CPU
+ * supports, so a default build runs 4 or 8 lanes where the hardware has
+ * them and still starts on machines that do not.
+ *
+ * PENDULUM_SIMD=baseline|avx2|avx512 in the environment caps the level for
+ * the whole process; setSimdLevel() does the same from code. The vector
+ * sin/cos and fused multiply-adds round differently from the scalar lanes,
+ * so fix the level before stepping when runs must match across machines.
+ */
+enum class SimdLevel
+{
+    BASELINE,
+    AVX2,
+    AVX512
+};
+
+// Widest level both this build and this CPU support
+SimdLevel getSupportedSimdLevel();
+
+// Level the kernels currently run at
+SimdLevel getSimdLevel();
+
+// Cap the level, clamped to getSupportedSimdLevel(); returns the level now in
+// use. Calls already inside a kernel finish at the previous level.
+SimdLevel setSimdLevel(SimdLevel level);
+
+// "baseline", "avx2" or "avx512"
+const char* getSimdLevelName(SimdLevel level);
+
+// Kernel table for getSimdLevel()
+const SimdKernels& getSimdKernels();
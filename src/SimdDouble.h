@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// SimdKernels.cpp is compiled once per instruction set; each copy puts these
+// types and inline functions in its own namespace so copies built with
+// different -m flags never merge at link time. Everything else gets the
+// project-flag copy through the using-declarations at the end.
+#ifndef PENDULUM_SIMD_NAMESPACE
+#define PENDULUM_SIMD_NAMESPACE simd_baseline
+#endif
+
+namespace PENDULUM_SIMD_NAMESPACE
+{
+
+/**
+ * SimdDouble - a pack of doubles processed in lockstep
+ *
+ * Width is chosen at compile time from the target instruction set:
+ * 8 lanes with AVX-512, 4 lanes with AVX2, or a single lane (plain double)
+ * as the scalar fallback. Which copy the batched kernels run is picked at
+ * runtime (SimdDispatch.h). The batched integrator maps one simulated
+ * environment to each lane.
+ *
+ * Arithmetic, comparisons, select() and sin()/cos() are provided as free
+ * functions so physics templates written against double compile unchanged
+ * against SimdDouble (use `using std::sin;` before calling sin()).
+ */
+#if defined(__AVX512F__)
+
+struct SimdMask
+{
+    __mmask8 m;
+};
+
+struct SimdDouble
+{
+    using Scalar = double;
+    static constexpr int WIDTH = 8;
+    __m512d v;
+
+    SimdDouble() = default;
+    SimdDouble(double x) : v(_mm512_set1_pd(x)) {}
+    SimdDouble(__m512d x) : v(x) {}
+
+    static SimdDouble load(const double* p) { return _mm512_loadu_pd(p); }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+};
+
+inline SimdDouble operator+(SimdDouble a, SimdDouble b) { return _mm512_add_pd(a.v, b.v); }
+inline SimdDouble operator-(SimdDouble a, SimdDouble b) { return _mm512_sub_pd(a.v, b.v); }
+inline SimdDouble operator*(SimdDouble a, SimdDouble b) { return _mm512_mul_pd(a.v, b.v); }
+inline SimdDouble operator/(SimdDouble a, SimdDouble b) { return _mm512_div_pd(a.v, b.v); }
+inline SimdDouble operator-(SimdDouble a)
+{
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a.v),
+        _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL))));
+}
+
+inline SimdMask operator<(SimdDouble a, SimdDouble b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline SimdMask operator>(SimdDouble a, SimdDouble b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline SimdMask operator>=(SimdDouble a, SimdDouble b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ) }; }
+inline SimdMask operator==(SimdDouble a, SimdDouble b) { return { _mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+inline SimdMask operator|(SimdMask a, SimdMask b) { return { static_cast<__mmask8>(a.m | b.m) }; }
+
+// Lane-wise mask ? a : b
+inline SimdDouble select(SimdMask mask, SimdDouble a, SimdDouble b) { return _mm512_mask_blend_pd(mask.m, b.v, a.v); }
+inline SimdDouble abs(SimdDouble a) { return _mm512_abs_pd(a.v); }
+inline SimdDouble roundNearest(SimdDouble a) { return _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline SimdDouble floor(SimdDouble a) { return _mm512_roundscale_pd(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+#elif defined(__AVX2__)
+
+struct SimdMask
+{
+    __m256d m;
+};
+
+struct SimdDouble
+{
+    using Scalar = double;
+    static constexpr int WIDTH = 4;
+    __m256d v;
+
+    SimdDouble() = default;
+    SimdDouble(double x) : v(_mm256_set1_pd(x)) {}
+    SimdDouble(__m256d x) : v(x) {}
+
+    static SimdDouble load(const double* p) { return _mm256_loadu_pd(p); }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+
+inline SimdDouble operator+(SimdDouble a, SimdDouble b) { return _mm256_add_pd(a.v, b.v); }
+inline SimdDouble operator-(SimdDouble a, SimdDouble b) { return _mm256_sub_pd(a.v, b.v); }
+inline SimdDouble operator*(SimdDouble a, SimdDouble b) { return _mm256_mul_pd(a.v, b.v); }
+inline SimdDouble operator/(SimdDouble a, SimdDouble b) { return _mm256_div_pd(a.v, b.v); }
+inline SimdDouble operator-(SimdDouble a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+
+inline SimdMask operator<(SimdDouble a, SimdDouble b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ) }; }
+inline SimdMask operator>(SimdDouble a, SimdDouble b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ) }; }
+inline SimdMask operator>=(SimdDouble a, SimdDouble b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ) }; }
+inline SimdMask operator==(SimdDouble a, SimdDouble b) { return { _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ) }; }
+inline SimdMask operator|(SimdMask a, SimdMask b) { return { _mm256_or_pd(a.m, b.m) }; }
+
+// Lane-wise mask ? a : b
+inline SimdDouble select(SimdMask mask, SimdDouble a, SimdDouble b) { return _mm256_blendv_pd(b.v, a.v, mask.m); }
+inline SimdDouble abs(SimdDouble a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+inline SimdDouble roundNearest(SimdDouble a) { return _mm256_round_pd(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline SimdDouble floor(SimdDouble a) { return _mm256_floor_pd(a.v); }
+
+#else
+
+using SimdMask = bool;
+
+struct SimdDouble
+{
+    using Scalar = double;
+    static constexpr int WIDTH = 1;
+    double v;
+
+    SimdDouble() = default;
+    SimdDouble(double x) : v(x) {}
+
+    static SimdDouble load(const double* p) { return *p; }
+    void store(double* p) const { *p = v; }
+};
+
+inline SimdDouble operator+(SimdDouble a, SimdDouble b) { return a.v + b.v; }
+inline SimdDouble operator-(SimdDouble a, SimdDouble b) { return a.v - b.v; }
+inline SimdDouble operator*(SimdDouble a, SimdDouble b) { return a.v * b.v; }
+inline SimdDouble operator/(SimdDouble a, SimdDouble b) { return a.v / b.v; }
+inline SimdDouble operator-(SimdDouble a) { return -a.v; }
+
+inline SimdMask operator<(SimdDouble a, SimdDouble b) { return a.v < b.v; }
+inline SimdMask operator>(SimdDouble a, SimdDouble b) { return a.v > b.v; }
+inline SimdMask operator>=(SimdDouble a, SimdDouble b) { return a.v >= b.v; }
+inline SimdMask operator==(SimdDouble a, SimdDouble b) { return a.v == b.v; }
+
+inline SimdDouble select(SimdMask mask, SimdDouble a, SimdDouble b) { return mask ? a : b; }
+inline SimdDouble abs(SimdDouble a) { return std::abs(a.v); }
+inline SimdDouble sin(SimdDouble a) { return std::sin(a.v); }
+inline SimdDouble cos(SimdDouble a) { return std::cos(a.v); }
+
+#endif
+
+// Scalar counterparts of select() so physics templates can branch without `if`
+inline double select(bool mask, double a, double b) { return mask ? a : b; }
+inline float select(bool mask, float a, float b) { return mask ? a : b; }
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+
+/**
+ * Vectorized sine and cosine (Cephes polynomials, ~1 ulp on [-pi/4, pi/4])
+ *
+ * The argument is reduced by the nearest multiple of pi/2 using a three-part
+ * Cody-Waite split, which stays exact for the angle magnitudes a pendulum
+ * simulation produces. The quadrant then picks and signs the polynomial.
+ */
+inline void sinCos(SimdDouble x, SimdDouble& s, SimdDouble& c)
+{
+    const double TWO_OVER_PI = 0.63661977236758134308;
+    const double PIO2_1 = 1.57079625129699707031e+00;
+    const double PIO2_2 = 7.54978941586159635335e-08;
+    const double PIO2_3 = 5.39030285815811905290e-15;
+
+    SimdDouble q = roundNearest(x * SimdDouble(TWO_OVER_PI));
+    SimdDouble r = ((x - q * SimdDouble(PIO2_1)) - q * SimdDouble(PIO2_2)) - q * SimdDouble(PIO2_3);
+    SimdDouble z = r * r;
+
+    SimdDouble sinPoly = SimdDouble(1.58962301576546568060e-10);
+    sinPoly = sinPoly * z + SimdDouble(-2.50507477628578072866e-8);
+    sinPoly = sinPoly * z + SimdDouble(2.75573136213857245213e-6);
+    sinPoly = sinPoly * z + SimdDouble(-1.98412698295895385996e-4);
+    sinPoly = sinPoly * z + SimdDouble(8.33333333332211858878e-3);
+    sinPoly = sinPoly * z + SimdDouble(-1.66666666666666307295e-1);
+    SimdDouble sinR = r + r * z * sinPoly;
+
+    SimdDouble cosPoly = SimdDouble(-1.13585365213876817300e-11);
+    cosPoly = cosPoly * z + SimdDouble(2.08757008419747316778e-9);
+    cosPoly = cosPoly * z + SimdDouble(-2.75573141792967388112e-7);
+    cosPoly = cosPoly * z + SimdDouble(2.48015872888517045348e-5);
+    cosPoly = cosPoly * z + SimdDouble(-1.38888888888730564116e-3);
+    cosPoly = cosPoly * z + SimdDouble(4.16666666666665929218e-2);
+    SimdDouble cosR = SimdDouble(1.0) - SimdDouble(0.5) * z + z * z * cosPoly;
+
+    // Quadrant in {0, 1, 2, 3}
+    SimdDouble quadrant = q - SimdDouble(4.0) * floor(q * SimdDouble(0.25));
+    SimdMask odd = (quadrant == SimdDouble(1.0)) | (quadrant == SimdDouble(3.0));
+
+    s = select(odd, cosR, sinR);
+    c = select(odd, sinR, cosR);
+    s = select(quadrant >= SimdDouble(2.0), -s, s);
+    c = select((quadrant == SimdDouble(1.0)) | (quadrant == SimdDouble(2.0)), -c, c);
+}
+
+inline SimdDouble sin(SimdDouble x)
+{
+    SimdDouble s, c;
+    sinCos(x, s, c);
+    return s;
+}
+
+inline SimdDouble cos(SimdDouble x)
+{
+    SimdDouble s, c;
+    sinCos(x, s, c);
+    return c;
+}
+
+#endif
+
+}
+
+using PENDULUM_SIMD_NAMESPACE::SimdMask;
+using PENDULUM_SIMD_NAMESPACE::SimdDouble;
+using PENDULUM_SIMD_NAMESPACE::select;
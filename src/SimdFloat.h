@@ -0,0 +1,253 @@
+#pragma once
+
+#include "SimdDouble.h"
+#include <cmath>
+
+namespace PENDULUM_SIMD_NAMESPACE
+{
+
+/**
+ * SimdFloat - a pack of floats processed in lockstep
+ *
+ * Single-precision counterpart of SimdDouble with twice the lanes per
+ * register: 16 with AVX-512, 8 with AVX2, one (plain float) otherwise.
+ * Same free-function interface, so the physics templates and
+ * BatchODESolver accept it unchanged.
+ */
+#if defined(__AVX512F__)
+
+struct SimdFloatMask
+{
+    __mmask16 m;
+};
+
+struct SimdFloat
+{
+    using Scalar = float;
+    static constexpr int WIDTH = 16;
+    __m512 v;
+
+    SimdFloat() = default;
+    SimdFloat(float x) : v(_mm512_set1_ps(x)) {}
+    SimdFloat(__m512 x) : v(x) {}
+
+    static SimdFloat load(const float* p) { return _mm512_loadu_ps(p); }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+};
+
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return _mm512_add_ps(a.v, b.v); }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return _mm512_sub_ps(a.v, b.v); }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return _mm512_mul_ps(a.v, b.v); }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return _mm512_div_ps(a.v, b.v); }
+inline SimdFloat operator-(SimdFloat a)
+{
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v),
+        _mm512_set1_epi32(static_cast<int>(0x80000000U))));
+}
+
+inline SimdFloatMask operator<(SimdFloat a, SimdFloat b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ) }; }
+inline SimdFloatMask operator>(SimdFloat a, SimdFloat b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ) }; }
+inline SimdFloatMask operator>=(SimdFloat a, SimdFloat b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ) }; }
+inline SimdFloatMask operator==(SimdFloat a, SimdFloat b) { return { _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ) }; }
+inline SimdFloatMask operator|(SimdFloatMask a, SimdFloatMask b) { return { static_cast<__mmask16>(a.m | b.m) }; }
+
+// Lane-wise mask ? a : b
+inline SimdFloat select(SimdFloatMask mask, SimdFloat a, SimdFloat b) { return _mm512_mask_blend_ps(mask.m, b.v, a.v); }
+inline SimdFloat abs(SimdFloat a) { return _mm512_abs_ps(a.v); }
+inline SimdFloat roundNearest(SimdFloat a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline SimdFloat floor(SimdFloat a) { return _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+inline SimdFloat min(SimdFloat a, SimdFloat b) { return _mm512_min_ps(a.v, b.v); }
+inline SimdFloat max(SimdFloat a, SimdFloat b) { return _mm512_max_ps(a.v, b.v); }
+// a * b + c, fused
+inline SimdFloat mulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return _mm512_fmadd_ps(a.v, b.v, c.v); }
+
+#elif defined(__AVX2__)
+
+struct SimdFloatMask
+{
+    __m256 m;
+};
+
+struct SimdFloat
+{
+    using Scalar = float;
+    static constexpr int WIDTH = 8;
+    __m256 v;
+
+    SimdFloat() = default;
+    SimdFloat(float x) : v(_mm256_set1_ps(x)) {}
+    SimdFloat(__m256 x) : v(x) {}
+
+    static SimdFloat load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return _mm256_add_ps(a.v, b.v); }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return _mm256_sub_ps(a.v, b.v); }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return _mm256_mul_ps(a.v, b.v); }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return _mm256_div_ps(a.v, b.v); }
+inline SimdFloat operator-(SimdFloat a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+inline SimdFloatMask operator<(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+inline SimdFloatMask operator>(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+inline SimdFloatMask operator>=(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+inline SimdFloatMask operator==(SimdFloat a, SimdFloat b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+inline SimdFloatMask operator|(SimdFloatMask a, SimdFloatMask b) { return { _mm256_or_ps(a.m, b.m) }; }
+
+// Lane-wise mask ? a : b
+inline SimdFloat select(SimdFloatMask mask, SimdFloat a, SimdFloat b) { return _mm256_blendv_ps(b.v, a.v, mask.m); }
+inline SimdFloat abs(SimdFloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline SimdFloat roundNearest(SimdFloat a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline SimdFloat floor(SimdFloat a) { return _mm256_floor_ps(a.v); }
+inline SimdFloat min(SimdFloat a, SimdFloat b) { return _mm256_min_ps(a.v, b.v); }
+inline SimdFloat max(SimdFloat a, SimdFloat b) { return _mm256_max_ps(a.v, b.v); }
+// a * b + c, fused where the CPU has FMA
+#if defined(__FMA__)
+inline SimdFloat mulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return _mm256_fmadd_ps(a.v, b.v, c.v); }
+#else
+inline SimdFloat mulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v); }
+#endif
+
+#else
+
+using SimdFloatMask = bool;
+
+struct SimdFloat
+{
+    using Scalar = float;
+    static constexpr int WIDTH = 1;
+    float v;
+
+    SimdFloat() = default;
+    SimdFloat(float x) : v(x) {}
+
+    static SimdFloat load(const float* p) { return *p; }
+    void store(float* p) const { *p = v; }
+};
+
+inline SimdFloat operator+(SimdFloat a, SimdFloat b) { return a.v + b.v; }
+inline SimdFloat operator-(SimdFloat a, SimdFloat b) { return a.v - b.v; }
+inline SimdFloat operator*(SimdFloat a, SimdFloat b) { return a.v * b.v; }
+inline SimdFloat operator/(SimdFloat a, SimdFloat b) { return a.v / b.v; }
+inline SimdFloat operator-(SimdFloat a) { return -a.v; }
+
+inline SimdFloatMask operator<(SimdFloat a, SimdFloat b) { return a.v < b.v; }
+inline SimdFloatMask operator>(SimdFloat a, SimdFloat b) { return a.v > b.v; }
+inline SimdFloatMask operator>=(SimdFloat a, SimdFloat b) { return a.v >= b.v; }
+inline SimdFloatMask operator==(SimdFloat a, SimdFloat b) { return a.v == b.v; }
+
+inline SimdFloat select(SimdFloatMask mask, SimdFloat a, SimdFloat b) { return mask ? a : b; }
+inline SimdFloat abs(SimdFloat a) { return std::abs(a.v); }
+inline SimdFloat sin(SimdFloat a) { return std::sin(a.v); }
+inline SimdFloat cos(SimdFloat a) { return std::cos(a.v); }
+inline SimdFloat min(SimdFloat a, SimdFloat b) { return a.v < b.v ? a : b; }
+inline SimdFloat max(SimdFloat a, SimdFloat b) { return a.v > b.v ? a : b; }
+inline SimdFloat mulAdd(SimdFloat a, SimdFloat b, SimdFloat c) { return a.v * b.v + c.v; }
+
+#endif
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+
+/**
+ * Vectorized single-precision sine and cosine (Cephes sinf/cosf polynomials)
+ *
+ * Same structure as the double version: reduction by the nearest multiple
+ * of pi/2 with a three-part split of pi/2 in float, then the quadrant picks
+ * and signs the polynomial.
+ */
+inline void sinCos(SimdFloat x, SimdFloat& s, SimdFloat& c)
+{
+    const float TWO_OVER_PI = 0.636619772367581343f;
+    const float PIO2_1 = 1.5703125f;
+    const float PIO2_2 = 4.837512969970703125e-4f;
+    const float PIO2_3 = 7.54978995489188216e-8f;
+
+    SimdFloat q = roundNearest(x * SimdFloat(TWO_OVER_PI));
+    SimdFloat r = ((x - q * SimdFloat(PIO2_1)) - q * SimdFloat(PIO2_2)) - q * SimdFloat(PIO2_3);
+    SimdFloat z = r * r;
+
+    SimdFloat sinPoly = SimdFloat(-1.9515295891e-4f);
+    sinPoly = sinPoly * z + SimdFloat(8.3321608736e-3f);
+    sinPoly = sinPoly * z + SimdFloat(-1.6666654611e-1f);
+    SimdFloat sinR = r + r * z * sinPoly;
+
+    SimdFloat cosPoly = SimdFloat(2.443315711809948e-5f);
+    cosPoly = cosPoly * z + SimdFloat(-1.388731625493765e-3f);
+    cosPoly = cosPoly * z + SimdFloat(4.166664568298827e-2f);
+    SimdFloat cosR = SimdFloat(1.0f) - SimdFloat(0.5f) * z + z * z * cosPoly;
+
+    // Quadrant in {0, 1, 2, 3}
+    SimdFloat quadrant = q - SimdFloat(4.0f) * floor(q * SimdFloat(0.25f));
+    SimdFloatMask odd = (quadrant == SimdFloat(1.0f)) | (quadrant == SimdFloat(3.0f));
+
+    s = select(odd, cosR, sinR);
+    c = select(odd, sinR, cosR);
+    s = select(quadrant >= SimdFloat(2.0f), -s, s);
+    c = select((quadrant == SimdFloat(1.0f)) | (quadrant == SimdFloat(2.0f)), -c, c);
+}
+
+inline SimdFloat sin(SimdFloat x)
+{
+    SimdFloat s, c;
+    sinCos(x, s, c);
+    return s;
+}
+
+inline SimdFloat cos(SimdFloat x)
+{
+    SimdFloat s, c;
+    sinCos(x, s, c);
+    return c;
+}
+
+#endif
+
+/**
+ * Single-precision tanh as an odd rational function (the minimax [13/6]
+ * approximation Eigen uses), a few ulp over the clamped range where
+ * float tanh has not yet saturated to +-1. Shared by every SimdFloat
+ * width, so batched and single evaluations of a network agree.
+ */
+inline SimdFloat tanh(SimdFloat x)
+{
+    const float CLAMP = 7.90531110763549805f;
+    x = min(max(x, SimdFloat(-CLAMP)), SimdFloat(CLAMP));
+    SimdFloat x2 = x * x;
+
+    SimdFloat p = SimdFloat(-2.76076847742355e-16f);
+    p = mulAdd(p, x2, SimdFloat(2.00018790482477e-13f));
+    p = mulAdd(p, x2, SimdFloat(-8.60467152213735e-11f));
+    p = mulAdd(p, x2, SimdFloat(5.12229709037114e-08f));
+    p = mulAdd(p, x2, SimdFloat(1.48572235717979e-05f));
+    p = mulAdd(p, x2, SimdFloat(6.37261928875436e-04f));
+    p = mulAdd(p, x2, SimdFloat(4.89352455891786e-03f));
+    p = p * x;
+
+    SimdFloat q = SimdFloat(1.19825839466702e-06f);
+    q = mulAdd(q, x2, SimdFloat(1.18534705686654e-04f));
+    q = mulAdd(q, x2, SimdFloat(2.26843463243900e-03f));
+    q = mulAdd(q, x2, SimdFloat(4.89352518554385e-03f));
+    return p / q;
+}
+
+// SIMD pack type for a scalar type (used by the batched integrator)
+template <typename Scalar>
+struct SimdPack;
+
+template <>
+struct SimdPack<double>
+{
+    using type = SimdDouble;
+};
+
+template <>
+struct SimdPack<float>
+{
+    using type = SimdFloat;
+};
+
+}
+
+using PENDULUM_SIMD_NAMESPACE::SimdFloatMask;
+using PENDULUM_SIMD_NAMESPACE::SimdFloat;
+using PENDULUM_SIMD_NAMESPACE::SimdPack;
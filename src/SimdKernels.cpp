@@ -0,0 +1,164 @@
+#include "SimdKernels.h"
+#include "BatchODESolver.h"
+#include "MlpPolicy.h"
+#include "PendulumDynamics.h"
+#include <utility>
+
+// Compiled once per instruction set (CMakeLists.txt): as part of
+// pendulum_core with the project flags, and on x86 again with AVX2 and
+// AVX-512 enabled and PENDULUM_SIMD_NAMESPACE set to keep the copies apart.
+namespace PENDULUM_SIMD_NAMESPACE
+{
+namespace
+{
+#if defined(__AVX512F__)
+    const char* const ISA_NAME = "avx512";
+#elif defined(__AVX2__)
+    const char* const ISA_NAME = "avx2";
+#else
+    const char* const ISA_NAME = "scalar";
+#endif
+
+    template <typename Scalar>
+    void stepCarts(double dt, Scalar* state, std::size_t stride,
+        const Scalar* applied, Scalar friction)
+    {
+        using Pack = typename SimdPack<Scalar>::type;
+
+        // Same cart model as Cart::update: applied acceleration minus viscous friction
+        auto derivFunc = [applied, friction](double t, const Pack (&s)[2], Pack (&ds)[2], std::size_t lane) {
+            ds[0] = s[1];
+            ds[1] = PendulumDynamics::cartAcceleration<Pack>(s[1], Pack::load(applied + lane), friction);
+            };
+
+        BatchODESolver<2, Pack> solver;
+        solver.stepFixed(0.0, state, stride, derivFunc, dt);
+    }
+
+    template <typename Scalar>
+    void stepPendulums(double dt, Scalar* state, std::size_t stride, int numLinks,
+        const BatchPendulumRows<Scalar>& rows)
+    {
+        using Pack = typename SimdPack<Scalar>::type;
+
+        const Scalar* cartAccel = rows.cartAcceleration;
+        const Scalar* g = rows.gravity;
+        const Scalar* damping = rows.damping;
+
+        if (numLinks == 1) {
+            const Scalar* length = rows.length1;
+
+            auto derivFunc = [=](double t, const Pack (&s)[2], Pack (&ds)[2], std::size_t lane) {
+                ds[0] = s[1];
+                ds[1] = PendulumDynamics::singleAngularAcceleration<Pack>(s[0], s[1],
+                    Pack::load(cartAccel + lane), Pack::load(g + lane), Pack::load(damping + lane),
+                    Pack::load(length + lane));
+                };
+
+            BatchODESolver<2, Pack> solver;
+            solver.stepFixed(0.0, state, stride, derivFunc, dt);
+        }
+        else {
+            const Scalar* m1 = rows.mass1;
+            const Scalar* m2 = rows.mass2;
+            const Scalar* L1 = rows.length1;
+            const Scalar* L2 = rows.length2;
+
+            auto derivFunc = [=](double t, const Pack (&s)[4], Pack (&ds)[4], std::size_t lane) {
+                Pack alpha1, alpha2;
+                PendulumDynamics::doubleAngularAccelerations<Pack>(s[0], s[2], s[1], s[3],
+                    Pack::load(cartAccel + lane), Pack::load(g + lane), Pack::load(damping + lane),
+                    Pack::load(m1 + lane), Pack::load(m2 + lane), Pack::load(L1 + lane), Pack::load(L2 + lane),
+                    alpha1, alpha2);
+                ds[0] = s[1];
+                ds[1] = alpha1;
+                ds[2] = s[3];
+                ds[3] = alpha2;
+                };
+
+            BatchODESolver<4, Pack> solver;
+            solver.stepFixed(0.0, state, stride, derivFunc, dt);
+        }
+    }
+
+    // MlpPolicy forward pass over one block, one observation per lane
+    void evaluatePolicyBlock(const int* sizes, std::size_t numSizes, const float* parameters,
+        const double* observations, int lanes, double* actions)
+    {
+        constexpr int WIDTH = SimdFloat::WIDTH;
+        SimdFloat bufferA[MlpPolicy::MAX_WIDTH];
+        SimdFloat bufferB[MlpPolicy::MAX_WIDTH];
+        SimdFloat* in = bufferA;
+        SimdFloat* out = bufferB;
+        alignas(64) float lane[WIDTH];
+
+        // Transpose: lane l of in[k] is input k of observation l
+        const int inputSize = sizes[0];
+        for (int k = 0; k < inputSize; ++k) {
+            for (int l = 0; l < WIDTH; ++l) {
+                lane[l] = l < lanes ? static_cast<float>(observations[l * inputSize + k]) : 0.0f;
+            }
+            in[k] = SimdFloat::load(lane);
+        }
+
+        for (std::size_t layer = 0; layer + 1 < numSizes; ++layer) {
+            const int n = sizes[layer];
+            const int m = sizes[layer + 1];
+            const float* weights = parameters;
+            const float* bias = parameters + static_cast<std::size_t>(m) * n;
+
+            // Four rows at a time: independent accumulators hide the FMA latency
+            int j = 0;
+            for (; j + 4 <= m; j += 4) {
+                const float* w0 = weights + static_cast<std::size_t>(j) * n;
+                const float* w1 = w0 + n;
+                const float* w2 = w1 + n;
+                const float* w3 = w2 + n;
+                SimdFloat acc0(bias[j]), acc1(bias[j + 1]), acc2(bias[j + 2]), acc3(bias[j + 3]);
+                for (int k = 0; k < n; ++k) {
+                    SimdFloat x = in[k];
+                    acc0 = mulAdd(SimdFloat(w0[k]), x, acc0);
+                    acc1 = mulAdd(SimdFloat(w1[k]), x, acc1);
+                    acc2 = mulAdd(SimdFloat(w2[k]), x, acc2);
+                    acc3 = mulAdd(SimdFloat(w3[k]), x, acc3);
+                }
+                out[j] = tanh(acc0);
+                out[j + 1] = tanh(acc1);
+                out[j + 2] = tanh(acc2);
+                out[j + 3] = tanh(acc3);
+            }
+            for (; j < m; ++j) {
+                const float* w = weights + static_cast<std::size_t>(j) * n;
+                SimdFloat acc(bias[j]);
+                for (int k = 0; k < n; ++k) {
+                    acc = mulAdd(SimdFloat(w[k]), in[k], acc);
+                }
+                out[j] = tanh(acc);
+            }
+
+            parameters = bias + m;
+            std::swap(in, out);
+        }
+
+        const int outputSize = sizes[numSizes - 1];
+        for (int j = 0; j < outputSize; ++j) {
+            in[j].store(lane);
+            for (int l = 0; l < lanes; ++l) {
+                actions[l * outputSize + j] = static_cast<double>(lane[l]);
+            }
+        }
+    }
+
+    const SimdKernels KERNELS = {
+        ISA_NAME,
+        { SimdDouble::WIDTH, &stepCarts<double>, &stepPendulums<double> },
+        { SimdFloat::WIDTH, &stepCarts<float>, &stepPendulums<float> },
+        { SimdFloat::WIDTH, &evaluatePolicyBlock },
+    };
+}
+
+const SimdKernels& getKernels()
+{
+    return KERNELS;
+}
+}
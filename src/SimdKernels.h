@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * SimdKernels - the structure-of-arrays loops behind the batched classes
+ * (BasicBatchCartPendulum, MlpPolicy)
+ *
+ * SimdKernels.cpp is compiled once per instruction set (see SimdDispatch.h),
+ * each copy in its own namespace, and every copy fills one of these tables.
+ * The kernels take raw pointers only, so no inline code outside the SIMD
+ * namespace is instantiated with the wider -m flags.
+ *
+ * Row arguments hold `stride` values, with stride a multiple of the table's
+ * lane width; SIMD_MAX_BYTES rounds it for every table at once.
+ */
+
+// Widest register of any kernel copy (AVX-512); strides rounded to it fit all
+constexpr std::size_t SIMD_MAX_BYTES = 64;
+
+// Inputs of one pendulum step, one row per quantity (see BatchParameter)
+template <typename Scalar>
+struct BatchPendulumRows
+{
+    const Scalar* cartAcceleration;
+    const Scalar* gravity;
+    const Scalar* damping;
+    const Scalar* mass1;
+    const Scalar* mass2;
+    const Scalar* length1;
+    const Scalar* length2;
+};
+
+template <typename Scalar>
+struct BatchKernels
+{
+    int width;      // environments per register
+
+    // One Dormand-Prince step of every cart, state = [position | velocity]
+    void (*stepCarts)(double dt, Scalar* state, std::size_t stride,
+        const Scalar* appliedAcceleration, Scalar friction);
+
+    // One Dormand-Prince step of every pendulum,
+    // state = [angle1 | angVel1 (| angle2 | angVel2)]
+    void (*stepPendulums)(double dt, Scalar* state, std::size_t stride, int numLinks,
+        const BatchPendulumRows<Scalar>& rows);
+};
+
+struct PolicyKernels
+{
+    int width;      // observations per block
+
+    // Forward pass of one block of lanes <= width observations; sizes and
+    // parameters as in MlpPolicy
+    void (*evaluateBlock)(const int* sizes, std::size_t numSizes, const float* parameters,
+        const double* observations, int lanes, double* actions);
+};
+
+struct SimdKernels
+{
+    const char* isa;    // instruction set the copy was compiled for
+
+    BatchKernels<double> batchDouble;
+    BatchKernels<float> batchFloat;
+    PolicyKernels policy;
+};
@@ -1,5 +1,7 @@
 ﻿#include "SinglePendulum.h"
-#include "ODESolver.h"
+#include "Dual.h"
+#include "Integrators.h"
+#include "PendulumDynamics.h"
 #include <cmath>
 
 SinglePendulum::SinglePendulum(double mass, double length)
@@ -13,22 +15,19 @@ SinglePendulum::SinglePendulum(double mass, double length)
 
 void SinglePendulum::update(double dt, double cartAcceleration)
 {
-    // Use Dormand-Prince RK8 solver for high accuracy
-    static ODESolver solver;
+    // Integrate with the selected integrator (Dormand-Prince RK8 by default)
+    using Solver = IntegratorSet<2>;
 
     // State vector: [angle, angular_velocity]
-    std::vector<double> state = { m_angle, m_angularVelocity };
+    Solver::State state = { m_angle, m_angularVelocity };
 
     // Derivative function
-    auto derivFunc = [this, cartAcceleration](double t, const std::vector<double>& s) -> std::vector<double> {
-        double angle = s[0];
-        double angVel = s[1];
-        double angAccel = this->computeAngularAcceleration(angle, angVel, cartAcceleration);
-        return { angVel, angAccel };
+    auto derivFunc = [this, cartAcceleration](double t, const Solver::State& s, Solver::State& ds) {
+        this->computeDerivative(s, cartAcceleration, ds);
         };
 
     // Take one step with fixed dt for consistent frame timing
-    solver.stepFixed(0.0, state, derivFunc, dt);
+    m_solver.stepFixed(m_integrator, 0.0, state, derivFunc, dt);
 
     // Update state
     m_angle = state[0];
@@ -66,29 +65,44 @@ double SinglePendulum::getAngularVelocity(int index) const
     return (index == 0) ? m_angularVelocity : 0.0;
 }
 
-double SinglePendulum::computeAngularAcceleration(double angle, double angularVel, double cartAccel)
+template <typename Scalar>
+void SinglePendulum::computeDerivative(const std::array<Scalar, 2>& s, Scalar cartAccel, std::array<Scalar, 2>& ds) const
 {
-    // Equation of motion for inverted pendulum on cart:
-    // θ̈ = (g·sin(θ) - a·cos(θ)) / L
-    // where:
-    //   θ  = pendulum angle (0 = up)
-    //   g  = gravity
-    //   a  = cart acceleration
-    //   L  = pendulum length
-
-    // Use downward-zero convention (θ = 0 is hanging down). With this
-    // convention the gravity term is -g*sin(θ). Cart acceleration couples
-    // with -cos(θ). Include a simple viscous damping term proportional to angular velocity.
-    double numerator = -m_gravity * std::sin(angle) - cartAccel * std::cos(angle);
-    double angularAccel = (numerator - m_damping * angularVel) / m_length;
-
-    return angularAccel;
+    // Equation of motion for a pendulum on an accelerating cart (see
+    // PendulumDynamics.h; shared with the batched integrator).
+    ds[0] = s[1];
+    ds[1] = PendulumDynamics::singleAngularAcceleration<Scalar>(s[0], s[1], cartAccel,
+        m_gravity, m_damping, m_length);
+}
+
+void SinglePendulum::computeStepJacobian(double dt, double cartAcceleration,
+    std::array<double, 2>& next, StepJacobian& jacobian) const
+{
+    // Inputs [angle, angVel, cartAccel], each carrying its own tangent
+    using Scalar = Dual<3>;
+    using Solver = IntegratorSet<2, Scalar>;
+    Solver solver;
+
+    auto step = [&](const std::array<Scalar, 3>& in, std::array<Scalar, 2>& out) {
+        Solver::State state = { in[0], in[1] };
+        Scalar cartAccel = in[2];
+        auto derivFunc = [this, &cartAccel](double t, const Solver::State& s, Solver::State& ds) {
+            this->computeDerivative(s, cartAccel, ds);
+            };
+        solver.stepFixed(m_integrator, 0.0, state, derivFunc, dt);
+        out = state;
+        };
+
+    computeJacobian<3, 2>(step, { m_angle, m_angularVelocity, cartAcceleration }, next, jacobian);
 }
 
 double SinglePendulum::normalizeAngle(double angle)
 {
     // Wrap angle to [-pi, pi]
     const double PI = 3.14159265358979323846;
+    // A diverged state (e.g. a too-coarse integrator) must not spin the loops below
+    if (!std::isfinite(angle)) return angle;
+    if (std::abs(angle) > 64.0 * PI) angle = std::remainder(angle, 2.0 * PI);
     while (angle > PI) angle -= 2.0 * PI;
     while (angle < -PI) angle += 2.0 * PI;
     return angle;
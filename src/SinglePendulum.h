@@ -18,8 +18,34 @@ public:
     double getAngularVelocity(int index) const override;
     double getMass() const { return m_mass; }
     double getLength() const { return m_length; }
+    double getLinkMass(int index) const override { return m_mass; }
+    double getLinkLength(int index) const override { return m_length; }
+    void setLinkState(int index, double angle, double angularVelocity) override {
+        m_angle = angle;
+        m_angularVelocity = angularVelocity;
+    }
+    void getState(double* state) const override {
+        state[0] = m_angle;
+        state[1] = m_angularVelocity;
+    }
+    void setState(const double* state) override {
+        m_angle = state[0];
+        m_angularVelocity = state[1];
+    }
     double getKineticEnergy(double cartVelocity) const;
     double getPotentialEnergy() const;
+
+    /**
+     * Linearization of one update() step around the current state
+     *
+     * next = f(angle, angularVelocity, cartAcceleration) through the selected
+     * integrator, before angle wrapping and rest snapping. jacobian is the
+     * exact 2 x 3 matrix d next / d (angle, angularVelocity, cartAcceleration),
+     * obtained by running the same step on dual numbers.
+     */
+    using StepJacobian = std::array<std::array<double, 3>, 2>;
+    void computeStepJacobian(double dt, double cartAcceleration,
+        std::array<double, 2>& next, StepJacobian& jacobian) const;
     
     void setAngle(double angle) { m_angle = angle; }
     void setAngularVelocity(double vel) { m_angularVelocity = vel; }
@@ -34,7 +60,12 @@ private:
     double m_initialAngle;
     double m_angle;
     double m_angularVelocity;
+
+    // Integrator workspace (per instance)
+    IntegratorSet<2> m_solver;
     
-    double computeAngularAcceleration(double angle, double angularVel, double cartAccel);
+    // [angle, angVel] -> [angVel, angAccel]; Scalar = double or Dual<M>
+    template <typename Scalar>
+    void computeDerivative(const std::array<Scalar, 2>& s, Scalar cartAccel, std::array<Scalar, 2>& ds) const;
     double normalizeAngle(double angle);
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * SnapshotArena - preallocated storage for fixed-size state snapshots
+ *
+ * capacity slots of slotBytes each in one contiguous block. Slots start on
+ * 64-byte boundaries, so threads saving neighbouring slots do not share
+ * cache lines. The arena only holds bytes; PendulumEnv and VecEnv save and
+ * restore snapshots into its slots. Nothing is allocated after allocate().
+ */
+class SnapshotArena
+{
+public:
+    SnapshotArena() = default;
+    SnapshotArena(std::size_t capacity, std::size_t slotBytes) { allocate(capacity, slotBytes); }
+
+    void allocate(std::size_t capacity, std::size_t slotBytes)
+    {
+        m_capacity = capacity;
+        m_stride = (slotBytes + sizeof(CacheLine) - 1) / sizeof(CacheLine) * sizeof(CacheLine);
+        m_lines.assign(capacity * m_stride / sizeof(CacheLine), CacheLine());
+    }
+
+    void* getSlot(std::size_t index) { return reinterpret_cast<unsigned char*>(m_lines.data()) + index * m_stride; }
+    const void* getSlot(std::size_t index) const
+    {
+        return reinterpret_cast<const unsigned char*>(m_lines.data()) + index * m_stride;
+    }
+
+    std::size_t getCapacity() const { return m_capacity; }
+    std::size_t getSlotBytes() const { return m_stride; }
+
+private:
+    struct alignas(64) CacheLine
+    {
+        unsigned char bytes[64];
+    };
+
+    std::vector<CacheLine> m_lines;
+    std::size_t m_capacity = 0;
+    std::size_t m_stride = 0;
+};
@@ -0,0 +1,205 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::uint64_t packRange(std::uint32_t begin, std::uint32_t end)
+    {
+        return static_cast<std::uint64_t>(end) << 32 | begin;
+    }
+
+    std::uint32_t rangeBegin(std::uint64_t range) { return static_cast<std::uint32_t>(range); }
+    std::uint32_t rangeEnd(std::uint64_t range) { return static_cast<std::uint32_t>(range >> 32); }
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+ThreadPool::ThreadPool(int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    m_slots = std::vector<WorkerSlot>(numThreads);
+    m_workers.reserve(numThreads - 1);
+    for (int thread = 1; thread < numThreads; ++thread) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+ThreadPool::WorkerStats ThreadPool::getWorkerStats(int thread) const
+{
+    return m_slots[thread].stats;
+}
+
+void ThreadPool::resetStats()
+{
+    for (WorkerSlot& slot : m_slots) {
+        slot.stats = WorkerStats();
+    }
+    m_parallelSeconds = 0.0;
+}
+
+void ThreadPool::run(Task task, const void* context, std::size_t count, std::size_t grain)
+{
+    Clock::time_point start = Clock::now();
+
+    if (m_workers.empty() || count <= 1) {
+        task(context, 0, count);
+        WorkerStats& stats = m_slots[0].stats;
+        stats.chunks += count > 0 ? 1 : 0;
+        stats.busySeconds += secondsSince(start);
+        m_parallelSeconds += secondsSince(start);
+        return;
+    }
+
+    const int threads = getNumThreads();
+    if (grain > 0) {
+        // Seed every thread with a contiguous share of the chunks
+        std::size_t chunks = (count + grain - 1) / grain;
+        for (int thread = 0; thread < threads; ++thread) {
+            auto begin = static_cast<std::uint32_t>(chunks * thread / threads);
+            auto end = static_cast<std::uint32_t>(chunks * (thread + 1) / threads);
+            m_slots[thread].range.store(packRange(begin, end), std::memory_order_relaxed);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = task;
+        m_context = context;
+        m_count = count;
+        m_grain = grain;
+        m_pending = static_cast<int>(m_workers.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runShare(task, context, count, grain, 0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pending == 0; });
+    m_parallelSeconds += secondsSince(start);
+}
+
+void ThreadPool::workerLoop(int thread)
+{
+    std::uint64_t seenGeneration = 0;
+    for (;;) {
+        Task task;
+        const void* context;
+        std::size_t count;
+        std::size_t grain;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) return;
+            seenGeneration = m_generation;
+            task = m_task;
+            context = m_context;
+            count = m_count;
+            grain = m_grain;
+        }
+
+        runShare(task, context, count, grain, thread);
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            last = (--m_pending == 0);
+        }
+        if (last) m_done.notify_one();
+    }
+}
+
+void ThreadPool::runShare(Task task, const void* context, std::size_t count, std::size_t grain, int thread)
+{
+    WorkerSlot& slot = m_slots[thread];
+
+    if (grain == 0) {
+        // Static partition: one contiguous block per thread
+        const std::size_t threads = m_slots.size();
+        std::size_t begin = count * thread / threads;
+        std::size_t end = count * (thread + 1) / threads;
+        if (begin < end) {
+            Clock::time_point start = Clock::now();
+            task(context, begin, end);
+            slot.stats.busySeconds += secondsSince(start);
+            ++slot.stats.chunks;
+        }
+        return;
+    }
+
+    for (;;) {
+        std::uint32_t chunk;
+        if (popChunk(slot, chunk)) {
+            std::size_t begin = static_cast<std::size_t>(chunk) * grain;
+            std::size_t end = std::min(count, begin + grain);
+            Clock::time_point start = Clock::now();
+            task(context, begin, end);
+            slot.stats.busySeconds += secondsSince(start);
+            ++slot.stats.chunks;
+        }
+        else if (!stealChunks(thread)) {
+            // Every range is empty: the remaining chunks are already running
+            ++slot.stats.failedSteals;
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popChunk(WorkerSlot& slot, std::uint32_t& chunk)
+{
+    std::uint64_t range = slot.range.load(std::memory_order_acquire);
+    for (;;) {
+        std::uint32_t begin = rangeBegin(range);
+        std::uint32_t end = rangeEnd(range);
+        if (begin >= end) return false;
+        if (slot.range.compare_exchange_weak(range, packRange(begin + 1, end),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunk = begin;
+            return true;
+        }
+    }
+}
+
+bool ThreadPool::stealChunks(int thread)
+{
+    // Chunk indices are handed out at most once per loop, so a range word
+    // never returns to an earlier value and the CAS cannot suffer ABA.
+    const int threads = getNumThreads();
+    for (int offset = 1; offset < threads; ++offset) {
+        WorkerSlot& victim = m_slots[(thread + offset) % threads];
+        std::uint64_t range = victim.range.load(std::memory_order_acquire);
+        for (;;) {
+            std::uint32_t begin = rangeBegin(range);
+            std::uint32_t end = rangeEnd(range);
+            if (begin >= end) break;
+            std::uint32_t split = end - (end - begin + 1) / 2;
+            if (victim.range.compare_exchange_weak(range, packRange(begin, split),
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+                m_slots[thread].range.store(packRange(split, end), std::memory_order_release);
+                ++m_slots[thread].stats.steals;
+                return true;
+            }
+        }
+    }
+    return false;
+}
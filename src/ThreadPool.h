@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool - fixed set of worker threads for data-parallel loops
+ *
+ * parallelFor(count, function) splits [0, count) into one contiguous chunk
+ * per thread and calls function(begin, end) on each; the calling thread
+ * takes the first chunk and the call returns when every chunk is done.
+ *
+ * parallelForDynamic(count, grain, function) is the work-stealing variant
+ * for uneven work: [0, count) is cut into chunks of `grain` items and each
+ * thread starts with a contiguous range of chunks, which it consumes from
+ * the front. A thread that runs out steals the back half of another
+ * thread's remaining range (one CAS on a packed [begin, end) word), so
+ * chunks that finish early - environments that are done, episodes that
+ * reset - free their thread to help the others.
+ *
+ * Functions are passed by reference through a plain function pointer, so
+ * dispatch performs no heap allocation. Calls must not overlap (one
+ * parallel loop at a time per pool).
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Per-thread counters, accumulated over parallel loops until
+     * resetStats(). Thread 0 is the calling thread.
+     */
+    struct WorkerStats
+    {
+        std::uint64_t chunks = 0;           // chunks executed
+        std::uint64_t steals = 0;           // successful steals
+        std::uint64_t failedSteals = 0;     // scans that found nothing left to take
+        double busySeconds = 0.0;           // time spent inside the loop body
+    };
+
+    // numThreads counts the calling thread; 0 = std::thread::hardware_concurrency()
+    explicit ThreadPool(int numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getNumThreads() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    template <typename Function>
+    void parallelFor(std::size_t count, const Function& function)
+    {
+        run(&invoke<Function>, &function, count, 0);
+    }
+
+    template <typename Function>
+    void parallelForDynamic(std::size_t count, std::size_t grain, const Function& function)
+    {
+        run(&invoke<Function>, &function, count, grain > 0 ? grain : 1);
+    }
+
+    // Utilization = busySeconds / getParallelSeconds() per thread
+    WorkerStats getWorkerStats(int thread) const;
+    double getParallelSeconds() const { return m_parallelSeconds; }
+    void resetStats();
+
+private:
+    using Task = void (*)(const void* context, std::size_t begin, std::size_t end);
+
+    template <typename Function>
+    static void invoke(const void* context, std::size_t begin, std::size_t end)
+    {
+        (*static_cast<const Function*>(context))(begin, end);
+    }
+
+    // One per thread, on its own cache line: the stealable chunk range
+    // (begin in the low 32 bits, end in the high 32 bits) and the counters
+    struct alignas(64) WorkerSlot
+    {
+        std::atomic<std::uint64_t> range{ 0 };
+        WorkerStats stats;
+    };
+
+    std::vector<std::thread> m_workers;
+    std::vector<WorkerSlot> m_slots;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    // Current job, published under m_mutex (grain 0 = static partition)
+    Task m_task = nullptr;
+    const void* m_context = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_grain = 0;
+    std::uint64_t m_generation = 0;
+    int m_pending = 0;
+    bool m_stop = false;
+    double m_parallelSeconds = 0.0;
+
+    void run(Task task, const void* context, std::size_t count, std::size_t grain);
+    void workerLoop(int thread);
+    void runShare(Task task, const void* context, std::size_t count, std::size_t grain, int thread);
+    bool popChunk(WorkerSlot& slot, std::uint32_t& chunk);
+    bool stealChunks(int thread);
+};
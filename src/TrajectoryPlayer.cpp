@@ -0,0 +1,94 @@
+#include "TrajectoryPlayer.h"
+#include <algorithm>
+#include <iostream>
+
+TrajectoryPlayer::TrajectoryPlayer()
+    : m_cart(1.0, 10.0)
+    , m_single(1.0, 1.0)
+    , m_double(1.0, 1.0, 1.0, 1.0)
+{
+}
+
+bool TrajectoryPlayer::open(const std::string& path)
+{
+    close();
+    if (!m_reader.open(path)) return false;
+    if (m_reader.getNumAngles() > 2) {
+        std::cerr << "ERROR: The viewer replays 1- and 2-link trajectories; " << path << " has "
+            << m_reader.getNumAngles() << " links" << std::endl;
+        m_reader.close();
+        return false;
+    }
+
+    // Start on the first stream with samples
+    m_source = 0;
+    while (m_reader.getSampleCount(m_source) == 0) ++m_source;
+    m_time = 0.0;
+    m_playing = true;
+    seek(0.0);
+    return true;
+}
+
+void TrajectoryPlayer::update(double elapsed)
+{
+    if (!isOpen()) return;
+    if (m_playing) {
+        m_time += elapsed * m_speed;
+        if (m_time <= 0.0 || m_time >= getDuration()) m_playing = false;
+    }
+    seek(m_time);
+}
+
+void TrajectoryPlayer::seek(double time)
+{
+    if (!isOpen()) return;
+    m_time = std::clamp(time, 0.0, getDuration());
+    m_sample = m_reader.findSample(m_source, m_time);
+    pose(m_reader.getSample(m_source, m_sample));
+}
+
+void TrajectoryPlayer::stepSamples(std::int64_t count)
+{
+    if (!isOpen()) return;
+    m_playing = false;
+    const std::int64_t last = static_cast<std::int64_t>(getSampleCount()) - 1;
+    m_sample = static_cast<std::uint64_t>(std::clamp<std::int64_t>(static_cast<std::int64_t>(m_sample) + count, 0, last));
+    pose(m_reader.getSample(m_source, m_sample, &m_time));
+}
+
+void TrajectoryPlayer::setPlaying(bool playing)
+{
+    if (playing && isOpen()) {
+        if (m_speed > 0.0 && m_time >= getDuration()) m_time = 0.0;
+        if (m_speed < 0.0 && m_time <= 0.0) m_time = getDuration();
+    }
+    m_playing = playing;
+}
+
+void TrajectoryPlayer::setSource(int source)
+{
+    if (!isOpen() || source < 0 || source >= m_reader.getSourceCount()
+        || m_reader.getSampleCount(source) == 0) {
+        return;
+    }
+    m_source = source;
+    seek(m_time);
+}
+
+const Pendulum& TrajectoryPlayer::getPendulum() const
+{
+    if (getNumAngles() == 2) return m_double;
+    return m_single;
+}
+
+void TrajectoryPlayer::pose(const double* record)
+{
+    m_record = record;
+    if (!record) return;
+    m_cart.setPosition(record[CART_POSITION_COLUMN]);
+    m_cart.setVelocity(record[CART_VELOCITY_COLUMN]);
+    Pendulum& pendulum = getNumAngles() == 2 ? static_cast<Pendulum&>(m_double) : static_cast<Pendulum&>(m_single);
+    for (int link = 0; link < getNumAngles(); ++link) {
+        pendulum.setLinkState(link, record[FIRST_LINK_COLUMN + 2 * link], record[FIRST_LINK_COLUMN + 2 * link + 1]);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Cart.h"
+#include "DoublePendulum.h"
+#include "SinglePendulum.h"
+#include "TrajectoryReader.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * TrajectoryPlayer - plays a recorded trajectory back onto a cart and pendulum
+ *
+ * Owns a TrajectoryReader and a playback clock on the playback-time axis of
+ * one source stream. update() advances the clock by the elapsed time
+ * scaled by the speed (negative plays backwards) and poses its own Cart
+ * and Single / DoublePendulum from the sample at that time, so the
+ * renderer can draw them in place of the live simulation. seek() and
+ * stepSamples() jump anywhere without replaying what lies between.
+ * Playback pauses at either end of the stream.
+ *
+ * Only the state columns are applied: masses and lengths are the viewer
+ * defaults, and recordings of three or more links are rejected because
+ * Renderer draws one or two.
+ */
+class TrajectoryPlayer
+{
+public:
+    TrajectoryPlayer();
+
+    bool open(const std::string& path);
+    void close() { m_reader.close(); m_record = nullptr; }
+    bool isOpen() const { return m_reader.isOpen(); }
+
+    // Advance the clock by elapsed * speed (when playing) and pose the state
+    void update(double elapsed);
+    // Jump to a playback time, or by count samples (pauses)
+    void seek(double time);
+    void stepSamples(std::int64_t count);
+
+    // Playing from the end in the direction of travel starts over
+    void setPlaying(bool playing);
+    bool isPlaying() const { return m_playing; }
+    void setSpeed(double speed) { m_speed = speed; }
+    double getSpeed() const { return m_speed; }
+    // Select the stream of one source (environment); keeps the playback time
+    void setSource(int source);
+    int getSource() const { return m_source; }
+
+    double getTime() const { return m_time; }
+    double getDuration() const { return m_reader.getDuration(m_source); }
+    std::uint64_t getSample() const { return m_sample; }
+    std::uint64_t getSampleCount() const { return m_reader.getSampleCount(m_source); }
+
+    // Current record (TrajectoryColumn layout)
+    const double* getRecord() const { return m_record; }
+    const TrajectoryReader& getReader() const { return m_reader; }
+    const Cart& getCart() const { return m_cart; }
+    const Pendulum& getPendulum() const;
+    int getNumAngles() const { return m_reader.getNumAngles(); }
+
+private:
+    TrajectoryReader m_reader;
+    Cart m_cart;
+    SinglePendulum m_single;
+    DoublePendulum m_double;
+
+    int m_source = 0;
+    double m_time = 0.0;            // playback time
+    double m_speed = 1.0;
+    bool m_playing = true;
+    std::uint64_t m_sample = 0;
+    const double* m_record = nullptr;
+
+    void pose(const double* record);
+};
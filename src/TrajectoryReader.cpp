@@ -0,0 +1,238 @@
+#include "TrajectoryReader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Guards against a corrupt source column allocating huge stream tables
+    constexpr double MAX_SOURCES = 1 << 20;
+}
+
+TrajectoryReader::~TrajectoryReader()
+{
+    close();
+}
+
+bool TrajectoryReader::open(const std::string& path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size = {};
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &size)) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        std::cerr << "ERROR: Failed to open trajectory file: " << path << std::endl;
+        return false;
+    }
+    m_file = reinterpret_cast<std::intptr_t>(file);
+    const std::size_t fileBytes = static_cast<std::size_t>(size.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0) {
+        if (file >= 0) ::close(file);
+        std::cerr << "ERROR: Failed to open trajectory file: " << path << std::endl;
+        return false;
+    }
+    m_file = file;
+    const std::size_t fileBytes = static_cast<std::size_t>(status.st_size);
+#endif
+    m_path = path;
+
+    if (fileBytes < sizeof(TrajectoryFileHeader)) {
+        std::cerr << "ERROR: Not a trajectory file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+#if defined(_WIN32)
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        std::cerr << "ERROR: Failed to map trajectory file: " << path << std::endl;
+        close();
+        return false;
+    }
+    m_mapping = reinterpret_cast<std::intptr_t>(mapping);
+#else
+    void* data = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, file, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map trajectory file: " << path << std::endl;
+        close();
+        return false;
+    }
+#endif
+    m_data = static_cast<const char*>(data);
+    m_mappedBytes = fileBytes;
+    m_records = reinterpret_cast<const double*>(m_data + sizeof(TrajectoryFileHeader));
+
+    std::memcpy(&m_header, m_data, sizeof(TrajectoryFileHeader));
+    if (std::memcmp(m_header.magic, "PTRJ", 4) != 0 || m_header.version != TrajectoryRecorder::FORMAT_VERSION
+        || m_header.numAngles < 1 || m_header.numAngles > 1024
+        || m_header.recordDoubles != static_cast<std::uint32_t>(TrajectoryRecorder::getRecordDoubles(getNumAngles()))) {
+        std::cerr << "ERROR: Not a version " << TrajectoryRecorder::FORMAT_VERSION
+            << " trajectory file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // A file still being written may hold more records than the header
+    // has committed, a truncated one fewer
+    const std::uint64_t storedRecords = (fileBytes - sizeof(TrajectoryFileHeader))
+        / (m_header.recordDoubles * sizeof(double));
+    m_recordCount = std::min<std::uint64_t>(m_header.recordCount, storedRecords);
+    if (m_recordCount == 0) {
+        std::cerr << "ERROR: Trajectory file holds no records: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    if (!buildIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TrajectoryReader::close()
+{
+    if (m_data) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+        CloseHandle(reinterpret_cast<HANDLE>(m_mapping));
+        m_mapping = 0;
+#else
+        munmap(const_cast<char*>(m_data), m_mappedBytes);
+#endif
+    }
+    if (m_file != -1) {
+#if defined(_WIN32)
+        CloseHandle(reinterpret_cast<HANDLE>(m_file));
+#else
+        ::close(static_cast<int>(m_file));
+#endif
+    }
+    m_file = -1;
+    m_data = nullptr;
+    m_records = nullptr;
+    m_mappedBytes = 0;
+    m_recordCount = 0;
+    m_streams.clear();
+}
+
+bool TrajectoryReader::buildIndex()
+{
+#if !defined(_WIN32)
+    madvise(const_cast<char*>(m_data), m_mappedBytes, MADV_SEQUENTIAL);
+#endif
+    for (std::uint64_t record = 0; record < m_recordCount; ++record) {
+        const double* values = getRecord(record);
+        const double source = values[SOURCE_COLUMN];
+        if (!(source >= 0.0 && source < MAX_SOURCES) || source != std::floor(source)) {
+            std::cerr << "ERROR: Trajectory record " << record << " has an invalid source: " << m_path << std::endl;
+            return false;
+        }
+        const std::size_t streamIndex = static_cast<std::size_t>(source);
+        if (streamIndex >= m_streams.size()) m_streams.resize(streamIndex + 1);
+
+        Stream& stream = m_streams[streamIndex];
+        const double time = values[TIME_COLUMN];
+        double playbackTime = stream.sampleCount == 0 ? 0.0 : advance(stream.duration, stream.lastTime, time);
+        if (stream.sampleCount % INDEX_STRIDE == 0) {
+            stream.index.push_back({ record, playbackTime });
+        }
+        stream.duration = playbackTime;
+        stream.lastTime = time;
+        ++stream.sampleCount;
+    }
+#if !defined(_WIN32)
+    madvise(const_cast<char*>(m_data), m_mappedBytes, MADV_RANDOM);
+#endif
+
+    m_activeSources = 0;
+    for (const Stream& stream : m_streams) {
+        m_activeSources += stream.sampleCount > 0;
+    }
+    return true;
+}
+
+double TrajectoryReader::advance(double playbackTime, double previousTime, double time) const
+{
+    double step = time - previousTime;
+    if (!(step > 0.0) || !std::isfinite(step)) step = m_header.dt;
+    return playbackTime + step;
+}
+
+std::uint64_t TrajectoryReader::nextRecord(int source, std::uint64_t record) const
+{
+    // A batch recorded every step repeats with a period of the source
+    // count, so the guess hits; otherwise scan
+    const std::uint64_t guess = record + m_activeSources;
+    if (guess < m_recordCount && getRecord(guess)[SOURCE_COLUMN] == source) {
+        return guess;
+    }
+    for (std::uint64_t next = record + 1; next < m_recordCount; ++next) {
+        if (getRecord(next)[SOURCE_COLUMN] == source) return next;
+    }
+    return record;
+}
+
+const double* TrajectoryReader::getSample(int source, std::uint64_t sample, double* playbackTime) const
+{
+    const Stream& stream = m_streams[source];
+    if (stream.sampleCount == 0) return nullptr;
+    sample = std::min(sample, stream.sampleCount - 1);
+    if (m_activeSources == 1 && !playbackTime) {
+        return getRecord(stream.index.front().record + sample);
+    }
+
+    const IndexEntry& entry = stream.index[sample / INDEX_STRIDE];
+    std::uint64_t record = entry.record;
+    double time = entry.playbackTime;
+    for (std::uint64_t k = sample % INDEX_STRIDE; k > 0; --k) {
+        std::uint64_t next = nextRecord(source, record);
+        time = advance(time, getRecord(record)[TIME_COLUMN], getRecord(next)[TIME_COLUMN]);
+        record = next;
+    }
+    if (playbackTime) *playbackTime = time;
+    return getRecord(record);
+}
+
+std::uint64_t TrajectoryReader::findSample(int source, double time) const
+{
+    const Stream& stream = m_streams[source];
+    if (stream.sampleCount == 0 || time <= 0.0) return 0;
+
+    // Last index entry at or before time, then walk its stride
+    auto after = std::upper_bound(stream.index.begin(), stream.index.end(), time,
+        [](double value, const IndexEntry& entry) { return value < entry.playbackTime; });
+    const std::size_t block = static_cast<std::size_t>(after - stream.index.begin()) - 1;
+    std::uint64_t sample = block * INDEX_STRIDE;
+    std::uint64_t record = stream.index[block].record;
+    double playbackTime = stream.index[block].playbackTime;
+    while (sample + 1 < stream.sampleCount) {
+        std::uint64_t next = nextRecord(source, record);
+        double nextTime = advance(playbackTime, getRecord(record)[TIME_COLUMN], getRecord(next)[TIME_COLUMN]);
+        if (nextTime > time) break;
+        record = next;
+        playbackTime = nextTime;
+        ++sample;
+    }
+    return sample;
+}
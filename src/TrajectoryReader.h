@@ -0,0 +1,94 @@
+#pragma once
+
+#include "TrajectoryRecorder.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * TrajectoryReader - random access to a TrajectoryRecorder file
+ *
+ * The file is mapped read-only and records are returned as pointers into
+ * the mapping, so opening a multi-gigabyte recording reads only what is
+ * looked at. Records of every source (environment) may be interleaved;
+ * each source is replayed as its own stream of samples.
+ *
+ * A sample's playback time runs continuously through a stream: it advances
+ * by the recorded time step and, where the recorded time jumps back (an
+ * episode or simulation reset), by the header's dt. open() makes one pass
+ * over the time and source columns and keeps every INDEX_STRIDE-th sample
+ * of each stream with its record index and playback time. findSample() is
+ * then a binary search over that sparse index plus a scan of at most one
+ * stride of records, and getSample() is direct indexing for single-source
+ * files.
+ */
+class TrajectoryReader
+{
+public:
+    static constexpr std::size_t INDEX_STRIDE = 1024;
+
+    TrajectoryReader() = default;
+    ~TrajectoryReader();
+
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    int getNumAngles() const { return static_cast<int>(m_header.numAngles); }
+    int getRecordDoubles() const { return static_cast<int>(m_header.recordDoubles); }
+    double getDt() const { return m_header.dt; }
+    std::uint64_t getRecordCount() const { return m_recordCount; }
+    const std::string& getPath() const { return m_path; }
+
+    // Record in file order (getRecordDoubles() doubles, TrajectoryColumn layout)
+    const double* getRecord(std::uint64_t index) const
+    {
+        return m_records + index * m_header.recordDoubles;
+    }
+
+    // Streams: one per source index up to the largest recorded one (some may be empty)
+    int getSourceCount() const { return static_cast<int>(m_streams.size()); }
+    std::uint64_t getSampleCount(int source) const { return m_streams[source].sampleCount; }
+    double getDuration(int source) const { return m_streams[source].duration; }
+
+    // Record and playback time of a stream's sample (clamped to the stream;
+    // nullptr for an empty stream)
+    const double* getSample(int source, std::uint64_t sample, double* playbackTime = nullptr) const;
+    // Last sample with playback time <= time (clamped to the stream)
+    std::uint64_t findSample(int source, double time) const;
+
+private:
+    struct IndexEntry
+    {
+        std::uint64_t record;       // record index of sample k * INDEX_STRIDE
+        double playbackTime;
+    };
+
+    struct Stream
+    {
+        std::vector<IndexEntry> index;
+        std::uint64_t sampleCount = 0;
+        double duration = 0.0;
+        double lastTime = 0.0;          // recorded time of the last sample (indexing)
+    };
+
+    std::string m_path;
+    TrajectoryFileHeader m_header = {};
+    std::uint64_t m_recordCount = 0;
+    std::vector<Stream> m_streams;
+    std::uint64_t m_activeSources = 0;  // streams with at least one sample
+
+    std::intptr_t m_file = -1;
+    std::intptr_t m_mapping = 0;
+    const char* m_data = nullptr;
+    const double* m_records = nullptr;
+    std::size_t m_mappedBytes = 0;
+
+    bool buildIndex();
+    double advance(double playbackTime, double previousTime, double time) const;
+    std::uint64_t nextRecord(int source, std::uint64_t record) const;
+};
@@ -0,0 +1,221 @@
+#include "TrajectoryRecorder.h"
+#include "Cart.h"
+#include "Pendulum.h"
+#include "PendulumEnv.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char FILE_MAGIC[4] = { 'P', 'T', 'R', 'J' };
+
+    // Multiple of the page size and of the Windows allocation granularity
+    constexpr std::size_t MAPPING_GRANULE = std::size_t(64) << 10;
+
+    std::size_t roundUp(std::size_t bytes, std::size_t multiple)
+    {
+        return (bytes + multiple - 1) / multiple * multiple;
+    }
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+    close();
+}
+
+bool TrajectoryRecorder::open(const std::string& path, int numAngles, double dt, std::size_t chunkBytes)
+{
+    close();
+    if (numAngles < 1) {
+        std::cerr << "ERROR: Trajectory records need at least one link" << std::endl;
+        return false;
+    }
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "ERROR: Failed to create trajectory file: " << path << std::endl;
+        return false;
+    }
+    m_file = reinterpret_cast<std::intptr_t>(file);
+#else
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        std::cerr << "ERROR: Failed to create trajectory file: " << path << std::endl;
+        return false;
+    }
+    m_file = file;
+#endif
+
+    m_path = path;
+    m_numAngles = numAngles;
+    m_chunkBytes = roundUp(std::max(chunkBytes, MAPPING_GRANULE), MAPPING_GRANULE);
+    m_recordCount = 0;
+    if (!mapFile(m_chunkBytes)) {
+        close();
+        return false;
+    }
+
+    TrajectoryFileHeader* fileHeader = header();
+    std::memset(fileHeader, 0, sizeof(TrajectoryFileHeader));
+    std::memcpy(fileHeader->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    fileHeader->version = FORMAT_VERSION;
+    fileHeader->numAngles = static_cast<std::uint32_t>(numAngles);
+    fileHeader->recordDoubles = static_cast<std::uint32_t>(getRecordDoubles());
+    fileHeader->recordCount = 0;
+    fileHeader->dt = dt;
+    return true;
+}
+
+void TrajectoryRecorder::close()
+{
+    if (m_file == -1) return;
+
+    // Drop the preallocated tail: the file ends after the last record
+    const std::uint64_t usedBytes = sizeof(TrajectoryFileHeader)
+        + m_recordCount * getRecordDoubles() * sizeof(double);
+    if (m_data) header()->recordCount = m_recordCount;
+    unmapFile();
+
+#if defined(_WIN32)
+    HANDLE file = reinterpret_cast<HANDLE>(m_file);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(usedBytes);
+    if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        std::cerr << "ERROR: Failed to trim trajectory file: " << m_path << std::endl;
+    }
+    CloseHandle(file);
+#else
+    if (ftruncate(static_cast<int>(m_file), static_cast<off_t>(usedBytes)) != 0) {
+        std::cerr << "ERROR: Failed to trim trajectory file: " << m_path << std::endl;
+    }
+    ::close(static_cast<int>(m_file));
+#endif
+    m_file = -1;
+}
+
+double* TrajectoryRecorder::beginRecords(std::size_t count)
+{
+    if (!m_data) return nullptr;
+    const std::size_t recordBytes = getRecordDoubles() * sizeof(double);
+    const std::size_t usedBytes = sizeof(TrajectoryFileHeader) + m_recordCount * recordBytes;
+    const std::size_t neededBytes = usedBytes + count * recordBytes;
+    if (neededBytes > m_mappedBytes && !mapFile(roundUp(neededBytes, m_chunkBytes))) {
+        return nullptr;
+    }
+    return reinterpret_cast<double*>(m_data + usedBytes);
+}
+
+void TrajectoryRecorder::commitRecords(std::size_t count)
+{
+    if (!m_data) return;
+    m_recordCount += count;
+    header()->recordCount = m_recordCount;
+}
+
+bool TrajectoryRecorder::record(std::uint32_t source, double time, const Cart& cart, const Pendulum& pendulum,
+    double appliedAcceleration, double effectiveAcceleration)
+{
+    if (pendulum.getNumAngles() != m_numAngles) {
+        std::cerr << "ERROR: Trajectory file " << m_path << " holds " << m_numAngles << "-link records" << std::endl;
+        return false;
+    }
+    double* record = beginRecords(1);
+    if (!record) return false;
+    writeRecord(record, source, time, cart, pendulum, appliedAcceleration, effectiveAcceleration);
+    commitRecords(1);
+    return true;
+}
+
+void TrajectoryRecorder::writeRecord(double* record, std::uint32_t source, double time,
+    const Cart& cart, const Pendulum& pendulum, double appliedAcceleration, double effectiveAcceleration)
+{
+    const double velocity = cart.getVelocity();
+    record[SOURCE_COLUMN] = static_cast<double>(source);
+    record[TIME_COLUMN] = time;
+    record[CART_POSITION_COLUMN] = cart.getPosition();
+    record[CART_VELOCITY_COLUMN] = velocity;
+    record[APPLIED_ACCELERATION_COLUMN] = appliedAcceleration;
+    record[EFFECTIVE_ACCELERATION_COLUMN] = effectiveAcceleration;
+    record[CART_KINETIC_COLUMN] = 0.5 * cart.getMass() * velocity * velocity;
+    record[PENDULUM_KINETIC_COLUMN] = pendulum.getKineticEnergy(velocity);
+    record[PENDULUM_POTENTIAL_COLUMN] = pendulum.getPotentialEnergy();
+    double* links = record + FIRST_LINK_COLUMN;
+    for (int i = 0; i < pendulum.getNumAngles(); ++i) {
+        links[2 * i] = pendulum.getAngle(i);
+        links[2 * i + 1] = pendulum.getAngularVelocity(i);
+    }
+}
+
+void TrajectoryRecorder::writeRecord(double* record, std::uint32_t source, const PendulumEnv& env)
+{
+    const PendulumEnvConfig& config = env.getConfig();
+    double time = env.getEpisodeSteps() * config.substeps * config.dt;
+    writeRecord(record, source, time, env.getCart(), env.getPendulum(),
+        env.getAppliedAcceleration(), env.getEffectiveAcceleration());
+}
+
+bool TrajectoryRecorder::mapFile(std::size_t bytes)
+{
+#if defined(_WIN32)
+    // A view cannot grow: remap the file at the new size
+    unmapFile();
+    HANDLE file = reinterpret_cast<HANDLE>(m_file);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<std::uint64_t>(bytes) >> 32), static_cast<DWORD>(bytes), nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, bytes) : nullptr;
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        std::cerr << "ERROR: Failed to map " << bytes << " bytes of trajectory file: " << m_path << std::endl;
+        return false;
+    }
+    m_mapping = reinterpret_cast<std::intptr_t>(mapping);
+#else
+    const int file = static_cast<int>(m_file);
+    if (ftruncate(file, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "ERROR: Failed to grow trajectory file to " << bytes << " bytes: " << m_path << std::endl;
+        return false;
+    }
+#if defined(__linux__)
+    void* data = m_data
+        ? mremap(m_data, m_mappedBytes, bytes, MREMAP_MAYMOVE)
+        : mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+#else
+    unmapFile();
+    void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+#endif
+    if (data == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map " << bytes << " bytes of trajectory file: " << m_path << std::endl;
+        return false;
+    }
+#endif
+    m_data = static_cast<char*>(data);
+    m_mappedBytes = bytes;
+    return true;
+}
+
+void TrajectoryRecorder::unmapFile()
+{
+    if (!m_data) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(reinterpret_cast<HANDLE>(m_mapping));
+    m_mapping = 0;
+#else
+    munmap(m_data, m_mappedBytes);
+#endif
+    m_data = nullptr;
+    m_mappedBytes = 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Cart;
+class Pendulum;
+class PendulumEnv;
+
+/**
+ * TrajectoryFileHeader - first 64 bytes of a trajectory file
+ *
+ * The rest of the file is recordCount records of recordDoubles
+ * little-endian doubles each, laid out as TrajectoryColumn. A reader can
+ * map it directly, e.g. numpy.memmap(path, float64, offset=64) reshaped to
+ * (-1, recordDoubles).
+ */
+struct TrajectoryFileHeader
+{
+    char magic[4];                  // "PTRJ"
+    std::uint32_t version;          // TrajectoryRecorder::FORMAT_VERSION
+    std::uint32_t numAngles;        // links per record
+    std::uint32_t recordDoubles;    // FIRST_LINK_COLUMN + 2 * numAngles
+    std::uint64_t recordCount;      // committed records
+    double dt;                      // physics tick of the recording (s)
+    std::uint8_t reserved[32];
+};
+static_assert(sizeof(TrajectoryFileHeader) == 64, "trajectory header must stay 64 bytes");
+
+/**
+ * TrajectoryColumn - fixed record schema
+ *
+ * Link i occupies FIRST_LINK_COLUMN + 2 * i (angle) and the column after
+ * it (angular velocity), in the same order as the PendulumEnv observation.
+ */
+enum TrajectoryColumn : int
+{
+    SOURCE_COLUMN = 0,              // simulation / environment index
+    TIME_COLUMN,                    // s since the start of the run or episode
+    CART_POSITION_COLUMN,
+    CART_VELOCITY_COLUMN,
+    APPLIED_ACCELERATION_COLUMN,    // commanded cart acceleration
+    EFFECTIVE_ACCELERATION_COLUMN,  // what reached the cart (0 when blocked at a rail end)
+    CART_KINETIC_COLUMN,            // energies in J
+    PENDULUM_KINETIC_COLUMN,
+    PENDULUM_POTENTIAL_COLUMN,
+    FIRST_LINK_COLUMN
+};
+
+/**
+ * TrajectoryRecorder - appends fixed-size state records to a memory-mapped file
+ *
+ * The file is mapped writable and grown in chunks of chunkBytes (64 MiB by
+ * default): records are stored straight into the mapping, so appending is
+ * a capacity check and a few stores, with no formatting or write() call.
+ * The header's recordCount is updated on every commit, so a run that dies
+ * still leaves a readable file; close() trims the preallocated tail.
+ *
+ * Batched writers reserve a block with beginRecords(count), fill disjoint
+ * records from any number of threads, and publish them with
+ * commitRecords(count) from the thread that reserved them. The mapping
+ * only moves inside beginRecords(), so pointers stay valid until the next
+ * call. Methods print an error and return false / nullptr on failure.
+ */
+class TrajectoryRecorder
+{
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+    static constexpr std::size_t DEFAULT_CHUNK_BYTES = std::size_t(64) << 20;
+
+    static int getRecordDoubles(int numAngles) { return FIRST_LINK_COLUMN + 2 * numAngles; }
+
+    TrajectoryRecorder() = default;
+    ~TrajectoryRecorder();
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    // Create (or truncate) path for records of numAngles links
+    bool open(const std::string& path, int numAngles, double dt,
+        std::size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Storage for count records (count * getRecordDoubles() doubles)
+    double* beginRecords(std::size_t count);
+    void commitRecords(std::size_t count);
+
+    // Append one record of the current cart / pendulum state
+    bool record(std::uint32_t source, double time, const Cart& cart, const Pendulum& pendulum,
+        double appliedAcceleration, double effectiveAcceleration);
+
+    // Fill one record in place (no file access; safe from any thread)
+    static void writeRecord(double* record, std::uint32_t source, double time,
+        const Cart& cart, const Pendulum& pendulum,
+        double appliedAcceleration, double effectiveAcceleration);
+    // Episode time and the last tick's accelerations of an environment
+    static void writeRecord(double* record, std::uint32_t source, const PendulumEnv& env);
+
+    std::uint64_t getRecordCount() const { return m_recordCount; }
+    int getNumAngles() const { return m_numAngles; }
+    int getRecordDoubles() const { return getRecordDoubles(m_numAngles); }
+    const std::string& getPath() const { return m_path; }
+
+private:
+    std::string m_path;
+    int m_numAngles = 0;
+    std::size_t m_chunkBytes = DEFAULT_CHUNK_BYTES;
+    std::uint64_t m_recordCount = 0;
+
+    // File descriptor (POSIX) or file / mapping handles (Windows)
+    std::intptr_t m_file = -1;
+    std::intptr_t m_mapping = 0;
+    char* m_data = nullptr;
+    std::size_t m_mappedBytes = 0;
+
+    bool mapFile(std::size_t bytes);
+    void unmapFile();
+    TrajectoryFileHeader* header() const { return reinterpret_cast<TrajectoryFileHeader*>(m_data); }
+};
@@ -0,0 +1,147 @@
+#include "VecEnv.h"
+#include "Random.h"
+#include <algorithm>
+#include <iostream>
+
+VecEnv::VecEnv(std::size_t numEnvs, const PendulumEnvConfig& config, int numThreads)
+    : m_done(numEnvs, RUNNING)
+    , m_numLinks(std::max(1, config.numLinks))
+    , m_observationSize(2 + 2 * m_numLinks)
+    , m_pool(numThreads)
+{
+    m_envs.reserve(numEnvs);
+    for (std::size_t env = 0; env < numEnvs; ++env) {
+        m_envs.push_back(std::make_unique<PendulumEnv>(config));
+    }
+}
+
+std::size_t VecEnv::getChunkSize() const
+{
+    if (m_chunkSize > 0) return m_chunkSize;
+    std::size_t chunks = 8 * static_cast<std::size_t>(m_pool.getNumThreads());
+    return std::max<std::size_t>(1, m_envs.size() / chunks);
+}
+
+std::size_t VecEnv::getNumActive() const
+{
+    return static_cast<std::size_t>(std::count(m_done.begin(), m_done.end(), RUNNING));
+}
+
+template <typename Function>
+void VecEnv::forEachChunk(const Function& function)
+{
+    if (m_workStealing) {
+        m_pool.parallelForDynamic(m_envs.size(), getChunkSize(), function);
+    }
+    else {
+        m_pool.parallelFor(m_envs.size(), function);
+    }
+}
+
+void VecEnv::reset(std::uint64_t seed, double* observations)
+{
+    forEachChunk([&](std::size_t begin, std::size_t end) {
+        for (std::size_t env = begin; env < end; ++env) {
+            // Hash (seed, env) so neighbouring environments get unrelated streams
+            std::uint64_t state = seed ^ (0xD1B54A32D192ED03ULL * (env + 1));
+            m_envs[env]->setSeed(splitMix64(state));
+            m_envs[env]->resetInto(observations + env * m_observationSize);
+            m_done[env] = RUNNING;
+        }
+        });
+}
+
+bool VecEnv::saveSnapshots(SnapshotArena& arena, std::size_t firstSlot) const
+{
+    if (firstSlot + m_envs.size() > arena.getCapacity() || arena.getSlotBytes() < getSnapshotBytes()) {
+        std::cerr << "ERROR: Snapshot arena too small for " << m_envs.size() << " environments" << std::endl;
+        return false;
+    }
+    // A few dozen bytes per environment: cheaper than waking the pool
+    for (std::size_t env = 0; env < m_envs.size(); ++env) {
+        m_envs[env]->saveSnapshot(arena.getSlot(firstSlot + env));
+    }
+    return true;
+}
+
+bool VecEnv::restoreSnapshots(const SnapshotArena& arena, double* observations, std::size_t firstSlot)
+{
+    if (firstSlot + m_envs.size() > arena.getCapacity() || arena.getSlotBytes() < getSnapshotBytes()) {
+        std::cerr << "ERROR: Snapshot arena too small for " << m_envs.size() << " environments" << std::endl;
+        return false;
+    }
+    for (std::size_t env = 0; env < m_envs.size(); ++env) {
+        if (static_cast<const PendulumEnvSnapshot*>(arena.getSlot(firstSlot + env))->numLinks != m_numLinks) {
+            std::cerr << "ERROR: Snapshot " << firstSlot + env << " is not a " << m_numLinks << "-link state" << std::endl;
+            return false;
+        }
+    }
+    forEachChunk([&](std::size_t begin, std::size_t end) {
+        for (std::size_t env = begin; env < end; ++env) {
+            m_envs[env]->restoreSnapshot(arena.getSlot(firstSlot + env));
+            const double* observation = m_envs[env]->getObservation();
+            std::copy(observation, observation + m_observationSize, observations + env * m_observationSize);
+            m_done[env] = RUNNING;
+        }
+        });
+    return true;
+}
+
+bool VecEnv::fork(const void* snapshot, double* observations)
+{
+    if (static_cast<const PendulumEnvSnapshot*>(snapshot)->numLinks != m_numLinks) {
+        std::cerr << "ERROR: Cannot fork a " << static_cast<const PendulumEnvSnapshot*>(snapshot)->numLinks
+            << "-link snapshot into " << m_numLinks << "-link environments" << std::endl;
+        return false;
+    }
+    forEachChunk([&](std::size_t begin, std::size_t end) {
+        for (std::size_t env = begin; env < end; ++env) {
+            m_envs[env]->restoreSnapshot(snapshot);
+            const double* observation = m_envs[env]->getObservation();
+            std::copy(observation, observation + m_observationSize, observations + env * m_observationSize);
+            m_done[env] = RUNNING;
+        }
+        });
+    return true;
+}
+
+bool VecEnv::fork(const PendulumEnv& source, double* observations)
+{
+    // Through a snapshot: the source may be one of this pool's environments
+    m_forkSnapshot.resize((source.getSnapshotBytes() + sizeof(double) - 1) / sizeof(double));
+    source.saveSnapshot(m_forkSnapshot.data());
+    return fork(m_forkSnapshot.data(), observations);
+}
+
+void VecEnv::step(const double* actions, double* observations, double* rewards,
+    std::uint8_t* terminated, std::uint8_t* truncated, double* finalObservations)
+{
+    forEachChunk([&](std::size_t begin, std::size_t end) {
+        for (std::size_t env = begin; env < end; ++env) {
+            if (m_done[env] != RUNNING) {
+                rewards[env] = 0.0;
+                terminated[env] = m_done[env] == TERMINATED ? 1 : 0;
+                truncated[env] = m_done[env] == TRUNCATED ? 1 : 0;
+                continue;
+            }
+
+            double* row = observations + env * m_observationSize;
+            PendulumEnv::StepResult result = m_envs[env]->stepInto(actions[env], row);
+            rewards[env] = result.reward;
+            terminated[env] = result.terminated ? 1 : 0;
+            truncated[env] = result.truncated ? 1 : 0;
+
+            if (result.terminated || result.truncated) {
+                if (finalObservations) {
+                    std::copy(row, row + m_observationSize, finalObservations + env * m_observationSize);
+                }
+                if (m_autoReset) {
+                    m_envs[env]->resetInto(row);
+                }
+                else {
+                    m_done[env] = result.terminated ? TERMINATED : TRUNCATED;
+                }
+            }
+        }
+        });
+}
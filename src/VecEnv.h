@@ -0,0 +1,110 @@
+#pragma once
+
+#include "PendulumEnv.h"
+#include "SnapshotArena.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * VecEnv - pool of PendulumEnv instances stepped in parallel with auto-reset
+ *
+ * Batched data lives in caller-owned contiguous arrays, indexed by
+ * environment: observations are row-major numEnvs x getObservationSize()
+ * doubles, rewards numEnvs doubles, and the done flags numEnvs bytes
+ * (0 / 1). Each environment writes its row in place; nothing is gathered
+ * or copied per environment.
+ *
+ * An environment whose episode terminated or was truncated in step() is
+ * reset immediately: its row in observations holds the first observation
+ * of the next episode, and the last observation of the finished one goes
+ * to finalObservations (same layout) when that array is provided.
+ *
+ * With setAutoReset(false) a finished environment instead stays done until
+ * the next reset(): step() skips it, leaves its observation row as is,
+ * reports reward 0 and repeats its terminated / truncated flag. This is
+ * the one-episode-per-environment rollout, where episodes of very different
+ * lengths leave most of the batch idle towards the end.
+ *
+ * Environments are cut into chunks of getChunkSize() and scheduled with
+ * work stealing, so threads whose environments finished early take over
+ * chunks from the others; per-thread counters are available through
+ * getWorkerStats(). setWorkStealing(false) falls back to one contiguous
+ * block per thread. With all workspaces sized, step() performs no heap
+ * allocation.
+ *
+ * For tree search and sampling-based control the pool doubles as a set of
+ * branches: fork() puts every environment in one state (a snapshot or a
+ * live PendulumEnv), and save / restoreSnapshots() move all states to and
+ * from a SnapshotArena, e.g. to rewind after a batch of rollouts.
+ *
+ * numEnvs may be 0; every batched call is then a no-op.
+ */
+class VecEnv
+{
+public:
+    // numThreads counts the calling thread; 0 = one per hardware thread
+    VecEnv(std::size_t numEnvs, const PendulumEnvConfig& config, int numThreads = 0);
+
+    std::size_t getNumEnvs() const { return m_envs.size(); }
+    int getObservationSize() const { return m_observationSize; }
+    int getNumThreads() const { return m_pool.getNumThreads(); }
+
+    // Reset every environment. Environment i draws its episodes from a
+    // stream derived from (seed, i), independent of the thread count.
+    void reset(std::uint64_t seed, double* observations);
+
+    // Step every environment with actions[i] and auto-reset finished ones
+    void step(const double* actions, double* observations, double* rewards,
+        std::uint8_t* terminated, std::uint8_t* truncated,
+        double* finalObservations = nullptr);
+
+    // Environment i to / from arena slot firstSlot + i. Restoring (and
+    // forking) makes every environment active and writes its observation row.
+    // Both print an error and return false if the arena is too small.
+    bool saveSnapshots(SnapshotArena& arena, std::size_t firstSlot = 0) const;
+    bool restoreSnapshots(const SnapshotArena& arena, double* observations, std::size_t firstSlot = 0);
+    // Every environment continues from the same state
+    bool fork(const void* snapshot, double* observations);
+    bool fork(const PendulumEnv& source, double* observations);
+    std::size_t getSnapshotBytes() const { return PendulumEnv::getSnapshotBytes(m_numLinks); }
+
+    void setAutoReset(bool enabled) { m_autoReset = enabled; }
+    bool getAutoReset() const { return m_autoReset; }
+    // Environments not yet done since reset() (all of them with auto-reset)
+    std::size_t getNumActive() const;
+
+    void setWorkStealing(bool enabled) { m_workStealing = enabled; }
+    bool getWorkStealing() const { return m_workStealing; }
+    // Environments per scheduling chunk; 0 picks about 8 chunks per thread
+    void setChunkSize(std::size_t envs) { m_chunkSize = envs; }
+    std::size_t getChunkSize() const;
+
+    ThreadPool::WorkerStats getWorkerStats(int thread) const { return m_pool.getWorkerStats(thread); }
+    double getParallelSeconds() const { return m_pool.getParallelSeconds(); }
+    void resetWorkerStats() { m_pool.resetStats(); }
+    // The stepping threads, for batched work between steps (e.g. policy inference)
+    ThreadPool& getThreadPool() { return m_pool; }
+
+    PendulumEnv& getEnv(std::size_t index) { return *m_envs[index]; }
+    const PendulumEnv& getEnv(std::size_t index) const { return *m_envs[index]; }
+
+private:
+    // Values of m_done: still running, or how the episode ended
+    enum : std::uint8_t { RUNNING = 0, TERMINATED = 1, TRUNCATED = 2 };
+
+    std::vector<std::unique_ptr<PendulumEnv>> m_envs;
+    std::vector<std::uint8_t> m_done;
+    std::vector<double> m_forkSnapshot;     // fork(PendulumEnv) staging
+    int m_numLinks;                         // from the config: valid with numEnvs == 0
+    int m_observationSize;
+    bool m_autoReset = true;
+    bool m_workStealing = true;
+    std::size_t m_chunkSize = 0;
+    ThreadPool m_pool;
+
+    template <typename Function>
+    void forEachChunk(const Function& function);
+};
@@ -0,0 +1,140 @@
+#include "ScenarioRunner.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * PendulumBatch - runs many simulation scenarios unattended, unpaced
+ *
+ * Scenarios come from --config files (ScenarioRunner::load) or, without
+ * one, from key=value arguments alone; key=value arguments given with
+ * files override every scenario. Scenarios run concurrently on a
+ * ThreadPool, each as fast as one core allows, optionally writing a
+ * TrajectoryRecorder file. Two scenarios writing the same file (e.g. equal
+ * names under --output-dir) are rejected before anything runs. Prints one
+ * CSV row per scenario (in file order) and the aggregate steps/sec at the
+ * end; exits non-zero if any scenario could not be set up.
+ */
+
+namespace
+{
+    struct Options
+    {
+        std::vector<std::string> configPaths;
+        std::vector<std::string> overrides;     // key=value
+        int threads = 0;                        // 0 = hardware threads
+        std::string outputDir;                  // <dir>/<name>.ptrj when a scenario has no output
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: PendulumBatch [options] [key=value ...]\n"
+            << "  --config <file>      scenario file, repeatable: '[name]' sections of key = value\n"
+            << "                       lines; lines before the first section set the defaults\n"
+            << "  --threads <n>        scenarios run in parallel, 0 = hardware threads (default 0)\n"
+            << "  --output-dir <dir>   write <dir>/<name>.ptrj for scenarios without an output\n"
+            << "  key=value            without --config: the single scenario to run;\n"
+            << "                       with --config: applied to every scenario\n"
+            << "Keys: name links coupled integrator dt duration gravity friction cart_mass\n"
+            << "      rail_length mass1 mass2 length1 length2 angle1 angle2\n"
+            << "      controller (scripted, policy, lqr, mpc) accel freq policy policy_every\n"
+            << "      max_accel mpc_iterations mpc_budget output\n";
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--config" && hasValue) options.configPaths.push_back(argv[++i]);
+            else if (arg == "--threads" && hasValue) options.threads = std::atoi(argv[++i]);
+            else if (arg == "--output-dir" && hasValue) options.outputDir = argv[++i];
+            else if (arg.find('=') != std::string::npos && arg.compare(0, 2, "--") != 0) options.overrides.push_back(arg);
+            else return false;
+        }
+        return options.threads >= 0;
+    }
+
+    bool applyOverrides(Scenario& scenario, const std::vector<std::string>& overrides)
+    {
+        for (const std::string& setting : overrides) {
+            const std::size_t equals = setting.find('=');
+            if (!ScenarioRunner::set(scenario, setting.substr(0, equals), setting.substr(equals + 1))) return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    for (const std::string& path : options.configPaths) {
+        if (!ScenarioRunner::load(path, Scenario(), scenarios)) return 1;
+    }
+    if (scenarios.empty()) scenarios.emplace_back();
+    for (Scenario& scenario : scenarios) {
+        if (!applyOverrides(scenario, options.overrides)) return 1;
+        if (scenario.outputPath.empty() && !options.outputDir.empty()) {
+            scenario.outputPath = options.outputDir + "/" + scenario.name + ".ptrj";
+        }
+        if (!ScenarioRunner::validate(scenario)) return 1;
+    }
+
+    std::map<std::string, std::size_t> outputs;
+    for (std::size_t i = 0; i < scenarios.size(); ++i) {
+        if (scenarios[i].outputPath.empty()) continue;
+        auto inserted = outputs.emplace(scenarios[i].outputPath, i);
+        if (!inserted.second) {
+            std::cerr << "ERROR: Scenarios " << scenarios[inserted.first->second].name << " and "
+                << scenarios[i].name << " both write " << scenarios[i].outputPath
+                << "; give them distinct names or outputs" << std::endl;
+            return 1;
+        }
+    }
+
+    ThreadPool pool(options.threads);
+    std::vector<ScenarioResult> results(scenarios.size());
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallelForDynamic(scenarios.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) results[i] = ScenarioRunner::run(scenarios[i]);
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "name,links,controller,ticks,simulated_s,wall_s,steps_per_s,final_cart_position,"
+        << "upright_error,energy_drift,records,status\n";
+    std::uint64_t totalTicks = 0;
+    double simulated = 0.0;
+    int failed = 0;
+    for (std::size_t i = 0; i < scenarios.size(); ++i) {
+        const Scenario& scenario = scenarios[i];
+        const ScenarioResult& result = results[i];
+        std::cout << scenario.name << ',' << scenario.links << ','
+            << ScenarioRunner::getControllerName(scenario.controller) << ',' << result.ticks << ','
+            << result.simulatedSeconds << ',' << result.wallSeconds << ','
+            << (result.wallSeconds > 0.0 ? result.ticks / result.wallSeconds : 0.0) << ','
+            << result.finalCartPosition << ',' << result.finalUprightError << ',' << result.energyDrift << ','
+            << result.records << ',' << (result.ok ? "ok" : "failed") << '\n';
+        totalTicks += result.ticks;
+        simulated += result.simulatedSeconds;
+        failed += !result.ok;
+    }
+
+    std::cerr << scenarios.size() << " scenario(s), " << failed << " failed, on " << pool.getNumThreads()
+        << " thread(s): " << totalTicks << " steps (" << simulated << " s simulated) in "
+        << seconds * 1000.0 << " ms, " << std::fixed << std::setprecision(0)
+        << (seconds > 0.0 ? totalTicks / seconds : 0.0) << " steps/s, "
+        << std::setprecision(1) << (seconds > 0.0 ? simulated / seconds : 0.0) << "x real time\n";
+    return failed ? 1 : 0;
+}
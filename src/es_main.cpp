@@ -0,0 +1,124 @@
+#include "EsTrainer.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * PendulumES - trains an MlpPolicy with evolution strategies
+ *
+ * Runs EsTrainer generations on the PendulumEnv task (hanging start,
+ * swing-up reward by default), prints one line of fitness and throughput
+ * per generation and saves the best central policy seen so far to --out,
+ * ready for PendulumHeadless --policy or the viewer's Policy mode.
+ */
+
+namespace
+{
+    struct Options
+    {
+        EsConfig es;
+        int generations = 200;
+        std::string outputPath = "policy.bin";
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: PendulumES [options]\n"
+            << "  --links <n>          number of links (default 1)\n"
+            << "  --generations <n>    generations to run (default 200)\n"
+            << "  --pairs <n>          antithetic perturbation pairs per generation (default 64)\n"
+            << "  --episodes <n>       episodes per fitness evaluation (default 8)\n"
+            << "  --steps <n>          episode length in env steps (default 500)\n"
+            << "  --hidden <a,b,...>   hidden layer widths (default 32,32)\n"
+            << "  --sigma <s>          perturbation scale (default 0.05)\n"
+            << "  --lr <r>             Adam learning rate (default 0.02)\n"
+            << "  --decay <d>          weight decay (default 0.005)\n"
+            << "  --threads <n>        worker threads, 0 = hardware threads (default 0)\n"
+            << "  --seed <s>           noise, episode and initialization seed (default 1)\n"
+            << "  --out <file>         where to save the best policy (default policy.bin)\n";
+    }
+
+    bool parseSizes(const std::string& text, std::vector<int>& sizes)
+    {
+        sizes.clear();
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            int size = std::atoi(item.c_str());
+            if (size < 1 || size > MlpPolicy::MAX_WIDTH) return false;
+            sizes.push_back(size);
+        }
+        return !sizes.empty();
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        EsConfig& es = options.es;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--links" && hasValue) es.env.numLinks = std::atoi(argv[++i]);
+            else if (arg == "--generations" && hasValue) options.generations = std::atoi(argv[++i]);
+            else if (arg == "--pairs" && hasValue) es.populationPairs = std::atoi(argv[++i]);
+            else if (arg == "--episodes" && hasValue) es.episodesPerMember = std::atoi(argv[++i]);
+            else if (arg == "--steps" && hasValue) es.env.maxEpisodeSteps = std::atoi(argv[++i]);
+            else if (arg == "--hidden" && hasValue) {
+                if (!parseSizes(argv[++i], es.hiddenSizes)) return false;
+            }
+            else if (arg == "--sigma" && hasValue) es.sigma = std::atof(argv[++i]);
+            else if (arg == "--lr" && hasValue) es.learningRate = std::atof(argv[++i]);
+            else if (arg == "--decay" && hasValue) es.weightDecay = std::atof(argv[++i]);
+            else if (arg == "--threads" && hasValue) es.numThreads = std::atoi(argv[++i]);
+            else if (arg == "--seed" && hasValue) es.seed = std::strtoull(argv[++i], nullptr, 10);
+            else if (arg == "--out" && hasValue) options.outputPath = argv[++i];
+            else return false;
+        }
+        return es.env.numLinks >= 1 && options.generations >= 1 && es.populationPairs >= 1
+            && es.episodesPerMember >= 1 && es.env.maxEpisodeSteps >= 1 && es.sigma > 0.0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    EsTrainer trainer(options.es);
+    std::cout << "parameters: " << trainer.getPolicy().getParameterCount()
+        << ", population: " << 2 * options.es.populationPairs
+        << ", threads: " << trainer.getNumThreads() << "\n"
+        << std::setw(6) << "gen" << std::setw(12) << "mean" << std::setw(12) << "max"
+        << std::setw(12) << "central" << std::setw(14) << "env-steps/s" << std::setw(10) << "elapsed" << "\n";
+
+    double bestFitness = -1e300;
+    double elapsed = 0.0;
+    long long totalSteps = 0;
+    for (int generation = 0; generation < options.generations; ++generation) {
+        EsGenerationStats stats = trainer.step();
+        elapsed += stats.seconds;
+        totalSteps += stats.envSteps;
+        std::cout << std::setw(6) << stats.generation << std::fixed << std::setprecision(2)
+            << std::setw(12) << stats.meanFitness << std::setw(12) << stats.maxFitness
+            << std::setw(12) << stats.centralFitness
+            << std::setw(14) << std::setprecision(0) << stats.envSteps / stats.seconds
+            << std::setw(9) << std::setprecision(1) << elapsed << "s";
+
+        if (stats.centralFitness > bestFitness) {
+            bestFitness = stats.centralFitness;
+            if (!trainer.getPolicy().save(options.outputPath)) return 1;
+            std::cout << "  saved";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "best central fitness " << std::setprecision(2) << bestFitness << " -> " << options.outputPath
+        << " (" << totalSteps << " env steps in " << std::setprecision(1) << elapsed << " s)\n";
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include "Cart.h"
+#include "Pendulum.h"
+#include "ScenarioRunner.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/**
+ * PendulumHeadless - runs the cart-pendulum simulation without a window
+ *
+ * Runs one Scenario built from the command line through ScenarioRunner (the
+ * same objects and per-tick sequence as the interactive loop in main.cpp),
+ * driven by a scripted cart acceleration (or an MlpPolicy, --policy, or the
+ * LQR balance controller, --lqr) instead of the keyboard. Prints the
+ * state as CSV every --print-every ticks and a throughput summary at the end;
+ * --record writes every tick to a binary TrajectoryRecorder file.
+ */
+
+namespace
+{
+    struct Options
+    {
+        int links = 1;                  // 1 single, 2 double, 3+ chain
+        bool coupled = false;
+        IntegratorType integrator = IntegratorType::DormandPrince87;
+        int ticks = 1440;               // 10 s at 144 Hz
+        double dt = 1.0 / 144.0;
+        double accelAmplitude = 0.0;    // m/s^2
+        double accelFrequency = 0.0;    // Hz; 0 = constant acceleration
+        double initialAngle = 0.5;      // rad, first link
+        double initialAngle2 = 0.0;     // rad, second link
+        double friction = 0.1;
+        double gravity = 9.81;
+        int printEvery = 144;           // 0 = summary only
+        std::string policyPath;         // empty = scripted acceleration
+        int policyEvery = 4;            // ticks between policy evaluations
+        double maxAcceleration = 30.0;  // m/s^2 at policy action 1
+        std::string recordPath;         // empty = no trajectory file
+        bool lqr = false;               // LQR balance control every tick
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: PendulumHeadless [options]\n"
+            << "  --double             simulate the double pendulum (same as --links 2)\n"
+            << "  --links <n>          number of links; 3 or more uses the N-link chain (default 1)\n"
+            << "  --coupled            integrate cart and pendulum as one coupled system (1-2 links)\n"
+            << "  --integrator <i>     0 semi-implicit Euler, 1 velocity Verlet, 2 Yoshida 4,\n"
+            << "                       3 RK4, 4 Dormand-Prince 8(7) (default)\n"
+            << "  --ticks <n>          number of physics ticks (default 1440)\n"
+            << "  --dt <s>             time step (default 1/144)\n"
+            << "  --accel <a>          cart acceleration amplitude in m/s^2 (default 0)\n"
+            << "  --freq <hz>          sinusoidal acceleration frequency (default 0: constant)\n"
+            << "  --angle <rad>        initial angle of the first link (default 0.5)\n"
+            << "  --angle2 <rad>       initial angle of the second link (default 0)\n"
+            << "  --friction <f>       friction / damping coefficient (default 0.1)\n"
+            << "  --gravity <g>        gravitational acceleration (default 9.81)\n"
+            << "  --print-every <k>    CSV output interval in ticks, 0 for none (default 144)\n"
+            << "  --policy <file>      drive the cart with an MLP policy weights file\n"
+            << "  --policy-every <k>   ticks between policy evaluations (default 4)\n"
+            << "  --max-accel <a>      acceleration at policy action 1 in m/s^2 (default 30)\n"
+            << "  --lqr                balance upright with the LQR controller (1-2 links,\n"
+            << "                       acceleration limited by --max-accel)\n"
+            << "  --record <file>      write every tick to a binary trajectory file\n";
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--double") options.links = 2;
+            else if (arg == "--links" && hasValue) options.links = std::atoi(argv[++i]);
+            else if (arg == "--coupled") options.coupled = true;
+            else if (arg == "--integrator" && hasValue) {
+                int index = std::atoi(argv[++i]);
+                if (index < 0 || index >= INTEGRATOR_TYPE_COUNT) return false;
+                options.integrator = static_cast<IntegratorType>(index);
+            }
+            else if (arg == "--ticks" && hasValue) options.ticks = std::atoi(argv[++i]);
+            else if (arg == "--dt" && hasValue) options.dt = std::atof(argv[++i]);
+            else if (arg == "--accel" && hasValue) options.accelAmplitude = std::atof(argv[++i]);
+            else if (arg == "--freq" && hasValue) options.accelFrequency = std::atof(argv[++i]);
+            else if (arg == "--angle" && hasValue) options.initialAngle = std::atof(argv[++i]);
+            else if (arg == "--angle2" && hasValue) options.initialAngle2 = std::atof(argv[++i]);
+            else if (arg == "--friction" && hasValue) options.friction = std::atof(argv[++i]);
+            else if (arg == "--gravity" && hasValue) options.gravity = std::atof(argv[++i]);
+            else if (arg == "--print-every" && hasValue) options.printEvery = std::atoi(argv[++i]);
+            else if (arg == "--policy" && hasValue) options.policyPath = argv[++i];
+            else if (arg == "--policy-every" && hasValue) options.policyEvery = std::atoi(argv[++i]);
+            else if (arg == "--max-accel" && hasValue) options.maxAcceleration = std::atof(argv[++i]);
+            else if (arg == "--record" && hasValue) options.recordPath = argv[++i];
+            else if (arg == "--lqr") options.lqr = true;
+            else return false;
+        }
+        return options.links >= 1 && options.ticks >= 0 && options.dt > 0.0 && options.policyEvery >= 1;
+    }
+
+    Scenario makeScenario(const Options& options)
+    {
+        Scenario scenario;
+        scenario.name = "headless";
+        scenario.links = options.links;
+        scenario.coupled = options.coupled;
+        scenario.integrator = options.integrator;
+        scenario.dt = options.dt;
+        scenario.duration = options.ticks * options.dt;
+        scenario.gravity = options.gravity;
+        scenario.friction = options.friction;
+        // Chains keep the viewer's total length of 2 m, split evenly
+        if (options.links > 2) scenario.length[0] = 2.0 / options.links;
+        scenario.initialAngle[0] = options.initialAngle;
+        scenario.initialAngle[1] = options.initialAngle2;
+
+        if (options.lqr) scenario.controller = ScenarioController::Lqr;
+        else if (!options.policyPath.empty()) scenario.controller = ScenarioController::Policy;
+        scenario.accelAmplitude = options.accelAmplitude;
+        scenario.accelFrequency = options.accelFrequency;
+        scenario.policyPath = options.policyPath;
+        scenario.policyEvery = options.policyEvery;
+        scenario.maxAcceleration = options.maxAcceleration;
+        scenario.outputPath = options.recordPath;
+        return scenario;
+    }
+
+    void printRow(double time, const Cart& cart, const Pendulum& pendulum)
+    {
+        double energy = 0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity()
+            + pendulum.getTotalEnergy(cart.getVelocity());
+        std::cout << time << ',' << cart.getPosition() << ',' << cart.getVelocity();
+        for (int i = 0; i < pendulum.getNumAngles(); ++i) {
+            std::cout << ',' << pendulum.getAngle(i) << ',' << pendulum.getAngularVelocity(i);
+        }
+        std::cout << ',' << energy << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    const Scenario scenario = makeScenario(options);
+    if (!ScenarioRunner::validate(scenario)) return 1;
+
+    ScenarioRunner::TickObserver print;
+    if (options.printEvery > 0) {
+        std::cout << "time,cart_position,cart_velocity";
+        for (int i = 0; i < options.links; ++i) {
+            std::cout << ",angle" << i + 1 << ",angular_velocity" << i + 1;
+        }
+        std::cout << ",total_energy\n";
+        const std::uint64_t every = static_cast<std::uint64_t>(options.printEvery);
+        print = [every](std::uint64_t tick, double time, const Cart& cart, const Pendulum& pendulum) {
+            if (tick % every == 0) printRow(time, cart, pendulum);
+        };
+    }
+
+    const ScenarioResult result = ScenarioRunner::run(scenario, print);
+    if (!result.ok) return 1;
+
+    std::cerr << result.ticks << " ticks (" << result.simulatedSeconds << " s simulated) in "
+        << result.wallSeconds * 1000.0 << " ms, "
+        << (result.wallSeconds > 0.0 ? result.ticks / result.wallSeconds : 0.0) << " ticks/s\n";
+    if (!scenario.outputPath.empty()) {
+        std::cerr << result.records << " records written to " << scenario.outputPath << "\n";
+    }
+    return 0;
+}
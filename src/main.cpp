@@ -8,13 +8,24 @@
 #include "Cart.h"
 #include "SinglePendulum.h"
 #include "DoublePendulum.h"
+#include "CartPendulumSystem.h"
+#include "FixedStepThread.h"
 #include "InputController.h"
+#include "Mailbox.h"
+#include "PendulumEnv.h"
+#include "TrajectoryPlayer.h"
+#include "TrajectoryRecorder.h"
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <algorithm>
 #include <cfloat>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
 
 // Window dimensions
 const int WINDOW_WIDTH = 1280;
@@ -23,7 +34,7 @@ const int WINDOW_HEIGHT = 720;
 // Callback for window resize
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 
-int main()
+int main(int argc, char** argv)
 {
     // ============================================================
     // GLFW Initialization
@@ -91,6 +102,12 @@ int main()
     std::unique_ptr<DoublePendulum> doublePendulum =
         std::make_unique<DoublePendulum>(1.0, 1.0, 1.0, 1.0);  // 1kg, 1m each
 
+    // Coupled integration of the cart with each pendulum (pendulum reaction
+    // forces act back on the cart); off by default to keep the original model
+    CartPendulumSystem coupledSingle(cart, *singlePendulum);
+    CartPendulumSystem coupledDouble(cart, *doublePendulum);
+    bool coupledDynamics = false;
+
     // Start with single pendulum
     bool useSinglePendulum = true;
     Pendulum* currentPendulum = singlePendulum.get();
@@ -101,8 +118,18 @@ int main()
     // Ensure initial view fits the cart rail
     renderer.setViewWidthForRail(cart.getRailLength());
 
-    // Input controller
+    // Input controller; an optional weights file starts in policy control
     InputController input(window);
+    static char policyPath[256] = "policy.bin";
+    if (argc > 1) {
+        std::snprintf(policyPath, sizeof(policyPath), "%s", argv[1]);
+        if (input.loadPolicy(policyPath)) {
+            input.setControlMode(InputController::ControlMode::Policy);
+            std::cout << "Loaded policy " << policyPath << "\n";
+        }
+    }
+    // PendulumEnv observation of the current state (up to two links)
+    double observation[6] = {};
 
     // ============================================================
     // Simulation parameters
@@ -112,11 +139,26 @@ int main()
     double dt = 1.0 / 144.0;     // Time step (144 Hz)
     double simulationTime = 0.0;
 
-    // Energy instrumentation (history buffer for plotting)
-    const int ENERGY_HISTORY_SIZE = 1440; // e.g. 10s @ 144Hz
+    // Energy instrumentation (history buffer for plotting): one sample per
+    // physics tick, or per replayed record shown
+    const int ENERGY_HISTORY_SIZE = 1440; // 10 s of ticks at dt = 1/144
     std::vector<float> energyHistory(ENERGY_HISTORY_SIZE, 0.0f);
     int energyIndex = 0;
     int energyCount = 0;
+    auto pushEnergy = [&](double joules) {
+        // Stored in millijoules (mJ)
+        energyHistory[energyIndex] = static_cast<float>(joules * 1000.0);
+        energyIndex = (energyIndex + 1) % ENERGY_HISTORY_SIZE;
+        if (energyCount < ENERGY_HISTORY_SIZE) ++energyCount;
+    };
+
+    // Trajectory recording (every physics tick, toggled in the Simulation tab)
+    TrajectoryRecorder recorder;
+    static char recordPath[256] = "trajectory.ptrj";
+
+    // Trajectory replay (Replay tab)
+    TrajectoryPlayer player;
+    static char replayPath[256] = "trajectory.ptrj";
 
     // ============================================================
     // Main Loop
@@ -124,15 +166,103 @@ int main()
     std::cout << "\n=== Controls ===\n";
     std::cout << "A/D: Move cart left/right\n";
     std::cout << "Left/Right arrows: Move cart left/right\n";
+    std::cout << "P: Toggle keyboard / policy control\n";
+    std::cout << "L: Toggle keyboard / LQR balance control\n";
+    std::cout << "M: Toggle keyboard / MPC swing-up control\n";
     std::cout << "SPACE: Toggle single/double pendulum\n";
     std::cout << "R: Reset simulation\n";
     std::cout << "ESC: Quit\n";
     std::cout << "================\n\n";
 
+    // ============================================================
+    // Physics thread
+    // ============================================================
+    // Cart and pendulum advance in fixed dt ticks on their own thread, in
+    // step with real time whatever the frame rate. The main loop takes the
+    // simulation lock only to poll keys and to build the UI (widgets read
+    // and edit the live objects); the renderer draws from snapshots.
+    struct SceneInterval
+    {
+        SceneSnapshot previous;
+        SceneSnapshot current;
+    };
+    using Clock = FixedStepThread::Clock;
+    const Clock::time_point clockStart = Clock::now();
+    auto clockSeconds = [clockStart](Clock::time_point time) {
+        return std::chrono::duration<double>(time - clockStart).count();
+    };
+    Mailbox<SceneInterval> scenes;
+    SceneSnapshot lastScene = SceneSnapshot::capture(cart, *currentPendulum, 0.0);
+    scenes.write({ lastScene, lastScene });
+    // Set when the state jumps (reset, pendulum switch, replay): the next
+    // tick publishes no interval from the old state to interpolate across
+    bool sceneJumped = false;
+    std::uint64_t lastReplaySample = ~std::uint64_t(0);
+    double appliedAcceleration = 0.0;
+
+    // One tick, called with physics.getMutex() held
+    auto physicsTick = [&](Clock::time_point time) {
+        // Replay drives the scene from the recording; the live simulation pauses
+        if (player.isOpen()) {
+            sceneJumped = true;
+            return;
+        }
+
+        // Controllers see the state at the start of the tick. The LQR gains
+        // are looked up again only when a tuned parameter changed.
+        PendulumEnv::writeObservation(cart, *currentPendulum, observation);
+        input.getLqr().setModel(*currentPendulum, dt, static_cast<double>(friction));
+        input.getMpc().setModel(*currentPendulum, dt, static_cast<double>(friction), cart.getRailLength());
+        input.update(observation, 2 + 2 * currentPendulum->getNumAngles());
+        appliedAcceleration = input.getCartAcceleration();
+
+        // Update physics parameters
+        currentPendulum->setGravity(static_cast<double>(gravity));
+        currentPendulum->setDamping(static_cast<double>(friction));
+
+        double effectiveAcceleration = 0.0;
+        if (coupledDynamics) {
+            // Cart and pendulum as one system: a single integrator call per
+            // tick, with the same rail-end blocking as Cart::update
+            CartPendulumSystem& coupled = useSinglePendulum ? coupledSingle : coupledDouble;
+            effectiveAcceleration = coupled.update(dt, appliedAcceleration, static_cast<double>(friction));
+        }
+        else {
+            // Update cart physics (friction passed as damping for cart velocity)
+            // Cart::update now returns the effective acceleration that actually
+            // occurred (zero when the cart is blocked at the rail end and the
+            // user continues pressing into the wall). Use that for pendulum.
+            effectiveAcceleration = cart.update(dt, appliedAcceleration,
+                static_cast<double>(friction), static_cast<double>(gravity));
+
+            // Update pendulum physics (gravity & damping are used inside pendulum equations)
+            currentPendulum->update(dt, effectiveAcceleration);
+        }
+
+        // Update simulation time
+        simulationTime += dt;
+
+        if (recorder.isOpen() && !recorder.record(0, simulationTime, cart, *currentPendulum,
+            appliedAcceleration, effectiveAcceleration)) {
+            recorder.close();
+        }
+        pushEnergy(0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity()
+            + currentPendulum->getTotalEnergy(cart.getVelocity()));
+
+        // Publish this tick with the previous one for interpolation
+        SceneSnapshot scene = SceneSnapshot::capture(cart, *currentPendulum, clockSeconds(time));
+        scenes.write({ sceneJumped ? scene : lastScene, scene });
+        lastScene = scene;
+        sceneJumped = false;
+    };
+    FixedStepThread physics(dt);
+    physics.start(physicsTick);
+
     while (!glfwWindowShouldClose(window))
     {
-        // Update input
-        input.update();
+        // Keyboard events, replay and instrumentation under the simulation lock
+        std::unique_lock<std::mutex> lock(physics.getMutex());
+        input.pollKeys();
 
         // Handle toggle
         if (input.shouldTogglePendulum()) {
@@ -141,11 +271,19 @@ int main()
                 static_cast<Pendulum*>(singlePendulum.get()) :
                 static_cast<Pendulum*>(doublePendulum.get());
 
+            // Records have a fixed link count: a recording ends with its pendulum
+            if (recorder.isOpen()) {
+                std::cout << "Recording stopped: " << recorder.getRecordCount() << " records in "
+                    << recorder.getPath() << "\n";
+                recorder.close();
+            }
+
             // Reset simulation state when switching modes so no motion persists
             cart.reset();
             singlePendulum->reset();
             doublePendulum->reset();
             simulationTime = 0.0;
+            sceneJumped = true;
 
             std::cout << "Switched to " << (useSinglePendulum ? "SINGLE" : "DOUBLE")
                 << " pendulum (state reset)\n";
@@ -157,56 +295,66 @@ int main()
             singlePendulum->reset();
             doublePendulum->reset();
             simulationTime = 0.0;
+            sceneJumped = true;
             std::cout << "Simulation reset\n";
         }
 
-        // Get user input acceleration
-        double appliedAcceleration = input.getCartAcceleration();
-
-        // Update physics parameters
-        currentPendulum->setGravity(static_cast<double>(gravity));
-        currentPendulum->setDamping(static_cast<double>(friction));
-
-        // Update cart physics (friction passed as damping for cart velocity)
-        // Cart::update now returns the effective acceleration that actually
-        // occurred (zero when the cart is blocked at the rail end and the
-        // user continues pressing into the wall). Use that for pendulum.
-        double effectiveAcceleration = cart.update(dt, appliedAcceleration,
-            static_cast<double>(friction), static_cast<double>(gravity));
-
-        // Update pendulum physics (gravity & damping are used inside pendulum equations)
-        currentPendulum->update(dt, effectiveAcceleration);
-
-        // Update simulation time
-        simulationTime += dt;
+        // Replay advances with the frame time
+        const bool replaying = player.isOpen();
+        if (replaying) {
+            player.update(static_cast<double>(io.DeltaTime));
+            if (player.getRecord()) appliedAcceleration = player.getRecord()[APPLIED_ACCELERATION_COLUMN];
+        }
 
         // -----------------------------
         // Energy instrumentation (store in millijoules)
         // -----------------------------
-        double cartKE = 0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity();
-        double pendKE = currentPendulum->getKineticEnergy(cart.getVelocity());
-        double pendPE = currentPendulum->getPotentialEnergy();
+        const double* replayRecord = replaying ? player.getRecord() : nullptr;
+        double cartKE = replayRecord ? replayRecord[CART_KINETIC_COLUMN]
+            : 0.5 * cart.getMass() * cart.getVelocity() * cart.getVelocity();
+        double pendKE = replayRecord ? replayRecord[PENDULUM_KINETIC_COLUMN]
+            : currentPendulum->getKineticEnergy(cart.getVelocity());
+        double pendPE = replayRecord ? replayRecord[PENDULUM_POTENTIAL_COLUMN]
+            : currentPendulum->getPotentialEnergy();
         double totalEnergy = cartKE + pendKE + pendPE;
 
-        // Push into circular buffer in millijoules (mJ)
-        energyHistory[energyIndex] = static_cast<float>(totalEnergy * 1000.0);
-        energyIndex = (energyIndex + 1) % ENERGY_HISTORY_SIZE;
-        if (energyCount < ENERGY_HISTORY_SIZE) ++energyCount;
+        // The physics tick records the live history; replay adds a sample
+        // whenever a different record is shown
+        if (replayRecord && player.getSample() != lastReplaySample) {
+            pushEnergy(totalEnergy);
+            lastReplaySample = player.getSample();
+        }
+
+        SceneSnapshot replayScene;
+        if (replaying) replayScene = SceneSnapshot::capture(player.getCart(), player.getPendulum(), 0.0);
+        lock.unlock();
 
         // ========================================================
         // Rendering
         // ========================================================
 
-        // Adjust view to fit rail length (allows runtime rail changes)
-        renderer.setViewWidthForRail(cart.getRailLength());
-
-        // Render 3D scene
-        renderer.render(cart, *currentPendulum, useSinglePendulum);
+        // Render 3D scene. The live view trails the physics thread by one
+        // tick: it shows the state between the two latest snapshots that
+        // corresponds to now - dt.
+        if (replaying) {
+            renderer.setViewWidthForRail(replayScene.railLength);
+            renderer.render(replayScene);
+        }
+        else {
+            scenes.read();
+            const SceneInterval& interval = scenes.getFront();
+            const double span = interval.current.time - interval.previous.time;
+            const double alpha = span > 0.0 ? (clockSeconds(Clock::now()) - interval.current.time) / span : 1.0;
+            // Adjust view to fit rail length (allows runtime rail changes)
+            renderer.setViewWidthForRail(interval.current.railLength);
+            renderer.render(interval.previous, interval.current, alpha);
+        }
 
-        // Render ImGui overlay
+        // Render ImGui overlay (widgets work on the live objects)
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
+        lock.lock();
 
         // Info window with tabs
         ImGui::Begin("Simulation Info");
@@ -214,14 +362,26 @@ int main()
             if (ImGui::BeginTabItem("Info")) {
                 ImGui::Text("FPS: %.1f", io.Framerate);
                 ImGui::Text("Time: %.2f s", simulationTime);
+                ImGui::Text("Physics: %llu ticks at %.0f Hz (%llu dropped), slowest %.3f ms",
+                    static_cast<unsigned long long>(physics.getTickCount()), 1.0 / dt,
+                    static_cast<unsigned long long>(physics.getDroppedTicks()), physics.getMaxTickSeconds() * 1e3);
                 ImGui::Separator();
                 ImGui::Text("Mode: %s Pendulum", useSinglePendulum ? "SINGLE" : "DOUBLE");
+                const char* control = "KEYBOARD";
+                if (input.isPolicyActive()) control = "POLICY";
+                else if (input.getControlMode() == InputController::ControlMode::Policy) control = "POLICY (input size mismatch)";
+                else if (input.isLqrActive()) control = "LQR";
+                else if (input.getControlMode() == InputController::ControlMode::Lqr) control = "LQR (waiting near upright)";
+                else if (input.isMpcActive()) control = "MPC";
+                else if (input.getControlMode() == InputController::ControlMode::Mpc) control = "MPC (waiting for a plan)";
+                ImGui::Text("Control: %s", control);
                 ImGui::Separator();
                 ImGui::Text("Cart:");
                 ImGui::Text("  Position: %.6f m", cart.getPosition());
                 ImGui::Text("  Velocity: %.6f m/s", cart.getVelocity());
                 ImGui::Text("  Acceleration: %.4f m/s^2", appliedAcceleration);
                 ImGui::Text("  Wrap: %s", cart.isWrapEnabled() ? "ON" : "OFF");
+                ImGui::Text("  Coupled: %s", coupledDynamics ? "ON" : "OFF");
                 ImGui::Separator();
 
                 if (useSinglePendulum) {
@@ -256,10 +416,25 @@ int main()
                     for (int i = 0; i < energyCount; ++i) {
                         plotData.push_back(energyHistory[(start + i) % ENERGY_HISTORY_SIZE]);
                     }
-                    ImGui::PlotLines("Total Energy (mJ)", plotData.data(), static_cast<int>(plotData.size()), 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 80));
+                    ImGui::PlotLines("Total Energy (mJ, per tick)", plotData.data(), static_cast<int>(plotData.size()), 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 80));
                 }
 
-                // (CSV export removed; plotting only)
+                // Binary trajectory recording (TrajectoryRecorder format)
+                ImGui::InputText("Record file", recordPath, sizeof(recordPath));
+                if (!recorder.isOpen()) {
+                    if (ImGui::Button("Start recording")) {
+                        recorder.open(recordPath, currentPendulum->getNumAngles(), dt);
+                    }
+                }
+                else {
+                    if (ImGui::Button("Stop recording")) {
+                        std::cout << "Recording stopped: " << recorder.getRecordCount() << " records in "
+                            << recorder.getPath() << "\n";
+                        recorder.close();
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("%llu records", static_cast<unsigned long long>(recorder.getRecordCount()));
+                }
 
                 ImGui::Separator();
                 ImGui::Text("Physics Parameters:");
@@ -304,7 +479,9 @@ int main()
                 if (ImGui::Checkbox("Wrap rail (teleport across edges)", &wrap)) {
                     cart.setWrapEnabled(wrap);
                 }
-                // Max acceleration tuning (affects input->getCartAcceleration())
+                // Coupled dynamics toggle (pendulum pushes back on the cart)
+                ImGui::Checkbox("Coupled cart-pendulum dynamics", &coupledDynamics);
+                // Max acceleration tuning (keys, policy, LQR and the MPC's planning limit)
                 float maxAcc = static_cast<float>(input.getMaxAcceleration());
                 if (ImGui::InputFloat("Max acceleration (m/s^2)", &maxAcc, 0.1f, 1.0f, "%.2f")) {
                     input.setMaxAcceleration(static_cast<double>(maxAcc));
@@ -336,6 +513,7 @@ int main()
                     singlePendulum->reset();
                     doublePendulum->reset();
                     simulationTime = 0.0;
+                    sceneJumped = true;
                 }
 
                 ImGui::Separator();
@@ -382,14 +560,203 @@ int main()
                     }
                 }
 
+                ImGui::Separator();
+                // Integrator selection (applies to the cart and both pendulums)
+                int integratorIndex = static_cast<int>(currentPendulum->getIntegrator());
+                const char* integratorNames[INTEGRATOR_TYPE_COUNT];
+                for (int i = 0; i < INTEGRATOR_TYPE_COUNT; ++i) {
+                    integratorNames[i] = getIntegratorName(static_cast<IntegratorType>(i));
+                }
+                if (ImGui::Combo("Integrator", &integratorIndex, integratorNames, INTEGRATOR_TYPE_COUNT)) {
+                    IntegratorType type = static_cast<IntegratorType>(integratorIndex);
+                    cart.setIntegrator(type);
+                    singlePendulum->setIntegrator(type);
+                    doublePendulum->setIntegrator(type);
+                }
+
+                ImGui::Separator();
+                // LQR balance controller (gains follow the parameters above)
+                bool lqrControl = input.getControlMode() == InputController::ControlMode::Lqr;
+                if (ImGui::Checkbox("LQR balance control (L)", &lqrControl)) {
+                    input.setControlMode(lqrControl ? InputController::ControlMode::Lqr
+                        : InputController::ControlMode::Keyboard);
+                }
+                float captureDeg = static_cast<float>(input.getCaptureAngle() * 180.0 / 3.14159265358979323846);
+                if (ImGui::SliderFloat("Capture angle (deg)", &captureDeg, 1.0f, 90.0f, "%.1f")) {
+                    input.setCaptureAngle(static_cast<double>(captureDeg) * 3.14159265358979323846 / 180.0);
+                }
+                const LqrController& lqr = input.getLqr();
+                if (lqr.hasModel()) {
+                    const LqrController::Gains& gains = *lqr.getGains();
+                    std::string text;
+                    for (int i = 0; i < gains.stateSize; ++i) {
+                        char value[32];
+                        std::snprintf(value, sizeof(value), "%s%.2f", i ? ", " : "", gains.k[i]);
+                        text += value;
+                    }
+                    ImGui::Text("Gains: [%s]", text.c_str());
+                }
+                else {
+                    ImGui::Text("Gains: no stabilizing solution for these parameters");
+                }
+                ImGui::Text("Cached solutions: %zu (%lld solved)", lqr.getCacheSize(), lqr.getSolveCount());
+
                 ImGui::Separator();
                 if (ImGui::Button("Reset positions")) {
                     cart.reset();
                     singlePendulum->reset();
                     doublePendulum->reset();
                     simulationTime = 0.0;
+                    sceneJumped = true;
+                }
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Policy")) {
+                ImGui::InputText("Weights file", policyPath, sizeof(policyPath));
+                if (ImGui::Button("Load")) {
+                    if (input.loadPolicy(policyPath)) {
+                        input.setControlMode(InputController::ControlMode::Policy);
+                    }
+                }
+                if (input.hasPolicy()) {
+                    const std::vector<int>& sizes = input.getPolicy().getLayerSizes();
+                    std::string shape;
+                    for (std::size_t i = 0; i < sizes.size(); ++i) {
+                        shape += (i ? " x " : "") + std::to_string(sizes[i]);
+                    }
+                    ImGui::Text("Network: %s (%zu parameters)", shape.c_str(), input.getPolicy().getParameterCount());
+                    ImGui::Text("Observation size: %d (policy expects %d)",
+                        2 + 2 * currentPendulum->getNumAngles(), input.getPolicy().getInputSize());
+
+                    bool policyControl = input.getControlMode() == InputController::ControlMode::Policy;
+                    if (ImGui::Checkbox("Policy drives the cart (P)", &policyControl)) {
+                        input.setControlMode(policyControl ? InputController::ControlMode::Policy
+                            : InputController::ControlMode::Keyboard);
+                    }
+                    int interval = input.getPolicyInterval();
+                    if (ImGui::SliderInt("Control interval (ticks)", &interval, 1, 16)) {
+                        input.setPolicyInterval(interval);
+                    }
+                }
+                else {
+                    ImGui::Text("No policy loaded");
+                }
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("MPC")) {
+                // iLQR swing-up and balance, solved on its own thread
+                bool mpcControl = input.getControlMode() == InputController::ControlMode::Mpc;
+                if (ImGui::Checkbox("MPC control (M)", &mpcControl)) {
+                    input.setControlMode(mpcControl ? InputController::ControlMode::Mpc
+                        : InputController::ControlMode::Keyboard);
+                }
+
+                // Changing the configuration restarts the solver, so apply on release
+                IlqrConfig mpcConfig = input.getMpc().getConfig();
+                float budgetMs = static_cast<float>(mpcConfig.budgetSeconds * 1e3);
+                ImGui::SliderFloat("Solve budget (ms)", &budgetMs, 0.5f, 20.0f, "%.1f");
+                if (ImGui::IsItemDeactivatedAfterEdit()) {
+                    mpcConfig.budgetSeconds = static_cast<double>(budgetMs) * 1e-3;
+                    input.getMpc().setConfig(mpcConfig);
+                }
+                int horizon = mpcConfig.horizon;
+                ImGui::SliderInt("Horizon (control steps)", &horizon, 10, 150);
+                if (ImGui::IsItemDeactivatedAfterEdit()) {
+                    mpcConfig.horizon = horizon;
+                    input.getMpc().setConfig(mpcConfig);
                 }
+                ImGui::Text("Control step: %d ticks (%.1f s lookahead)", mpcConfig.ticksPerStep,
+                    mpcConfig.horizon * mpcConfig.ticksPerStep * dt);
 
+                ImGui::Separator();
+                const MpcPlan& plan = input.getMpc().getPlan();
+                if (input.getMpc().isRunning() && plan.steps > 0) {
+                    ImGui::Text("Solves: %llu", static_cast<unsigned long long>(plan.solveCount));
+                    ImGui::Text("Last solve: %.2f ms, %d iterations%s", plan.solveSeconds * 1e3, plan.iterations,
+                        plan.budgetHit ? " (budget hit)" : "");
+                    ImGui::Text("Slowest solve: %.2f ms", plan.maxSolveSeconds * 1e3);
+                    ImGui::Text("Plan age: %llu ticks",
+                        static_cast<unsigned long long>(input.getMpcTick() - 1 - plan.tick));
+                }
+                else {
+                    ImGui::Text("MPC thread %s", input.getMpc().isRunning() ? "running, no plan yet" : "stopped");
+                }
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Replay")) {
+                ImGui::InputText("Trajectory file", replayPath, sizeof(replayPath));
+                if (ImGui::Button("Open")) {
+                    player.open(replayPath);
+                }
+                if (player.isOpen()) {
+                    ImGui::SameLine();
+                    if (ImGui::Button("Close (back to simulation)")) {
+                        player.close();
+                    }
+                }
+
+                if (player.isOpen()) {
+                    const TrajectoryReader& reader = player.getReader();
+                    ImGui::Text("%llu records, %d link(s), %d source(s)",
+                        static_cast<unsigned long long>(reader.getRecordCount()),
+                        reader.getNumAngles(), reader.getSourceCount());
+                    ImGui::Separator();
+
+                    if (reader.getSourceCount() > 1) {
+                        int source = player.getSource();
+                        if (ImGui::InputInt("Source", &source)) {
+                            player.setSource(source);
+                        }
+                    }
+                    if (ImGui::Button(player.isPlaying() ? "Pause" : "Play")) {
+                        player.setPlaying(!player.isPlaying());
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("<")) player.stepSamples(-1);
+                    ImGui::SameLine();
+                    if (ImGui::Button(">")) player.stepSamples(1);
+                    ImGui::SameLine();
+                    if (ImGui::Button("<<")) player.stepSamples(-144);
+                    ImGui::SameLine();
+                    if (ImGui::Button(">>")) player.stepSamples(144);
+
+                    float speed = static_cast<float>(player.getSpeed());
+                    if (ImGui::SliderFloat("Speed", &speed, -8.0f, 8.0f, "%.2fx")) {
+                        player.setSpeed(static_cast<double>(speed));
+                    }
+                    // Scrubbing: dragging seeks and holds the position
+                    double time = player.getTime();
+                    const double zero = 0.0;
+                    const double duration = player.getDuration();
+                    if (ImGui::SliderScalar("Time (s)", ImGuiDataType_Double, &time, &zero, &duration, "%.3f")) {
+                        player.setPlaying(false);
+                        player.seek(time);
+                    }
+                    ImGui::Text("Sample %llu / %llu",
+                        static_cast<unsigned long long>(player.getSample() + 1),
+                        static_cast<unsigned long long>(player.getSampleCount()));
+
+                    if (const double* record = player.getRecord()) {
+                        ImGui::Separator();
+                        ImGui::Text("Recorded time: %.4f s", record[TIME_COLUMN]);
+                        ImGui::Text("Cart: x %.4f m, v %.4f m/s", record[CART_POSITION_COLUMN], record[CART_VELOCITY_COLUMN]);
+                        ImGui::Text("Acceleration: applied %.3f, effective %.3f m/s^2",
+                            record[APPLIED_ACCELERATION_COLUMN], record[EFFECTIVE_ACCELERATION_COLUMN]);
+                        for (int link = 0; link < reader.getNumAngles(); ++link) {
+                            ImGui::Text("Link %d: angle %.4f deg, ang vel %.4f deg/s", link + 1,
+                                record[FIRST_LINK_COLUMN + 2 * link] * 180.0 / 3.14159265358979323846,
+                                record[FIRST_LINK_COLUMN + 2 * link + 1] * 180.0 / 3.14159265358979323846);
+                        }
+                    }
+                }
+                else {
+                    ImGui::Text("No trajectory open (record one in the Simulation tab or with");
+                    ImGui::Text("PendulumHeadless --record)");
+                }
                 ImGui::EndTabItem();
             }
 
@@ -397,6 +764,7 @@ int main()
         }
 
         ImGui::End();
+        lock.unlock();
 
         // Render ImGui
         ImGui::Render();
@@ -410,6 +778,7 @@ int main()
     // ============================================================
     // Cleanup
     // ============================================================
+    physics.stop();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
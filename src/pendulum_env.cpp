@@ -0,0 +1,208 @@
+#include "pendulum_env.h"
+#include "VecEnv.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <vector>
+
+// Opaque handle: the environments plus double staging for the _f32 calls
+struct pendulum_env
+{
+    VecEnv vec;
+    std::vector<double> observations;
+    std::vector<double> finalObservations;
+    std::vector<double> actions;
+    std::vector<double> rewards;
+
+    pendulum_env(std::size_t numEnvs, const PendulumEnvConfig& config, int numThreads)
+        : vec(numEnvs, config, numThreads)
+        , observations(numEnvs * vec.getObservationSize())
+        , finalObservations(numEnvs * vec.getObservationSize())
+        , actions(numEnvs)
+        , rewards(numEnvs)
+    {
+    }
+};
+
+namespace
+{
+    PendulumEnvConfig toConfig(const pendulum_env_config& c)
+    {
+        PendulumEnvConfig config;
+        config.numLinks = c.num_links;
+        config.substeps = c.substeps;
+        config.dt = c.dt;
+        config.maxEpisodeSteps = c.max_episode_steps;
+        config.coupled = c.coupled != 0;
+        config.integrator = static_cast<IntegratorType>(c.integrator);
+        config.terminateAtRailEnd = c.terminate_at_rail_end != 0;
+        config.maxAcceleration = c.max_acceleration;
+        config.cartMass = c.cart_mass;
+        config.railLength = c.rail_length;
+        config.linkMass = c.link_mass;
+        config.linkLength = c.link_length;
+        config.gravity = c.gravity;
+        config.damping = c.damping;
+        config.friction = c.friction;
+        config.initialAngle = c.initial_angle;
+        config.initialAngleNoise = c.initial_angle_noise;
+        config.initialVelocityNoise = c.initial_velocity_noise;
+        config.actionCost = c.action_cost;
+        config.positionCost = c.position_cost;
+        return config;
+    }
+
+    // Sizes a caller's pendulum_env_config may have: the end of the version 1
+    // fields, then the end of each field appended after them, in order
+    constexpr std::size_t CONFIG_SIZES[] = {
+        offsetof(pendulum_env_config, position_cost) + sizeof(double),
+    };
+    constexpr std::size_t MIN_CONFIG_SIZE = CONFIG_SIZES[0];
+    static_assert(CONFIG_SIZES[std::size(CONFIG_SIZES) - 1] == sizeof(pendulum_env_config),
+        "list the end of every appended pendulum_env_config field in CONFIG_SIZES");
+
+    bool isConfigSize(std::size_t size)
+    {
+        return size >= MIN_CONFIG_SIZE
+            && std::find(std::begin(CONFIG_SIZES), std::end(CONFIG_SIZES), size) != std::end(CONFIG_SIZES);
+    }
+
+    bool isValid(const pendulum_env_config& c)
+    {
+        return c.num_links >= 1 && c.substeps >= 1 && c.dt > 0.0 && c.max_episode_steps >= 1
+            && c.integrator >= 0 && c.integrator < INTEGRATOR_TYPE_COUNT
+            && c.cart_mass > 0.0 && c.rail_length > 0.0 && c.link_mass > 0.0 && c.link_length > 0.0;
+    }
+
+    template <typename From, typename To>
+    void convert(const From* from, std::size_t count, To* to)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            to[i] = static_cast<To>(from[i]);
+        }
+    }
+}
+
+extern "C" {
+
+int pendulum_env_abi_version(void)
+{
+    return PENDULUM_ENV_ABI_VERSION;
+}
+
+void pendulum_env_default_config(pendulum_env_config* config)
+{
+    if (!config) return;
+    const PendulumEnvConfig defaults;
+    config->num_links = defaults.numLinks;
+    config->substeps = defaults.substeps;
+    config->dt = defaults.dt;
+    config->max_episode_steps = defaults.maxEpisodeSteps;
+    config->coupled = defaults.coupled ? 1 : 0;
+    config->integrator = static_cast<int32_t>(defaults.integrator);
+    config->terminate_at_rail_end = defaults.terminateAtRailEnd ? 1 : 0;
+    config->max_acceleration = defaults.maxAcceleration;
+    config->cart_mass = defaults.cartMass;
+    config->rail_length = defaults.railLength;
+    config->link_mass = defaults.linkMass;
+    config->link_length = defaults.linkLength;
+    config->gravity = defaults.gravity;
+    config->damping = defaults.damping;
+    config->friction = defaults.friction;
+    config->initial_angle = defaults.initialAngle;
+    config->initial_angle_noise = defaults.initialAngleNoise;
+    config->initial_velocity_noise = defaults.initialVelocityNoise;
+    config->action_cost = defaults.actionCost;
+    config->position_cost = defaults.positionCost;
+}
+
+pendulum_env* pendulum_env_create(size_t num_envs, const pendulum_env_config* config, size_t config_size,
+    int num_threads)
+{
+    // Fields the caller's (possibly older, shorter) struct does not have keep their defaults
+    pendulum_env_config merged;
+    pendulum_env_default_config(&merged);
+    if (config) {
+        if (!isConfigSize(config_size)) return nullptr;
+        std::memcpy(&merged, config, config_size);
+    }
+    if (num_envs == 0 || !isValid(merged)) return nullptr;
+
+    // No C++ exception may cross the C boundary
+    try {
+        return new pendulum_env(num_envs, toConfig(merged), num_threads);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void pendulum_env_destroy(pendulum_env* env)
+{
+    delete env;
+}
+
+size_t pendulum_env_num_envs(const pendulum_env* env)
+{
+    return env ? env->vec.getNumEnvs() : 0;
+}
+
+int pendulum_env_observation_size(const pendulum_env* env)
+{
+    return env ? env->vec.getObservationSize() : 0;
+}
+
+int pendulum_env_reset(pendulum_env* env, uint64_t seed, double* observations)
+{
+    if (!env || !observations) return PENDULUM_ENV_INVALID_ARGUMENT;
+    env->vec.reset(seed, observations);
+    return PENDULUM_ENV_OK;
+}
+
+int pendulum_env_reset_f32(pendulum_env* env, uint64_t seed, float* observations)
+{
+    if (!env || !observations) return PENDULUM_ENV_INVALID_ARGUMENT;
+    env->vec.reset(seed, env->observations.data());
+    convert(env->observations.data(), env->observations.size(), observations);
+    return PENDULUM_ENV_OK;
+}
+
+int pendulum_env_step(pendulum_env* env, const double* actions, double* observations,
+    double* rewards, uint8_t* terminated, uint8_t* truncated, double* final_observations)
+{
+    if (!env || !actions || !observations || !rewards || !terminated || !truncated) {
+        return PENDULUM_ENV_INVALID_ARGUMENT;
+    }
+    env->vec.step(actions, observations, rewards, terminated, truncated, final_observations);
+    return PENDULUM_ENV_OK;
+}
+
+int pendulum_env_step_f32(pendulum_env* env, const float* actions, float* observations,
+    float* rewards, uint8_t* terminated, uint8_t* truncated, float* final_observations)
+{
+    if (!env || !actions || !observations || !rewards || !terminated || !truncated) {
+        return PENDULUM_ENV_INVALID_ARGUMENT;
+    }
+    const std::size_t numEnvs = env->vec.getNumEnvs();
+    const std::size_t obsSize = static_cast<std::size_t>(env->vec.getObservationSize());
+
+    // The double state persists between calls, so float rounding never
+    // feeds back into the dynamics
+    convert(actions, numEnvs, env->actions.data());
+    env->vec.step(env->actions.data(), env->observations.data(), env->rewards.data(), terminated, truncated,
+        final_observations ? env->finalObservations.data() : nullptr);
+    convert(env->observations.data(), numEnvs * obsSize, observations);
+    convert(env->rewards.data(), numEnvs, rewards);
+    if (final_observations) {
+        for (std::size_t i = 0; i < numEnvs; ++i) {
+            if (terminated[i] || truncated[i]) {
+                convert(env->finalObservations.data() + i * obsSize, obsSize, final_observations + i * obsSize);
+            }
+        }
+    }
+    return PENDULUM_ENV_OK;
+}
+
+}
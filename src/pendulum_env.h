@@ -0,0 +1,124 @@
+#ifndef PENDULUM_ENV_H
+#define PENDULUM_ENV_H
+
+/*
+ * pendulum_env - C ABI of the batched cart-pendulum simulator
+ * (libpendulum_env.so)
+ *
+ * A handle owns numEnvs environments (VecEnv: Cart + SinglePendulum,
+ * DoublePendulum or ChainPendulum, integrated with the C++ ODE solvers) and
+ * steps them in parallel with auto-reset. All batch data lives in
+ * caller-owned, C-contiguous arrays, so ctypes / cffi / Julia ccall can
+ * pass numpy or Julia array memory directly:
+ *
+ *   observations        num_envs x observation_size   (row-major)
+ *   final_observations  num_envs x observation_size   (optional, may be NULL)
+ *   actions, rewards    num_envs
+ *   terminated, truncated  num_envs bytes (0 / 1)
+ *
+ * The double entry points write straight into the caller's arrays; the
+ * _f32 variants convert through buffers preallocated at creation. Neither
+ * allocates per call. Functions return PENDULUM_ENV_OK or a negative
+ * error code; a handle must not be used from two threads at once.
+ *
+ * ABI rules: handles are opaque, every struct has fixed-width fields, and
+ * new config fields are only ever appended. Callers pass sizeof() of the
+ * config they were compiled against, so older binaries keep working.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(PENDULUM_ENV_BUILD)
+#    define PENDULUM_ENV_API __declspec(dllexport)
+#  else
+#    define PENDULUM_ENV_API __declspec(dllimport)
+#  endif
+#else
+#  define PENDULUM_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PENDULUM_ENV_ABI_VERSION 1
+
+enum
+{
+    PENDULUM_ENV_OK = 0,
+    PENDULUM_ENV_INVALID_ARGUMENT = -1
+};
+
+/* Values of pendulum_env_config.integrator (IntegratorType) */
+enum
+{
+    PENDULUM_ENV_SEMI_IMPLICIT_EULER = 0,
+    PENDULUM_ENV_VELOCITY_VERLET = 1,
+    PENDULUM_ENV_YOSHIDA4 = 2,
+    PENDULUM_ENV_RK4 = 3,
+    PENDULUM_ENV_DORMAND_PRINCE87 = 4
+};
+
+/* Mirrors PendulumEnvConfig; fill with pendulum_env_default_config() */
+typedef struct pendulum_env_config
+{
+    int32_t num_links;
+    int32_t substeps;
+    double dt;
+    int32_t max_episode_steps;
+    int32_t coupled;
+    int32_t integrator;
+    int32_t terminate_at_rail_end;
+
+    double max_acceleration;
+    double cart_mass;
+    double rail_length;
+    double link_mass;
+    double link_length;
+    double gravity;
+    double damping;
+    double friction;
+
+    double initial_angle;
+    double initial_angle_noise;
+    double initial_velocity_noise;
+
+    double action_cost;
+    double position_cost;
+} pendulum_env_config;
+
+typedef struct pendulum_env pendulum_env;
+
+PENDULUM_ENV_API int pendulum_env_abi_version(void);
+
+PENDULUM_ENV_API void pendulum_env_default_config(pendulum_env_config* config);
+
+/* num_threads counts the calling thread; 0 = one per hardware thread.
+   config_size = sizeof(pendulum_env_config); config may be NULL for the
+   defaults. Returns NULL on invalid arguments, including a config_size
+   shorter than the version 1 fields or not ending on a field. */
+PENDULUM_ENV_API pendulum_env* pendulum_env_create(size_t num_envs, const pendulum_env_config* config,
+    size_t config_size, int num_threads);
+PENDULUM_ENV_API void pendulum_env_destroy(pendulum_env* env);
+
+PENDULUM_ENV_API size_t pendulum_env_num_envs(const pendulum_env* env);
+PENDULUM_ENV_API int pendulum_env_observation_size(const pendulum_env* env);
+
+/* Environment i draws its episodes from a stream derived from (seed, i) */
+PENDULUM_ENV_API int pendulum_env_reset(pendulum_env* env, uint64_t seed, double* observations);
+PENDULUM_ENV_API int pendulum_env_reset_f32(pendulum_env* env, uint64_t seed, float* observations);
+
+/* Finished environments are reset in place; the last observation of the
+   finished episode goes to final_observations when it is not NULL */
+PENDULUM_ENV_API int pendulum_env_step(pendulum_env* env, const double* actions, double* observations,
+    double* rewards, uint8_t* terminated, uint8_t* truncated, double* final_observations);
+PENDULUM_ENV_API int pendulum_env_step_f32(pendulum_env* env, const float* actions, float* observations,
+    float* rewards, uint8_t* terminated, uint8_t* truncated, float* final_observations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PENDULUM_ENV_H */